@@ -9,7 +9,7 @@ namespace python {
 Locations
 SegmentGuarantor::fill(
 		const util::point<unsigned int, 3>& request,
-		const SegmentGuarantorParameters& /*parameters*/,
+		const SegmentGuarantorParameters& parameters,
 		const ProjectConfiguration& configuration) {
 
 	LOG_USER(pylog) << "[SegmentGuarantor] fill called for block at " << request << std::endl;
@@ -33,6 +33,10 @@ SegmentGuarantor::fill(
 			sliceStore,
 			rawStackStore);
 
+	if (parameters.isNumFeatureThreadsSet())
+		segmentGuarantor.setNumFeatureThreads(parameters.getNumFeatureThreads());
+	segmentGuarantor.setSkipZeroWeightFeatures(parameters.getSkipZeroWeightFeatures());
+
 	// let it do what it was build for
 	Blocks missingBlocks = segmentGuarantor.guaranteeSegments(blocks);
 
@@ -3,7 +3,54 @@
 
 namespace python {
 
-class SegmentGuarantorParameters {};
+class SegmentGuarantorParameters {
+
+public:
+
+	SegmentGuarantorParameters() :
+		_numFeatureThreads(0),
+		_numFeatureThreadsSet(false),
+		_skipZeroWeightFeatures(false) {}
+
+	/**
+	 * Get the number of threads used to extract segment features.
+	 */
+	unsigned int getNumFeatureThreads() const { return _numFeatureThreads; }
+
+	/**
+	 * Set the number of threads used to extract segment features. 0 uses all 
+	 * hardware threads.
+	 */
+	void setNumFeatureThreads(unsigned int numThreads) {
+
+		_numFeatureThreads    = numThreads;
+		_numFeatureThreadsSet = true;
+	}
+
+	/**
+	 * Whether the number of feature threads was set. If not, the program 
+	 * option sopnet.features.featureExtractionThreads is used.
+	 */
+	bool isNumFeatureThreadsSet() const { return _numFeatureThreadsSet; }
+
+	/**
+	 * Whether features with a zero weight are skipped during extraction.
+	 */
+	bool getSkipZeroWeightFeatures() const { return _skipZeroWeightFeatures; }
+
+	/**
+	 * Skip the extraction of features that have a zero weight. Only use this 
+	 * if the weights are not going to change.
+	 */
+	void setSkipZeroWeightFeatures(bool skip) { _skipZeroWeightFeatures = skip; }
+
+private:
+
+	unsigned int _numFeatureThreads;
+	bool         _numFeatureThreadsSet;
+
+	bool _skipZeroWeightFeatures;
+};
 
 } // namespace python
 
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <sstream>
+
+#include <boost/make_shared.hpp>
+#include <boost/python.hpp>
 #include <pipeline/Value.h>
 #include <pipeline/Process.h>
 #include <blockwise/guarantors/SolutionGuarantor.h>
+#include <blockwise/guarantors/SolutionScheduler.h>
 #include <blockwise/blocks/Cores.h>
 #include <util/point.hpp>
 #include "SolutionGuarantor.h"
@@ -16,19 +22,8 @@ SolutionGuarantor::fill(
 
 	LOG_USER(pylog) << "[SolutionGuarantor] fill called for core at " << request << std::endl;
 
-	//boost::shared_ptr<BlockManager> blockManager  = createBlockManager(configuration);
-	boost::shared_ptr<SliceStore>   sliceStore    = createSliceStore(configuration, Membrane);
-	boost::shared_ptr<SegmentStore> segmentStore  = createSegmentStore(configuration, Membrane);
-
 	// create the SolutionGuarantor process node
-	::SolutionGuarantor solutionGuarantor(
-			configuration,
-			segmentStore,
-			sliceStore,
-			parameters.getCorePadding(),
-			parameters.forceExplanation(),
-			parameters.readCosts(),
-			parameters.storeCosts());
+	boost::shared_ptr< ::SolutionGuarantor> solutionGuarantor = createSolutionGuarantor(parameters, configuration);
 
 	LOG_USER(pylog) << "[SolutionGuarantor] processing..." << std::endl;
 
@@ -36,7 +31,7 @@ SolutionGuarantor::fill(
 	Core core(request.x(), request.y(), request.z());
 
 	// let it do what it was build for
-	Blocks missingBlocks = solutionGuarantor.guaranteeSolution(core);
+	Blocks missingBlocks = solutionGuarantor->guaranteeSolution(core);
 
 	LOG_USER(pylog) << "[SolutionGuarantor] collecting missing segment blocks" << std::endl;
 
@@ -48,5 +43,202 @@ SolutionGuarantor::fill(
 	return missing;
 }
 
+Locations
+SolutionGuarantor::fillCores(
+		const Locations& requests,
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	LOG_USER(pylog) << "[SolutionGuarantor] fillCores called for " << requests.size() << " cores" << std::endl;
+
+	// with adaptive padding, cores are padded by up to the maximal padding
+	SolutionScheduler scheduler(
+			configuration,
+			std::max(parameters.getCorePadding(), parameters.getMaxCorePadding()),
+			[this, &parameters, &configuration]() { return createSolutionGuarantor(parameters, configuration); });
+
+	scheduler.setNumThreads(parameters.getNumThreads());
+
+	boost::shared_ptr<CoreCostEstimator> costEstimator;
+	if (parameters.estimateCosts()) {
+
+		costEstimator = getCostEstimator(parameters, configuration);
+		scheduler.setCostEstimator(costEstimator->getCostEstimator());
+	}
+
+	Cores cores;
+	for (const util::point<unsigned int, 3>& request : requests)
+		cores.add(Core(request.x(), request.y(), request.z()));
+
+	LOG_USER(pylog) << "[SolutionGuarantor] processing..." << std::endl;
+
+	Blocks missingBlocks = scheduler.guaranteeSolutions(cores);
+
+	// calibrate the estimator with the cores that were solved
+	if (costEstimator)
+		for (const auto& pair : scheduler.getSolveStatistics())
+			costEstimator->addSample(pair.first, pair.second);
+
+	LOG_USER(pylog) << "[SolutionGuarantor] collecting missing segment blocks" << std::endl;
+
+	// collect missing block locations
+	Locations missing;
+	for (const Block& block : missingBlocks)
+		missing.push_back(util::point<unsigned int, 3>(block.x(), block.y(), block.z()));
+
+	return missing;
+}
+
+Locations
+SolutionGuarantor::reoptimize(
+		const Locations& requests,
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	LOG_USER(pylog) << "[SolutionGuarantor] reoptimize called for " << requests.size() << " cores" << std::endl;
+
+	if (!_reoptimizer) {
+
+		_reoptimizer = createSolutionGuarantor(parameters, configuration);
+		_reoptimizer->setKeepProblems(true);
+	}
+
+	Blocks missingBlocks;
+	for (const util::point<unsigned int, 3>& request : requests)
+		missingBlocks.addAll(_reoptimizer->reoptimizeSolution(Core(request.x(), request.y(), request.z())));
+
+	LOG_USER(pylog) << "[SolutionGuarantor] collecting missing segment blocks" << std::endl;
+
+	// collect missing block locations
+	Locations missing;
+	for (const Block& block : missingBlocks)
+		missing.push_back(util::point<unsigned int, 3>(block.x(), block.y(), block.z()));
+
+	return missing;
+}
+
+Locations
+SolutionGuarantor::updateConstraints(
+		const Locations& blockLocations,
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	LOG_USER(pylog) << "[SolutionGuarantor] updateConstraints called for " << blockLocations.size() << " blocks" << std::endl;
+
+	if (!_reoptimizer) {
+
+		_reoptimizer = createSolutionGuarantor(parameters, configuration);
+		_reoptimizer->setKeepProblems(true);
+	}
+
+	Blocks changedBlocks;
+	for (const util::point<unsigned int, 3>& location : blockLocations)
+		changedBlocks.add(Block(location.x(), location.y(), location.z()));
+
+	Cores updated = _reoptimizer->updateExplicitConstraints(changedBlocks);
+
+	// collect updated core locations
+	Locations cores;
+	for (const Core& core : updated)
+		cores.push_back(util::point<unsigned int, 3>(core.x(), core.y(), core.z()));
+
+	return cores;
+}
+
+boost::python::list
+SolutionGuarantor::estimateCores(
+		const Locations& requests,
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	LOG_USER(pylog) << "[SolutionGuarantor] estimateCores called for " << requests.size() << " cores" << std::endl;
+
+	boost::shared_ptr<CoreCostEstimator> costEstimator = getCostEstimator(parameters, configuration);
+
+	boost::python::list estimates;
+	for (const util::point<unsigned int, 3>& request : requests)
+		estimates.append(costEstimator->estimate(Core(request.x(), request.y(), request.z())));
+
+	return estimates;
+}
+
+boost::shared_ptr<CoreCostEstimator>
+SolutionGuarantor::getCostEstimator(
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	// the estimator is kept between calls to stay calibrated
+	if (!_costEstimator)
+		_costEstimator = boost::make_shared<CoreCostEstimator>(
+				configuration,
+				createSegmentStore(configuration, Membrane),
+				createSliceStore(configuration, Membrane),
+				std::max(parameters.getCorePadding(), parameters.getMaxCorePadding()));
+
+	// other workers might have extracted blocks since the last call
+	_costEstimator->clearCache();
+
+	return _costEstimator;
+}
+
+boost::shared_ptr<LinearSolverPool>
+SolutionGuarantor::getSolverPool(
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	// pools without a cache can be shared between all configurations, the 
+	// others only between calls with the same backend
+	std::ostringstream key;
+	if (parameters.solutionCache())
+		key
+				<< configuration.getBackendType() << ":"
+				<< configuration.getComponentDirectory() << ":"
+				<< configuration.getPostgreSqlHost() << ":"
+				<< configuration.getPostgreSqlPort() << ":"
+				<< configuration.getPostgreSqlDatabase() << ":"
+				<< configuration.getCatmaidStack(Membrane).segmentationId;
+
+	boost::shared_ptr<LinearSolverPool>& solverPool = _solverPools[key.str()];
+
+	if (!solverPool) {
+
+		solverPool = boost::make_shared<LinearSolverPool>();
+
+		if (parameters.solutionCache())
+			solverPool->setSolutionCache(createSolutionCache(configuration, Membrane));
+	}
+
+	return solverPool;
+}
+
+boost::shared_ptr< ::SolutionGuarantor>
+SolutionGuarantor::createSolutionGuarantor(
+		const SolutionGuarantorParameters& parameters,
+		const ProjectConfiguration& configuration) {
+
+	boost::shared_ptr<SliceStore>   sliceStore    = createSliceStore(configuration, Membrane);
+	boost::shared_ptr<SegmentStore> segmentStore  = createSegmentStore(configuration, Membrane);
+
+	boost::shared_ptr< ::SolutionGuarantor> solutionGuarantor = boost::make_shared< ::SolutionGuarantor>(
+			configuration,
+			segmentStore,
+			sliceStore,
+			parameters.getCorePadding(),
+			parameters.forceExplanation(),
+			parameters.readCosts(),
+			parameters.storeCosts());
+
+	boost::shared_ptr<LinearSolverPool> solverPool = getSolverPool(parameters, configuration);
+
+	solutionGuarantor->setNumComponentThreads(parameters.getNumComponentThreads());
+	solutionGuarantor->setSolverPool(solverPool);
+	solutionGuarantor->setGreedyStart(parameters.greedyStart());
+	solutionGuarantor->setApproximate(parameters.approximate());
+	solutionGuarantor->setAdaptivePadding(parameters.getMaxCorePadding());
+	solutionGuarantor->setStitching(parameters.stitching());
+
+	return solutionGuarantor;
+}
+
 } // namespace python
 
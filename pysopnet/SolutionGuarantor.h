@@ -1,7 +1,14 @@
 #ifndef SOPNET_PYTHON_SOLUTION_GUARANTOR_H__
 #define SOPNET_PYTHON_SOLUTION_GUARANTOR_H__
 
+#include <map>
+#include <string>
+
+#include <boost/python/list.hpp>
 #include <blockwise/ProjectConfiguration.h>
+#include <blockwise/guarantors/CoreCostEstimator.h>
+#include <blockwise/guarantors/SolutionGuarantor.h>
+#include <blockwise/ilp/LinearSolverPool.h>
 #include <blockwise/persistence/BackendClient.h>
 #include "SolutionGuarantorParameters.h"
 #include "Locations.h"
@@ -32,6 +39,131 @@ public:
 			const util::point<unsigned int, 3>& coreLocation,
 			const SolutionGuarantorParameters& parameters,
 			const ProjectConfiguration& configuration);
+
+	/**
+	 * Request the extraction and storage of solutions for several cores, which 
+	 * are solved in parallel with a SolutionScheduler.
+	 *
+	 * @param coreLocations
+	 *             The locations of the requested cores.
+	 *
+	 * @param parameters
+	 *             Solution extraction parameters. The number of threads is 
+	 *             shared between the cores.
+	 *
+	 * @param configuration
+	 *             Project specific configuration.
+	 *
+	 * @return
+	 *             A list of block locations, for which segments are needed to 
+	 *             process the request. Empty on success.
+	 */
+	Locations fillCores(
+			const Locations& coreLocations,
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	/**
+	 * Solve cores again after the feature weights or segment costs changed. 
+	 * The ILPs of the cores are kept between calls, such that only their 
+	 * objectives have to be recomputed. The first call for a core solves it 
+	 * from scratch.
+	 *
+	 * @param coreLocations
+	 *             The locations of the cores to re-optimize.
+	 *
+	 * @param parameters
+	 *             Solution extraction parameters. Only the parameters of the 
+	 *             first call are used.
+	 *
+	 * @param configuration
+	 *             Project specific configuration. Only the configuration of 
+	 *             the first call is used.
+	 *
+	 * @return
+	 *             A list of block locations, for which segments are needed to 
+	 *             process the request. Empty on success.
+	 */
+	Locations reoptimize(
+			const Locations& coreLocations,
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	/**
+	 * Solve cores again after explicit segment constraints were added or 
+	 * removed. All cores with a stored solution whose padded blocks contain 
+	 * one of the given blocks are considered. Cores solved with reoptimize() 
+	 * in this process are only solved again if their explicit constraints 
+	 * changed, without reading their segments again. All others are solved 
+	 * from scratch.
+	 *
+	 * @param blockLocations
+	 *             The locations of the blocks containing the slices of the 
+	 *             changed constraints.
+	 *
+	 * @param parameters
+	 *             Solution extraction parameters. Only the parameters of the 
+	 *             first call to reoptimize() or updateConstraints() are used.
+	 *
+	 * @param configuration
+	 *             Project specific configuration.
+	 *
+	 * @return
+	 *             The locations of the cores that were solved again.
+	 */
+	Locations updateConstraints(
+			const Locations& blockLocations,
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	/**
+	 * Estimate the size and solve time of cores without solving them. The 
+	 * estimates are calibrated with the cores solved by fillCores() with cost 
+	 * estimation enabled, and can be used to split or reorder expensive cores 
+	 * before requesting them.
+	 *
+	 * @param coreLocations
+	 *             The locations of the cores to estimate.
+	 *
+	 * @param parameters
+	 *             Solution extraction parameters.
+	 *
+	 * @param configuration
+	 *             Project specific configuration.
+	 *
+	 * @return
+	 *             A list of CoreCostEstimates, one for each core.
+	 */
+	boost::python::list estimateCores(
+			const Locations& coreLocations,
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+private:
+
+	boost::shared_ptr<CoreCostEstimator> getCostEstimator(
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	// get the pool of linear solvers to use for the given parameters and 
+	// configuration, with a solution cache if requested
+	boost::shared_ptr<LinearSolverPool> getSolverPool(
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	boost::shared_ptr< ::SolutionGuarantor> createSolutionGuarantor(
+			const SolutionGuarantorParameters& parameters,
+			const ProjectConfiguration& configuration);
+
+	// the guarantor keeping the ILPs for reoptimize() and updateConstraints()
+	boost::shared_ptr< ::SolutionGuarantor> _reoptimizer;
+
+	// calibrated with the cores solved by fillCores()
+	boost::shared_ptr<CoreCostEstimator> _costEstimator;
+
+	// the linear solvers are kept alive between calls, creating their 
+	// backends is expensive, one pool per solution cache configuration
+	std::map<std::string, boost::shared_ptr<LinearSolverPool> > _solverPools;
 };
 
 } // namespace python
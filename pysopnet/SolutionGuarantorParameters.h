@@ -11,7 +11,15 @@ public:
 		_forceExplanation(false),
 		_readCosts(false),
 		_storeCosts(true),
-		_corePadding(2) {}
+		_corePadding(2),
+		_maxCorePadding(0),
+		_numComponentThreads(1),
+		_greedyStart(false),
+		_approximate(false),
+		_stitching(false),
+		_solutionCache(false),
+		_estimateCosts(false),
+		_numThreads(0) {}
 
 	/**
 	 * Should every clique in the slice conflict graph provide exactly one slice 
@@ -59,6 +67,105 @@ public:
 	 */
 	void setCorePadding(unsigned int corePadding) { _corePadding = corePadding; }
 
+	/**
+	 * Get the maximal number of blocks to pad around the core with adaptive 
+	 * padding.
+	 */
+	unsigned int getMaxCorePadding() const { return _maxCorePadding; }
+
+	/**
+	 * Set the maximal number of blocks to pad around the core. If larger than 
+	 * the core padding, the padding starts at the core padding and grows only 
+	 * on faces that the solution in the core depends on.
+	 */
+	void setMaxCorePadding(unsigned int maxCorePadding) { _maxCorePadding = maxCorePadding; }
+
+	/**
+	 * Get the number of independent components of the ILP that are solved in 
+	 * parallel.
+	 */
+	unsigned int getNumComponentThreads() const { return _numComponentThreads; }
+
+	/**
+	 * Set the number of independent components of the ILP that are solved in 
+	 * parallel. 0 uses all hardware threads.
+	 */
+	void setNumComponentThreads(unsigned int numThreads) { _numComponentThreads = numThreads; }
+
+	/**
+	 * Should a greedy heuristic be run before the ILP, to report its gap?
+	 */
+	bool greedyStart() const { return _greedyStart; }
+
+	/**
+	 * Should a greedy heuristic be run before the ILP, to report its gap?
+	 */
+	void setGreedyStart(bool greedyStart) { _greedyStart = greedyStart; }
+
+	/**
+	 * Should the solution of the greedy heuristic be used directly, without 
+	 * solving the ILP? Fast, but not optimal.
+	 */
+	bool approximate() const { return _approximate; }
+
+	/**
+	 * Should the solution of the greedy heuristic be used directly, without 
+	 * solving the ILP? Fast, but not optimal.
+	 */
+	void setApproximate(bool approximate) { _approximate = approximate; }
+
+	/**
+	 * Should the stored solutions of neighbouring cores be used as boundary 
+	 * conditions? Allows a smaller core padding.
+	 */
+	bool stitching() const { return _stitching; }
+
+	/**
+	 * Should the stored solutions of neighbouring cores be used as boundary 
+	 * conditions? Allows a smaller core padding. If the boundary conditions 
+	 * make the ILP of a core infeasible, it is solved without them and stored 
+	 * as not optimal.
+	 */
+	void setStitching(bool stitching) { _stitching = stitching; }
+
+	/**
+	 * Should solutions of ILPs be cached in the backend, such that identical 
+	 * ILPs are not solved again?
+	 */
+	bool solutionCache() const { return _solutionCache; }
+
+	/**
+	 * Should solutions of ILPs be cached in the backend, such that identical 
+	 * ILPs are not solved again?
+	 */
+	void setSolutionCache(bool solutionCache) { _solutionCache = solutionCache; }
+
+	/**
+	 * Should the cores be ordered by their estimated solve time when solving 
+	 * several cores at once? The estimates are calibrated with the solved 
+	 * cores.
+	 */
+	bool estimateCosts() const { return _estimateCosts; }
+
+	/**
+	 * Should the cores be ordered by their estimated solve time when solving 
+	 * several cores at once? The estimates are calibrated with the solved 
+	 * cores.
+	 */
+	void setEstimateCosts(bool estimateCosts) { _estimateCosts = estimateCosts; }
+
+	/**
+	 * Get the total number of threads to use when solving several cores at 
+	 * once.
+	 */
+	unsigned int getNumThreads() const { return _numThreads; }
+
+	/**
+	 * Set the total number of threads to use when solving several cores at 
+	 * once. 0 uses all hardware threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
 private:
 
 	bool _forceExplanation;
@@ -66,6 +173,17 @@ private:
 	bool _storeCosts;
 
 	unsigned int _corePadding;
+	unsigned int _maxCorePadding;
+
+	unsigned int _numComponentThreads;
+
+	bool _greedyStart;
+	bool _approximate;
+	bool _stitching;
+	bool _solutionCache;
+	bool _estimateCosts;
+
+	unsigned int _numThreads;
 };
 
 } // namespace python
@@ -88,14 +88,34 @@ BOOST_PYTHON_MODULE(libpysopnet) {
 			.def("setMembraneIsBright", &SliceGuarantorParameters::setMembraneIsBright);
 
 	// SegmentGuarantorParameters
-	boost::python::class_<SegmentGuarantorParameters>("SegmentGuarantorParameters");
+	boost::python::class_<SegmentGuarantorParameters>("SegmentGuarantorParameters")
+			.def("setNumFeatureThreads", &SegmentGuarantorParameters::setNumFeatureThreads)
+			.def("getNumFeatureThreads", &SegmentGuarantorParameters::getNumFeatureThreads)
+			.def("setSkipZeroWeightFeatures", &SegmentGuarantorParameters::setSkipZeroWeightFeatures)
+			.def("getSkipZeroWeightFeatures", &SegmentGuarantorParameters::getSkipZeroWeightFeatures);
 
 	// SolutionGuarantorParameters
 	boost::python::class_<SolutionGuarantorParameters>("SolutionGuarantorParameters")
 			.def("setCorePadding", &SolutionGuarantorParameters::setCorePadding)
+			.def("setMaxCorePadding", &SolutionGuarantorParameters::setMaxCorePadding)
+			.def("getMaxCorePadding", &SolutionGuarantorParameters::getMaxCorePadding)
 			.def("setForceExplanation", &SolutionGuarantorParameters::setForceExplanation)
 			.def("setReadCosts", &SolutionGuarantorParameters::setReadCosts)
-			.def("setStoreCosts", &SolutionGuarantorParameters::setStoreCosts);
+			.def("setStoreCosts", &SolutionGuarantorParameters::setStoreCosts)
+			.def("setNumComponentThreads", &SolutionGuarantorParameters::setNumComponentThreads)
+			.def("getNumComponentThreads", &SolutionGuarantorParameters::getNumComponentThreads)
+			.def("setGreedyStart", &SolutionGuarantorParameters::setGreedyStart)
+			.def("greedyStart", &SolutionGuarantorParameters::greedyStart)
+			.def("setApproximate", &SolutionGuarantorParameters::setApproximate)
+			.def("approximate", &SolutionGuarantorParameters::approximate)
+			.def("setStitching", &SolutionGuarantorParameters::setStitching)
+			.def("stitching", &SolutionGuarantorParameters::stitching)
+			.def("setSolutionCache", &SolutionGuarantorParameters::setSolutionCache)
+			.def("solutionCache", &SolutionGuarantorParameters::solutionCache)
+			.def("setEstimateCosts", &SolutionGuarantorParameters::setEstimateCosts)
+			.def("estimateCosts", &SolutionGuarantorParameters::estimateCosts)
+			.def("setNumThreads", &SolutionGuarantorParameters::setNumThreads)
+			.def("getNumThreads", &SolutionGuarantorParameters::getNumThreads);
 
 	// SegmentGuarantorParameters
 	boost::python::class_<GroundTruthGuarantorParameters>("GroundTruthGuarantorParameters");
@@ -163,6 +183,13 @@ BOOST_PYTHON_MODULE(libpysopnet) {
 	boost::python::class_<Locations>("Locations")
 			.def(boost::python::vector_indexing_suite<Locations>());
 
+	// CoreCostEstimate
+	boost::python::class_<CoreCostEstimator::Estimate>("CoreCostEstimate")
+			.def_readonly("numVariables", &CoreCostEstimator::Estimate::numVariables)
+			.def_readonly("numConstraints", &CoreCostEstimator::Estimate::numConstraints)
+			.def_readonly("branchRatio", &CoreCostEstimator::Estimate::branchRatio)
+			.def_readonly("seconds", &CoreCostEstimator::Estimate::seconds);
+
 	// SliceGuarantor
 	boost::python::class_<SliceGuarantor>("SliceGuarantor")
 			.def("fill", &SliceGuarantor::fill);
@@ -173,7 +200,11 @@ BOOST_PYTHON_MODULE(libpysopnet) {
 
 	// SolutionGuarantor
 	boost::python::class_<SolutionGuarantor>("SolutionGuarantor")
-			.def("fill", &SolutionGuarantor::fill);
+			.def("fill", &SolutionGuarantor::fill)
+			.def("fillCores", &SolutionGuarantor::fillCores)
+			.def("reoptimize", &SolutionGuarantor::reoptimize)
+			.def("updateConstraints", &SolutionGuarantor::updateConstraints)
+			.def("estimateCores", &SolutionGuarantor::estimateCores);
 
 	// SolutionGuarantor
 	boost::python::class_<GroundTruthGuarantor>("GroundTruthGuarantor")
@@ -677,7 +677,8 @@ bool testSegments(const ProjectConfiguration& configuration)
 	for (boost::shared_ptr<Segment> segment : sopnetSegments->getSegments())
 	{
 		SegmentDescription segmentDescription(*segment);
-		segmentDescription.setFeatures(sopnetFeatures->get(segment->getId()));
+		Features::const_row_type segmentFeatures = sopnetFeatures->get(segment->getId());
+		segmentDescription.setFeatures(segmentFeatures.begin(), segmentFeatures.end());
 		sopnetDescriptions.add(segmentDescription);
 	}
 
@@ -0,0 +1,110 @@
+#ifndef SOPNET_BINARIES_TESTS_REFERENCE_SOLVERS_H__
+#define SOPNET_BINARIES_TESTS_REFERENCE_SOLVERS_H__
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <solvers/LinearConstraints.h>
+#include <solvers/LinearObjective.h>
+#include <solvers/LinearSolver.h>
+#include <solvers/Solution.h>
+#include <util/exceptions.h>
+
+/**
+ * Check whether the values satisfy all constraints.
+ */
+inline bool
+isFeasible(const LinearConstraints& constraints, const std::vector<double>& values) {
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		double sum = 0;
+		for (const auto& pair : constraint.getCoefficients())
+			sum += pair.second*values[pair.first];
+
+		double tolerance = 1e-6;
+
+		if (constraint.getRelation() == LessEqual && sum > constraint.getValue() + tolerance)
+			return false;
+		if (constraint.getRelation() == GreaterEqual && sum < constraint.getValue() - tolerance)
+			return false;
+		if (constraint.getRelation() == Equal && std::abs(sum - constraint.getValue()) > tolerance)
+			return false;
+	}
+
+	return true;
+}
+
+inline double
+getCost(const std::vector<double>& costs, const std::vector<double>& values) {
+
+	double cost = 0;
+	for (unsigned int var = 0; var < costs.size(); var++)
+		cost += costs[var]*values[var];
+
+	return cost;
+}
+
+/**
+ * Solve a small binary ILP by trying all assignments. Returns an empty vector
+ * if the ILP is infeasible.
+ */
+inline std::vector<double>
+solveBruteForce(const std::vector<double>& costs, const LinearConstraints& constraints) {
+
+	if (costs.size() > 24)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"too many variables (" << costs.size() << ") for a brute-force solve");
+
+	std::vector<double> values(costs.size());
+	std::vector<double> best;
+	double              bestCost = std::numeric_limits<double>::infinity();
+
+	for (unsigned int assignment = 0; assignment < (1u << costs.size()); assignment++) {
+
+		for (unsigned int var = 0; var < costs.size(); var++)
+			values[var] = ((assignment >> var) & 1 ? 1.0 : 0.0);
+
+		double cost = getCost(costs, values);
+
+		if (cost >= bestCost || !isFeasible(constraints, values))
+			continue;
+
+		best     = values;
+		bestCost = cost;
+	}
+
+	return best;
+}
+
+/**
+ * Solve a binary ILP as a whole with the LinearSolver.
+ */
+inline std::vector<double>
+solveMonolithic(const std::vector<double>& costs, const LinearConstraints& constraints) {
+
+	boost::shared_ptr<LinearObjective> objective = boost::make_shared<LinearObjective>(costs.size());
+	for (unsigned int var = 0; var < costs.size(); var++)
+		objective->setCoefficient(var, costs[var]);
+
+	pipeline::Process<LinearSolver> solver;
+	solver->setInput("objective", objective);
+	solver->setInput("linear constraints", boost::make_shared<LinearConstraints>(constraints));
+	solver->setInput("parameters", boost::make_shared<LinearSolverParameters>(Binary));
+
+	pipeline::Value<Solution> solution = solver->getOutput("solution");
+
+	std::vector<double> values(costs.size());
+	for (unsigned int var = 0; var < costs.size(); var++)
+		values[var] = ((*solution)[var] > 0.5 ? 1.0 : 0.0);
+
+	return values;
+}
+
+#endif // SOPNET_BINARIES_TESTS_REFERENCE_SOLVERS_H__
@@ -0,0 +1,84 @@
+#ifndef SOPNET_BINARIES_TESTS_SYNTHETIC_STACK_H__
+#define SOPNET_BINARIES_TESTS_SYNTHETIC_STACK_H__
+
+#include <boost/make_shared.hpp>
+
+#include <inference/ProblemConfiguration.h>
+#include <segments/EndSegment.h>
+#include <solvers/LinearConstraints.h>
+#include <solvers/LinearObjective.h>
+
+/**
+ * Create a slice with a single pixel.
+ */
+inline boost::shared_ptr<Slice>
+createSlice(unsigned int id, unsigned int section) {
+
+	boost::shared_ptr<ConnectedComponent::pixel_list_type> pixelList =
+			boost::make_shared<ConnectedComponent::pixel_list_type>();
+
+	pixelList->add(util::point<unsigned int, 2>(0, 0));
+
+	boost::shared_ptr<ConnectedComponent> cc = boost::make_shared<ConnectedComponent>(
+			std::array<char, 8>(),
+			pixelList,
+			pixelList->begin(),
+			pixelList->end());
+
+	return boost::make_shared<Slice>(id, section, cc);
+}
+
+/**
+ * The working problem of a synthetic stack with one segment per variable. 
+ * Each segment conflicts with the next one in its section and continues into 
+ * the segment at the same position in the next section. The segment ids 
+ * differ from the variable ids, and the costs are exact in single precision.
+ */
+struct SyntheticStack {
+
+	SyntheticStack(unsigned int numSections, unsigned int segmentsPerSection) :
+		objective(boost::make_shared<LinearObjective>(numSections*segmentsPerSection)),
+		constraints(boost::make_shared<LinearConstraints>()),
+		configuration(boost::make_shared<ProblemConfiguration>()) {
+
+		for (unsigned int section = 0; section < numSections; section++)
+			for (unsigned int i = 0; i < segmentsPerSection; i++) {
+
+				unsigned int variable = section*segmentsPerSection + i;
+
+				EndSegment segment(1000 + 3*variable, Right, createSlice(variable, section));
+				configuration->setVariable(segment, variable);
+
+				objective->setCoefficient(variable, 0.25*variable - 20.0);
+
+				// conflict with the next segment in the same section
+				if (i + 1 < segmentsPerSection) {
+
+					LinearConstraint conflict;
+					conflict.setCoefficient(variable, 1.0);
+					conflict.setCoefficient(variable + 1, 1.0);
+					conflict.setRelation(LessEqual);
+					conflict.setValue(1.0);
+					constraints->add(conflict);
+				}
+
+				// continuation into the next section
+				if (section + 1 < numSections) {
+
+					LinearConstraint continuation;
+					continuation.setCoefficient(variable, 1.0);
+					continuation.setCoefficient(variable + segmentsPerSection, -1.0);
+					continuation.setRelation(Equal);
+					continuation.setValue(0.0);
+					constraints->add(continuation);
+				}
+			}
+	}
+
+	boost::shared_ptr<LinearObjective>      objective;
+	boost::shared_ptr<LinearConstraints>    constraints;
+	boost::shared_ptr<ProblemConfiguration> configuration;
+};
+
+#endif // SOPNET_BINARIES_TESTS_SYNTHETIC_STACK_H__
+
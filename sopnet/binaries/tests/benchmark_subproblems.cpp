@@ -0,0 +1,143 @@
+#include <chrono>
+#include <iostream>
+
+#include <inference/ProblemConfiguration.h>
+#include <inference/Subproblems.h>
+#include <inference/SubproblemsExtractor.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "SyntheticStack.h"
+
+util::ProgramOption optionSections(
+		util::_long_name        = "sections",
+		util::_description_text = "The number of sections of the synthetic stack.",
+		util::_default_value    = 1000);
+
+util::ProgramOption optionSegmentsPerSection(
+		util::_long_name        = "segmentsPerSection",
+		util::_description_text = "The number of segments per section of the synthetic stack.",
+		util::_default_value    = 50);
+
+util::ProgramOption optionSize(
+		util::_long_name        = "size",
+		util::_description_text = "The size of the subproblems in sections.",
+		util::_default_value    = 10);
+
+util::ProgramOption optionOverlap(
+		util::_long_name        = "overlap",
+		util::_description_text = "The overlap between neighboring subproblems in sections.",
+		util::_default_value    = 5);
+
+/**
+ * The decomposition as it was done before constraints were routed by their
+ * range of inter-section intervals: For each subproblem, find all constraints
+ * on its variables and keep the ones that are fully contained.
+ */
+void
+decomposeReference(
+		LinearConstraints&    constraints,
+		ProblemConfiguration& configuration,
+		unsigned int          size,
+		unsigned int          overlap,
+		Subproblems&          subproblems) {
+
+	unsigned int subproblemId = 0;
+	for (unsigned int start = configuration.getMinInterSectionInterval(); start < configuration.getMaxInterSectionInterval(); start += size - overlap) {
+
+		std::vector<unsigned int> varIds = configuration.getVariables(start, start + size);
+
+		for (unsigned int varId : varIds)
+			subproblems.assignVariable(varId, subproblemId);
+
+		for (unsigned int i : constraints.getConstraints(varIds)) {
+
+			bool addConstraint = true;
+			for (const auto& pair : constraints[i].getCoefficients())
+				if (!subproblems.getVariableSubproblems(pair.first).count(subproblemId)) {
+
+					addConstraint = false;
+					break;
+				}
+
+			if (addConstraint)
+				subproblems.assignConstraint(i, subproblemId);
+		}
+
+		subproblemId++;
+	}
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		unsigned int numSections        = optionSections.as<unsigned int>();
+		unsigned int segmentsPerSection = optionSegmentsPerSection.as<unsigned int>();
+		unsigned int size               = optionSize.as<unsigned int>();
+		unsigned int overlap            = optionOverlap.as<unsigned int>();
+
+		std::cout << "Creating synthetic stack with " << numSections << " sections and "
+		          << segmentsPerSection << " segments per section..." << std::endl;
+
+		unsigned int numVariables = numSections*segmentsPerSection;
+
+		SyntheticStack stack(numSections, segmentsPerSection);
+
+		boost::shared_ptr<LinearObjective>      objective     = stack.objective;
+		boost::shared_ptr<LinearConstraints>    constraints   = stack.constraints;
+		boost::shared_ptr<ProblemConfiguration> configuration = stack.configuration;
+
+		std::cout << "Decomposing " << constraints->size() << " constraints..." << std::endl;
+
+		typedef std::chrono::high_resolution_clock Clock;
+
+		Clock::time_point referenceBegin = Clock::now();
+
+		Subproblems reference;
+		decomposeReference(*constraints, *configuration, size, overlap, reference);
+
+		std::chrono::duration<double> referenceElapsed = Clock::now() - referenceBegin;
+
+		Clock::time_point extractorBegin = Clock::now();
+
+		pipeline::Process<SubproblemsExtractor> extractor;
+		extractor->setSubproblemsSize(size, overlap);
+		extractor->setInput("objective", objective);
+		extractor->setInput("linear constraints", constraints);
+		extractor->setInput("problem configuration", configuration);
+
+		pipeline::Value<Subproblems> subproblems = extractor->getOutput("subproblems");
+
+		std::chrono::duration<double> extractorElapsed = Clock::now() - extractorBegin;
+
+		std::cout << "per-subproblem lookup: " << referenceElapsed.count() << "s" << std::endl;
+		std::cout << "interval routing:      " << extractorElapsed.count() << "s" << std::endl;
+
+		for (unsigned int variable = 0; variable < numVariables; variable++)
+			if (subproblems->getVariableSubproblems(variable) != reference.getVariableSubproblems(variable))
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"subproblems of variable " << variable << " differ");
+
+		for (unsigned int i = 0; i < constraints->size(); i++)
+			if (subproblems->getConstraintSubproblems(i) != reference.getConstraintSubproblems(i))
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"subproblems of constraint " << i << " differ");
+
+		std::cout << "Decompositions are identical." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <blockwise/guarantors/SolutionGuarantor.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+
+SegmentDescription
+createSegment(
+		unsigned int                  section,
+		const std::vector<SliceHash>& leftSlices,
+		const std::vector<SliceHash>& rightSlices) {
+
+	SegmentDescription segment(section, util::box<unsigned int, 2>(0, 0, 1, 1));
+
+	for (SliceHash slice : leftSlices)
+		segment.addLeftSlice(slice);
+	for (SliceHash slice : rightSlices)
+		segment.addRightSlice(slice);
+
+	return segment;
+}
+
+bool
+shareSlice(const SegmentDescription& a, const SegmentDescription& b) {
+
+	for (const std::vector<SliceHash>* slicesA : { &a.getLeftSlices(), &a.getRightSlices() })
+		for (const std::vector<SliceHash>* slicesB : { &b.getLeftSlices(), &b.getRightSlices() })
+			for (SliceHash slice : *slicesA)
+				if (std::find(slicesB->begin(), slicesB->end(), slice) != slicesB->end())
+					return true;
+
+	return false;
+}
+
+/**
+ * The assemblies by relabeling each pair of selected segments that share a
+ * slice with the smaller label, until nothing changes.
+ */
+std::set<std::set<SegmentHash> >
+getReferenceAssemblies(
+		const std::vector<SegmentHash>& solution,
+		const SegmentDescriptions&      segments) {
+
+	std::vector<const SegmentDescription*> selected;
+	for (const SegmentDescription& segment : segments)
+		if (std::find(solution.begin(), solution.end(), segment.getHash()) != solution.end())
+			selected.push_back(&segment);
+
+	std::vector<unsigned int> labels(selected.size());
+	for (unsigned int i = 0; i < labels.size(); i++)
+		labels[i] = i;
+
+	bool changed = true;
+	while (changed) {
+
+		changed = false;
+
+		for (unsigned int i = 0; i < selected.size(); i++)
+			for (unsigned int j = i + 1; j < selected.size(); j++)
+				if (labels[i] != labels[j] && shareSlice(*selected[i], *selected[j])) {
+
+					labels[i] = labels[j] = std::min(labels[i], labels[j]);
+					changed = true;
+				}
+	}
+
+	std::vector<std::set<SegmentHash> > assemblies(selected.size());
+	for (unsigned int i = 0; i < selected.size(); i++)
+		assemblies[labels[i]].insert(selected[i]->getHash());
+
+	std::set<std::set<SegmentHash> > reference;
+	for (const std::set<SegmentHash>& assembly : assemblies)
+		if (!assembly.empty())
+			reference.insert(assembly);
+
+	return reference;
+}
+
+SliceHash
+getMinSlice(const std::set<SegmentHash>& assembly, const SegmentDescriptions& segments) {
+
+	SliceHash minSlice = std::numeric_limits<SliceHash>::max();
+
+	for (const SegmentDescription& segment : segments) {
+
+		if (!assembly.count(segment.getHash()))
+			continue;
+
+		for (const std::vector<SliceHash>* slices : { &segment.getLeftSlices(), &segment.getRightSlices() })
+			for (SliceHash slice : *slices)
+				minSlice = std::min(minSlice, slice);
+	}
+
+	return minSlice;
+}
+
+/**
+ * Compare the extracted assemblies to the reference, and check that they are
+ * ordered by their smallest slice hash.
+ */
+std::vector<std::set<SegmentHash> >
+checkAssemblies(
+		const std::string&              name,
+		const std::vector<SegmentHash>& solution,
+		const SegmentDescriptions&      segments) {
+
+	std::vector<std::set<SegmentHash> > assemblies = SolutionGuarantor::extractAssemblies(solution, segments);
+
+	std::set<std::set<SegmentHash> > extracted(assemblies.begin(), assemblies.end());
+
+	if (extracted.size() != assemblies.size() || extracted != getReferenceAssemblies(solution, segments))
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": assemblies differ from the reference");
+
+	for (unsigned int i = 1; i < assemblies.size(); i++)
+		if (getMinSlice(assemblies[i - 1], segments) >= getMinSlice(assemblies[i], segments))
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": assemblies are not ordered by their smallest slice");
+
+	std::cout << name << ": " << assemblies.size() << " assemblies agree with the reference" << std::endl;
+
+	return assemblies;
+}
+
+/**
+ * Segments a (1-2), b (2-3), and the branch d (3-4,7) form one assembly, c
+ * (5-6) another one. f (8-9) is connected to c only through the unselected e
+ * (6-8), and forms the third assembly.
+ */
+void
+testHandmade() {
+
+	SegmentDescription a = createSegment(1, {1}, {2});
+	SegmentDescription b = createSegment(2, {2}, {3});
+	SegmentDescription c = createSegment(1, {5}, {6});
+	SegmentDescription d = createSegment(3, {3}, {4, 7});
+	SegmentDescription e = createSegment(2, {6}, {8});
+	SegmentDescription f = createSegment(3, {8}, {9});
+
+	SegmentDescriptions segments;
+	for (const SegmentDescription& segment : { a, b, c, d, e, f })
+		segments.add(segment);
+
+	std::vector<SegmentHash> solution = { a.getHash(), b.getHash(), c.getHash(), d.getHash(), f.getHash() };
+
+	std::vector<std::set<SegmentHash> > assemblies = checkAssemblies("handmade", solution, segments);
+
+	std::vector<std::set<SegmentHash> > expected = {
+			{ a.getHash(), b.getHash(), d.getHash() },
+			{ c.getHash() },
+			{ f.getHash() } };
+
+	if (assemblies != expected)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"handmade: assemblies differ from the expected ones");
+}
+
+/**
+ * Pseudo-random continuations and branches between slices of consecutive
+ * sections, with about two thirds of the segments selected.
+ */
+void
+testRandom() {
+
+	const unsigned int NumSections      = 10;
+	const unsigned int SlicesPerSection = 15;
+
+	unsigned long long x = 42;
+	auto random = [&x](unsigned int n) {
+
+		x = x*6364136223846793005ULL + 1442695040888963407ULL;
+		return static_cast<unsigned int>((x >> 33)%n);
+	};
+
+	SegmentDescriptions segments;
+
+	for (unsigned int section = 1; section < NumSections; section++)
+		for (unsigned int i = 0; i < 2*SlicesPerSection; i++) {
+
+			// slice hashes are made up, but unique per section
+			SliceHash left  = 1000*section + random(SlicesPerSection);
+			SliceHash right = 1000*(section + 1) + random(SlicesPerSection);
+
+			if (random(4) == 0)
+				segments.add(createSegment(section, {left}, {right, right + 500}));
+			else
+				segments.add(createSegment(section, {left}, {right}));
+		}
+
+	std::vector<SegmentHash> solution;
+	for (const SegmentDescription& segment : segments)
+		if (random(3) != 0)
+			solution.push_back(segment.getHash());
+
+	checkAssemblies("random", solution, segments);
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		testHandmade();
+		testRandom();
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
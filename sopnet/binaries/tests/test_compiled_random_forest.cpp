@@ -0,0 +1,154 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <vigra/multi_array.hxx>
+#include <vigra/random_forest.hxx>
+
+#include <inference/CompiledRandomForest.h>
+#include <threads/ThreadPool.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+
+typedef vigra::MultiArray<2, double>       Samples;
+typedef vigra::MultiArray<2, unsigned int> Labels;
+
+const unsigned int NumFeatures     = 4;
+const unsigned int NumClasses      = 3;
+const unsigned int NumTrainSamples = 300;
+const unsigned int NumTestSamples  = 500;
+const unsigned int NumTrees        = 16;
+const unsigned int NumThreads      = 4;
+
+// the batch is stored with padding between the samples, to test the stride
+const unsigned int Stride = NumFeatures + 3;
+
+/**
+ * Random samples with a noisy label that depends on the first two features,
+ * such that the trees have a few levels of splits.
+ */
+void
+createSamples(unsigned int numSamples, std::mt19937& random, Samples& samples, Labels& labels) {
+
+	std::uniform_real_distribution<double> feature(-1.0, 1.0);
+	std::uniform_int_distribution<int>     noise(0, 9);
+
+	samples.reshape(Samples::difference_type(numSamples, NumFeatures));
+	labels.reshape(Labels::difference_type(numSamples, 1));
+
+	for (unsigned int s = 0; s < numSamples; s++) {
+
+		for (unsigned int f = 0; f < NumFeatures; f++)
+			samples(s, f) = feature(random);
+
+		unsigned int label = (samples(s, 0) < 0 ? 0 : (samples(s, 1) < 0.3 ? 1 : 2));
+
+		// flip one in ten labels
+		if (noise(random) == 0)
+			label = (label + 1)%NumClasses;
+
+		labels(s, 0) = label;
+	}
+}
+
+/**
+ * Train a forest, compile it, and compare its batch predictions with and
+ * without a thread pool to the prediction of vigra for each sample.
+ */
+void
+testForest(bool weighted) {
+
+	std::string name = (weighted ? "weighted" : "unweighted");
+
+	std::mt19937 random(42);
+
+	Samples trainSamples;
+	Labels  trainLabels;
+	createSamples(NumTrainSamples, random, trainSamples, trainLabels);
+
+	vigra::RandomForestOptions options;
+	options.tree_count(NumTrees);
+	if (weighted)
+		options.predict_weighted();
+
+	vigra::RandomForest<unsigned int> rf(options);
+	rf.learn(trainSamples, trainLabels);
+
+	if (rf.class_count() != (int)NumClasses)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": the forest was trained with " << rf.class_count() << " classes");
+
+	CompiledRandomForest compiled;
+	compiled.compile(rf);
+
+	if (compiled.getNumFeatures() != NumFeatures || compiled.getNumClasses() != NumClasses)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": the compiled forest has " << compiled.getNumFeatures() << " features and "
+				<< compiled.getNumClasses() << " classes");
+
+	Samples testSamples;
+	Labels  testLabels;
+	createSamples(NumTestSamples, random, testSamples, testLabels);
+
+	std::vector<double> batch(NumTestSamples*Stride, 0.0);
+	for (unsigned int s = 0; s < NumTestSamples; s++)
+		for (unsigned int f = 0; f < NumFeatures; f++)
+			batch[s*Stride + f] = testSamples(s, f);
+
+	std::vector<double> probabilities(NumTestSamples*NumClasses);
+	std::vector<double> parallelProbabilities(NumTestSamples*NumClasses);
+
+	compiled.getProbabilities(batch.data(), NumTestSamples, Stride, probabilities.data());
+
+	ThreadPool threadPool(NumThreads);
+	compiled.getProbabilities(batch.data(), NumTestSamples, Stride, parallelProbabilities.data(), &threadPool);
+
+	if (parallelProbabilities != probabilities)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": the predictions with and without threads differ");
+
+	Samples sample(Samples::difference_type(1, NumFeatures));
+	Samples expected(Samples::difference_type(1, NumClasses));
+
+	for (unsigned int s = 0; s < NumTestSamples; s++) {
+
+		for (unsigned int f = 0; f < NumFeatures; f++)
+			sample(0, f) = testSamples(s, f);
+
+		rf.predictProbabilities(sample, expected);
+
+		for (unsigned int c = 0; c < NumClasses; c++)
+			if (std::abs(probabilities[s*NumClasses + c] - expected(0, c)) > 1e-10)
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						name << ": sample " << s << " has probability " << probabilities[s*NumClasses + c]
+						<< " for class " << c << ", vigra predicts " << expected(0, c));
+	}
+
+	std::cout << "The " << name << " forest predicts the same probabilities as vigra." << std::endl;
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		testForest(false);
+		testForest(true);
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
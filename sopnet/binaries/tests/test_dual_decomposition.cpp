@@ -0,0 +1,143 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include <inference/DualDecompositionSolver.h>
+#include <inference/Problems.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "SyntheticStack.h"
+
+/**
+ * Two slaves share the variable 0. Slave 0 has the variables {0, 1} with
+ * x0 + x1 = 1, slave 1 has the variables {0, 2} with x0 + x2 <= 1. The costs
+ * are -1 for x0, 0.2 for x1, and -2 for x2.
+ *
+ * In the first iteration, slave 0 picks x0 (-0.5 < 0.2) and slave 1 picks x2
+ * (-2 < -0.5). The majority vote of x0 is 0, which violates x0 + x1 = 1. The
+ * optimum is x1 = x2 = 1 with a value of -1.8.
+ */
+
+const unsigned int NumVariables = 3;
+
+const double Costs[NumVariables] = { -1.0, 0.2, -2.0 };
+
+boost::shared_ptr<Problem>
+createSlave(
+		unsigned int                                   other,
+		Relation                                       relation,
+		boost::shared_ptr<ProblemConfiguration>       global) {
+
+	boost::shared_ptr<Problem> problem = boost::make_shared<Problem>(2);
+
+	unsigned int variables[2] = { 0, other };
+
+	LinearConstraint constraint;
+	constraint.setRelation(relation);
+	constraint.setValue(1);
+
+	for (unsigned int var = 0; var < 2; var++) {
+
+		EndSegment segment(global->getSegmentId(variables[var]), Right, createSlice(variables[var], 0));
+		problem->getConfiguration()->setVariable(segment, var);
+		problem->getObjective()->setCoefficient(var, Costs[variables[var]]);
+		constraint.setCoefficient(var, 1);
+	}
+
+	problem->getLinearConstraints()->add(constraint);
+
+	return problem;
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		boost::shared_ptr<ProblemConfiguration> configuration = boost::make_shared<ProblemConfiguration>();
+		for (unsigned int var = 0; var < NumVariables; var++)
+			configuration->setVariable(EndSegment(100 + var, Right, createSlice(var, 0)), var);
+
+		boost::shared_ptr<Problems> problems = boost::make_shared<Problems>();
+		problems->addProblem(createSlave(1, Equal, configuration));
+		problems->addProblem(createSlave(2, LessEqual, configuration));
+
+		// brute force over all assignments
+
+		double       optimum        = std::numeric_limits<double>::infinity();
+		unsigned int bestAssignment = 0;
+
+		for (unsigned int assignment = 0; assignment < (1u << NumVariables); assignment++) {
+
+			bool x[NumVariables];
+			for (unsigned int var = 0; var < NumVariables; var++)
+				x[var] = (assignment >> var) & 1;
+
+			if (x[0] + x[1] != 1 || x[0] + x[2] > 1)
+				continue;
+
+			double value = 0;
+			for (unsigned int var = 0; var < NumVariables; var++)
+				value += Costs[var]*x[var];
+
+			if (value < optimum) {
+
+				optimum        = value;
+				bestAssignment = assignment;
+			}
+		}
+
+		std::cout << "Solving two slaves by dual decomposition..." << std::endl;
+
+		pipeline::Process<DualDecompositionSolver> solver;
+		solver->setMaxIterations(10);
+		solver->setInput("problems", problems);
+		solver->setInput("problem configuration", configuration);
+
+		pipeline::Value<Solution> solution = solver->getOutput("solution");
+
+		const std::vector<DualDecompositionSolver::Iteration>& iterations = solver->getIterations();
+
+		if (iterations.empty() || iterations[0].primal < std::numeric_limits<double>::infinity())
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"the vote of the first iteration should be infeasible");
+
+		if (iterations.size() < 2)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"stopped after the first iteration without a feasible assignment");
+
+		std::cout << "Stopped after " << iterations.size() << " iterations." << std::endl;
+
+		double value = 0;
+		for (unsigned int var = 0; var < NumVariables; var++) {
+
+			if ((*solution)[var] != ((bestAssignment >> var) & 1))
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"variable " << var << " differs from the brute-force optimum");
+
+			value += Costs[var]*(*solution)[var];
+		}
+
+		if (std::abs(value - optimum) > 1e-6)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"value " << value << " differs from the optimum " << optimum);
+
+		std::cout << "Found the optimum " << optimum << "." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <blockwise/ilp/GreedySolver.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "ReferenceSolvers.h"
+#include "SyntheticStack.h"
+
+/**
+ * Solve with the GreedySolver and check that the solution is feasible, that
+ * the reported cost is the cost of the solution, and that it is not better
+ * than the optimum. Returns the cost of the solution.
+ */
+double
+checkGreedy(
+		const std::string&         name,
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		double                     optimum,
+		const std::vector<double>& start = std::vector<double>()) {
+
+	GreedySolver solver;
+	std::vector<double> values = solver.solve(costs, constraints, start);
+
+	// the search starts from a feasible solution and never accepts moves
+	// that violate more constraints
+	if (!solver.isFeasible() || !isFeasible(constraints, values))
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": solution is not feasible");
+
+	double cost = getCost(costs, values);
+
+	if (std::abs(solver.getCost() - cost) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": reported cost " << solver.getCost() << " differs from the cost of the solution " << cost);
+
+	if (cost < optimum - 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": cost " << cost << " is below the optimum " << optimum);
+
+	std::cout
+			<< name << ": cost " << cost << " after " << solver.getNumMoves()
+			<< " moves, the optimum is " << optimum << std::endl;
+
+	return cost;
+}
+
+/**
+ * x0 + x1 + x2 <= 1 with costs -1, -2, -0.5. The cheapest variable x1 is
+ * switched on first, switching on x0 or x2 instead would have to switch off
+ * x1 and is rejected. The greedy solution is the optimum.
+ */
+void
+testConflict() {
+
+	std::vector<double> costs = { -1.0, -2.0, -0.5 };
+
+	LinearConstraint conflict;
+	for (unsigned int var = 0; var < 3; var++)
+		conflict.setCoefficient(var, 1.0);
+	conflict.setRelation(LessEqual);
+	conflict.setValue(1.0);
+
+	LinearConstraints constraints;
+	constraints.add(conflict);
+
+	double cost = checkGreedy("conflict", costs, constraints, -2.0);
+
+	if (std::abs(cost + 2.0) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"conflict: greedy solution is not the optimum");
+}
+
+/**
+ * The synthetic stack has conflicts within and continuations between
+ * sections, which are satisfied by all zeros. Starting from the optimum, no
+ * move can improve the solution.
+ */
+void
+testSyntheticStack() {
+
+	SyntheticStack stack(4, 3);
+
+	const std::vector<double>& costs = stack.objective->getCoefficients();
+
+	std::vector<double> bruteForce = solveBruteForce(costs, *stack.constraints);
+	double              optimum    = getCost(costs, bruteForce);
+
+	if (std::abs(getCost(costs, solveMonolithic(costs, *stack.constraints)) - optimum) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"monolithic solve differs from the brute-force optimum");
+
+	double cost = checkGreedy("synthetic stack", costs, *stack.constraints, optimum);
+
+	if (cost > 0)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"synthetic stack: greedy solution is worse than the start");
+
+	cost = checkGreedy("synthetic stack from the optimum", costs, *stack.constraints, optimum, bruteForce);
+
+	if (std::abs(cost - optimum) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"synthetic stack: greedy search left the optimum");
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		testConflict();
+		testSyntheticStack();
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <blockwise/ilp/HashIndex.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+
+/**
+ * Check the index against a std::map from each distinct hash to its rank,
+ * which is the index HashIndex has to assign. Also look up the given absent
+ * hashes.
+ */
+void
+checkIndex(
+		const std::string&              name,
+		const std::vector<std::size_t>& hashes,
+		const std::vector<std::size_t>& absent) {
+
+	HashIndex index;
+	index.build(hashes);
+
+	std::map<std::size_t, unsigned int> reference;
+	for (std::size_t hash : hashes)
+		reference[hash] = 0;
+
+	unsigned int rank = 0;
+	for (auto& pair : reference)
+		pair.second = rank++;
+
+	if (index.size() != reference.size())
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": index has " << index.size() << " entries, expected " << reference.size());
+
+	for (const auto& pair : reference) {
+
+		if (index.find(pair.first) != pair.second)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": hash " << pair.first << " has index " << index.find(pair.first)
+					<< ", expected " << pair.second);
+
+		if (index.getHash(pair.second) != pair.first)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": index " << pair.second << " has hash " << index.getHash(pair.second)
+					<< ", expected " << pair.first);
+	}
+
+	for (std::size_t hash : absent)
+		if (!reference.count(hash) && index.find(hash) != HashIndex::NotFound)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": absent hash " << hash << " was found");
+
+	std::cout << name << ": " << index.size() << " entries agree with the reference" << std::endl;
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		// nothing is found in an empty index
+		checkIndex("empty", {}, {0, 1, 42});
+
+		// unsorted with duplicates, the indices are the ranks 0 to 3
+		checkIndex("duplicates", {30, 10, 20, 10, 40, 30}, {0, 15, 50});
+
+		// hashes that only differ in their high bits, which all land in the
+		// same slot without the mixing
+		std::vector<std::size_t> highBits;
+		for (std::size_t i = 1; i <= 64; i++)
+			highBits.push_back(i << 40);
+		checkIndex("high bits", highBits, {1ull << 39, 65ull << 40, 0});
+
+		// many pseudo-random hashes, with lookups of the neighbouring values
+		std::vector<std::size_t> random;
+		std::vector<std::size_t> neighbours;
+		unsigned long long x = 12345;
+		for (unsigned int i = 0; i < 10000; i++) {
+
+			x = x*6364136223846793005ULL + 1442695040888963407ULL;
+			random.push_back(static_cast<std::size_t>(x));
+			neighbours.push_back(static_cast<std::size_t>(x + 1));
+		}
+		checkIndex("random", random, neighbours);
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,180 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <blockwise/ilp/IlpSolver.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "ReferenceSolvers.h"
+
+/**
+ * An ILP with four independent components:
+ *
+ * - variables 0 to 2 in a single conflict x0 + x1 + x2 <= 1,
+ * - variables 3 to 14 in a chain of conflicts x_i + x_{i+1} <= 1, which is
+ *   too large to be enumerated by default,
+ * - variable 15 with negative cost and no constraints,
+ * - variable 16 with positive cost and no constraints.
+ */
+
+const unsigned int ChainBegin   = 3;
+const unsigned int ChainEnd     = 15;
+const unsigned int NumVariables = 17;
+
+std::vector<double>
+createCosts() {
+
+	std::vector<double> costs(NumVariables);
+
+	costs[0] = -1.0;
+	costs[1] = -2.0;
+	costs[2] = -0.5;
+
+	for (unsigned int var = ChainBegin; var < ChainEnd; var++)
+		costs[var] = -(1.0 + ((var*7)%5)*0.25);
+
+	costs[15] = -0.7;
+	costs[16] =  0.4;
+
+	return costs;
+}
+
+void
+addConflict(LinearConstraints& constraints, const std::vector<unsigned int>& variables) {
+
+	LinearConstraint conflict;
+	for (unsigned int var : variables)
+		conflict.setCoefficient(var, 1.0);
+	conflict.setRelation(LessEqual);
+	conflict.setValue(1.0);
+
+	constraints.add(conflict);
+}
+
+LinearConstraints
+createConstraints() {
+
+	LinearConstraints constraints;
+
+	addConflict(constraints, {0, 1, 2});
+
+	for (unsigned int var = ChainBegin; var + 1 < ChainEnd; var++)
+		addConflict(constraints, {var, var + 1});
+
+	return constraints;
+}
+
+void
+check(
+		const std::string&         name,
+		const std::vector<double>& values,
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		double                     optimum) {
+
+	if (!isFeasible(constraints, values))
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": solution is not feasible");
+
+	if (std::abs(getCost(costs, values) - optimum) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": cost " << getCost(costs, values) << " differs from the optimum " << optimum);
+
+	std::cout << name << ": found the optimum" << std::endl;
+}
+
+void
+checkCount(const std::string& name, unsigned int count, unsigned int expected) {
+
+	if (count != expected)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << " is " << count << ", expected " << expected);
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		std::vector<double> costs       = createCosts();
+		LinearConstraints   constraints = createConstraints();
+
+		std::vector<double> bruteForce = solveBruteForce(costs, constraints);
+		double              optimum    = getCost(costs, bruteForce);
+
+		std::cout << "Brute-force optimum is " << optimum << std::endl;
+
+		check("monolithic LinearSolver", solveMonolithic(costs, constraints), costs, constraints, optimum);
+
+		{
+			IlpSolver solver;
+			solver.setPresolve(false);
+
+			check("components", solver.solve(costs, constraints), costs, constraints, optimum);
+			checkCount("number of components", solver.getNumComponents(), 4);
+			checkCount("number of solver components", solver.getNumSolverComponents(), 1);
+		}
+
+		{
+			IlpSolver solver;
+			solver.setPresolve(false);
+			solver.setMaxEnumerationSize(ChainEnd - ChainBegin);
+
+			check("enumeration", solver.solve(costs, constraints), costs, constraints, optimum);
+			checkCount("number of components", solver.getNumComponents(), 4);
+			checkCount("number of solver components", solver.getNumSolverComponents(), 0);
+		}
+
+		{
+			IlpSolver solver;
+			solver.setNumThreads(4);
+
+			check("presolve and threads", solver.solve(costs, constraints), costs, constraints, optimum);
+
+			if (solver.getStatus() != IlpSolver::Optimal)
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"presolve and threads: feasible problem was not solved to optimality");
+		}
+
+		{
+			// x15 = 1 contradicts x15 <= 0
+			LinearConstraints infeasible = createConstraints();
+
+			LinearConstraint fix;
+			fix.setCoefficient(15, 1.0);
+			fix.setRelation(Equal);
+			fix.setValue(1.0);
+			infeasible.add(fix);
+
+			LinearConstraint bound;
+			bound.setCoefficient(15, 1.0);
+			bound.setRelation(LessEqual);
+			bound.setValue(0.0);
+			infeasible.add(bound);
+
+			IlpSolver solver;
+			solver.solve(costs, infeasible);
+
+			if (solver.getStatus() != IlpSolver::Infeasible)
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"infeasible problem was not reported");
+
+			std::cout << "infeasible: reported" << std::endl;
+		}
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include <features/Features.h>
+#include <features/SegmentFeaturesExtractor.h>
+#include <imageprocessing/ConnectedComponent.h>
+#include <imageprocessing/ImageStack.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <segments/BranchSegment.h>
+#include <segments/ContinuationSegment.h>
+#include <segments/EndSegment.h>
+#include <segments/Segments.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+
+const unsigned int NumSections      = 6;
+const unsigned int SlicesPerSection = 12;
+const unsigned int SectionSize      = 64;
+const unsigned int NumThreads       = 4;
+const unsigned int NumParallelRuns  = 5;
+
+/**
+ * Create a slice of a rectangle of pixels, with a notch in the lower right
+ * corner for slices that are large enough.
+ */
+boost::shared_ptr<Slice>
+createSlice(
+		unsigned int id,
+		unsigned int section,
+		unsigned int x,
+		unsigned int y,
+		unsigned int width,
+		unsigned int height) {
+
+	boost::shared_ptr<ConnectedComponent::pixel_list_type> pixelList =
+			boost::make_shared<ConnectedComponent::pixel_list_type>();
+
+	for (unsigned int dy = 0; dy < height; dy++)
+		for (unsigned int dx = 0; dx < width; dx++)
+			if (width < 3 || height < 3 || dx + 1 < width || dy + 1 < height)
+				pixelList->add(util::point<unsigned int, 2>(x + dx, y + dy));
+
+	boost::shared_ptr<ConnectedComponent> cc = boost::make_shared<ConnectedComponent>(
+			std::array<char, 8>(),
+			pixelList,
+			pixelList->begin(),
+			pixelList->end());
+
+	return boost::make_shared<Slice>(id, section, cc);
+}
+
+/**
+ * Slices of varying shapes and positions in each section, and all kinds of
+ * segments between the slices of consecutive sections.
+ */
+boost::shared_ptr<Segments>
+createSegments() {
+
+	std::vector<std::vector<boost::shared_ptr<Slice> > > slices(NumSections);
+
+	unsigned int sliceId = 0;
+
+	for (unsigned int section = 0; section < NumSections; section++)
+		for (unsigned int i = 0; i < SlicesPerSection; i++)
+			slices[section].push_back(createSlice(
+					sliceId++,
+					section,
+					(4*i + section)%(SectionSize - 8),
+					(3*i + 2*section)%(SectionSize - 8),
+					1 + (i + section)%6,
+					1 + (2*i + section)%5));
+
+	boost::shared_ptr<Segments> segments = boost::make_shared<Segments>();
+
+	unsigned int segmentId = 0;
+
+	for (unsigned int section = 0; section + 1 < NumSections; section++) {
+
+		for (unsigned int i = 0; i < SlicesPerSection; i++) {
+
+			unsigned int next = (i + 1)%SlicesPerSection;
+
+			segments->add(boost::make_shared<EndSegment>(
+					segmentId++, Right, slices[section][i]));
+			segments->add(boost::make_shared<EndSegment>(
+					segmentId++, Left, slices[section + 1][i]));
+			segments->add(boost::make_shared<ContinuationSegment>(
+					segmentId++, Right, slices[section][i], slices[section + 1][i]));
+			segments->add(boost::make_shared<ContinuationSegment>(
+					segmentId++, Left, slices[section + 1][i], slices[section][next]));
+			segments->add(boost::make_shared<BranchSegment>(
+					segmentId++, Right, slices[section][i], slices[section + 1][i], slices[section + 1][next]));
+			segments->add(boost::make_shared<BranchSegment>(
+					segmentId++, Left, slices[section + 1][i], slices[section][i], slices[section][next]));
+		}
+	}
+
+	return segments;
+}
+
+/**
+ * Raw sections with a deterministic texture.
+ */
+boost::shared_ptr<ImageStack<IntensityImage> >
+createRawSections() {
+
+	boost::shared_ptr<ImageStack<IntensityImage> > rawSections = boost::make_shared<ImageStack<IntensityImage> >();
+
+	for (unsigned int section = 0; section < NumSections; section++) {
+
+		boost::shared_ptr<IntensityImage> image = boost::make_shared<IntensityImage>(SectionSize, SectionSize);
+
+		for (unsigned int i = 0; i < SectionSize*SectionSize; i++)
+			(*image)[i] = ((i*7 + section*13)%31)/31.0;
+
+		rawSections->add(image);
+	}
+
+	return rawSections;
+}
+
+pipeline::Value<Features>
+extractFeatures(
+		unsigned int                                   numThreads,
+		boost::shared_ptr<Segments>                    segments,
+		boost::shared_ptr<ImageStack<IntensityImage> > rawSections) {
+
+	pipeline::Process<SegmentFeaturesExtractor> featuresExtractor;
+	pipeline::Value<util::point<unsigned int, 3> > offset(util::point<unsigned int, 3>(0, 0, 0));
+
+	featuresExtractor->setNumThreads(numThreads);
+
+	featuresExtractor->setInput("segments", segments);
+	featuresExtractor->setInput("raw sections", rawSections);
+	featuresExtractor->setInput("crop offset", offset);
+
+	pipeline::Value<Features> features = featuresExtractor->getOutput("all features");
+
+	return features;
+}
+
+/**
+ * Check that the features of each segment are bit-identical, such that not
+ * even the order of floating point operations differs between the two
+ * extractions.
+ */
+void
+compareFeatures(
+		const Features&                    expected,
+		const Features&                    features,
+		const boost::shared_ptr<Segments>& segments) {
+
+	if (features.size() != expected.size() || features.getNames() != expected.getNames())
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"got " << features.size() << " feature vectors with " << features.getNames().size()
+				<< " features, expected " << expected.size() << " with " << expected.getNames().size());
+
+	for (boost::shared_ptr<Segment> segment : segments->getSegments()) {
+
+		Features::const_row_type row         = features[features.rowIndex(segment->getId())];
+		Features::const_row_type expectedRow = expected[expected.rowIndex(segment->getId())];
+
+		for (unsigned int i = 0; i < row.size(); i++)
+			if (std::memcmp(&row[i], &expectedRow[i], sizeof(double)) != 0)
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"feature " << expected.getNames()[i] << " of segment " << segment->getId()
+						<< " is " << row[i] << " with " << NumThreads << " threads, expected "
+						<< expectedRow[i]);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		boost::shared_ptr<Segments>                    segments    = createSegments();
+		boost::shared_ptr<ImageStack<IntensityImage> > rawSections = createRawSections();
+
+		std::cout << "Extracting features of " << segments->size() << " segments." << std::endl;
+
+		pipeline::Value<Features> expected = extractFeatures(1, segments, rawSections);
+
+		// repeat to catch different interleavings of the chunks
+		for (unsigned int run = 0; run < NumParallelRuns; run++) {
+
+			pipeline::Value<Features> features = extractFeatures(NumThreads, segments, rawSections);
+			compareFeatures(*expected, *features, segments);
+		}
+
+		std::cout
+				<< "The features extracted with " << NumThreads << " threads are identical to "
+				<< "the ones extracted with one thread." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
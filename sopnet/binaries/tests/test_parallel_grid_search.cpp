@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+
+#include <imageprocessing/ImageStack.h>
+#include <inference/GridSearch.h>
+#include <inference/ParallelGridSearch.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <segments/BranchSegment.h>
+#include <segments/ContinuationSegment.h>
+#include <segments/EndSegment.h>
+#include <segments/Segments.h>
+#include <solvers/LinearConstraints.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "SyntheticStack.h"
+
+const double PruneMargin = 0.5;
+
+const unsigned int NumThreads = 4;
+
+typedef boost::function<
+		void
+		(const std::vector<boost::shared_ptr<EndSegment> >&          ends,
+		 const std::vector<boost::shared_ptr<ContinuationSegment> >& continuations,
+		 const std::vector<boost::shared_ptr<BranchSegment> >&       branches,
+		 std::vector<double>& costs)>
+		CostFunction;
+
+/**
+ * A point of the grid, in the order of GridSearch, and its line: the points
+ * that differ only in the end prior.
+ */
+struct Point {
+
+	PriorCostFunctionParameters        priors;
+	SegmentationCostFunctionParameters segmentation;
+
+	unsigned int line;
+	unsigned int position;
+	unsigned int lineSize;
+};
+
+std::vector<Point>
+getGrid() {
+
+	std::vector<Point> grid;
+
+	pipeline::Process<GridSearch> gridSearch;
+
+	do {
+
+		Point point;
+		point.priors       = gridSearch->getPriorCostFunctionParameters();
+		point.segmentation = gridSearch->getSegmentationCostFunctionParameters();
+
+		// the same rule as ParallelGridSearch: a line ends whenever any
+		// parameter but the end prior changes
+		bool newLine = grid.empty();
+
+		if (!newLine) {
+
+			const Point& previous = grid.back();
+
+			newLine =
+					point.priors.priorContinuation     != previous.priors.priorContinuation ||
+					point.priors.priorBranch           != previous.priors.priorBranch ||
+					point.segmentation.weightPotts     != previous.segmentation.weightPotts ||
+					point.segmentation.priorForeground != previous.segmentation.priorForeground;
+		}
+
+		point.line     = (newLine ? (grid.empty() ? 0 : grid.back().line + 1) : grid.back().line);
+		point.position = (newLine ? 0 : grid.back().position + 1);
+
+		grid.push_back(point);
+
+	} while (gridSearch->next());
+
+	for (Point& point : grid) {
+
+		unsigned int lineSize = 0;
+		for (const Point& other : grid)
+			if (other.line == point.line)
+				lineSize++;
+
+		point.lineSize = lineSize;
+	}
+
+	return grid;
+}
+
+/**
+ * The scripted value of a point. Along each line, the value falls until a
+ * third of the line and rises after. The minima of the lines rise with the
+ * distance to the middle line, which has the global minimum 0.
+ */
+double
+getValue(const Point& point, unsigned int numLines) {
+
+	double offset = 0.1*std::abs(static_cast<double>(point.line) - numLines/2);
+	double x      = static_cast<double>(point.position) - point.lineSize/3.0;
+
+	return offset + 0.1*x*x;
+}
+
+/**
+ * The points that the search has to evaluate, in grid order, and the points it
+ * has to prune. With one thread, the best value of the line and the earlier
+ * lines is the best value so far, the same holds for any number of threads.
+ */
+void
+simulatePruning(
+		const std::vector<Point>&  grid,
+		unsigned int               numLines,
+		std::vector<unsigned int>& evaluated,
+		std::vector<bool>&         pruned) {
+
+	pruned.assign(grid.size(), false);
+
+	double best     = std::numeric_limits<double>::infinity();
+	double previous = std::numeric_limits<double>::infinity();
+	bool   skipLine = false;
+
+	for (unsigned int i = 0; i < grid.size(); i++) {
+
+		if (grid[i].position == 0) {
+
+			previous = std::numeric_limits<double>::infinity();
+			skipLine = false;
+		}
+
+		if (skipLine) {
+
+			pruned[i] = true;
+			continue;
+		}
+
+		double value = getValue(grid[i], numLines);
+		evaluated.push_back(i);
+
+		best = std::min(best, value);
+
+		if (value > previous && value > best + PruneMargin)
+			skipLine = true;
+
+		previous = value;
+	}
+}
+
+boost::shared_ptr<ImageStack<IntensityImage> >
+createMembranes(unsigned int numSections) {
+
+	boost::shared_ptr<ImageStack<IntensityImage> > membranes = boost::make_shared<ImageStack<IntensityImage> >();
+
+	for (unsigned int section = 0; section < numSections; section++) {
+
+		boost::shared_ptr<IntensityImage> image = boost::make_shared<IntensityImage>(1, 1);
+		(*image)[0] = 0.5;
+		membranes->add(image);
+	}
+
+	return membranes;
+}
+
+/**
+ * The sorted distinct values of one of the priors in the grid.
+ */
+std::vector<double>
+getPriorValues(const std::vector<Point>& grid, double PriorCostFunctionParameters::*prior) {
+
+	std::vector<double> values;
+	for (const Point& point : grid)
+		values.push_back(point.priors.*prior);
+
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+
+	return values;
+}
+
+/**
+ * The thresholds between consecutive values of a prior. A segment with the
+ * negative threshold as costs is selected if and only if the prior is below
+ * the threshold, such that the number of selected segments of a ladder
+ * reveals the prior of the point.
+ */
+std::vector<double>
+getThresholds(const std::vector<double>& values) {
+
+	std::vector<double> thresholds;
+	for (unsigned int i = 0; i + 1 < values.size(); i++)
+		thresholds.push_back(0.5*(values[i] + values[i + 1]));
+
+	return thresholds;
+}
+
+/**
+ * Find the value of a prior from the number of selected segments of its
+ * ladder.
+ */
+double
+decodePrior(
+		const Solution&            solution,
+		unsigned int               begin,
+		const std::vector<double>& values) {
+
+	unsigned int numSelected = 0;
+	for (unsigned int i = 0; i + 1 < values.size(); i++)
+		if (solution[begin + i] > 0.5)
+			numSelected++;
+
+	return values[values.size() - 1 - numSelected];
+}
+
+/**
+ * Run the search with the given margin and number of threads on ladders of
+ * end, continuation, and branch segments, one for each prior. The evaluator
+ * decodes the point from the solution and returns its scripted value, such
+ * that the values do not depend on the order of the evaluations.
+ */
+void
+search(
+		double                                   pruneMargin,
+		unsigned int                             numThreads,
+		const std::vector<Point>&                grid,
+		unsigned int                             numLines,
+		std::vector<ParallelGridSearch::Result>& results,
+		PriorCostFunctionParameters&             best,
+		unsigned int&                            numEvaluated) {
+
+	std::vector<double> ends          = getPriorValues(grid, &PriorCostFunctionParameters::priorEnd);
+	std::vector<double> continuations = getPriorValues(grid, &PriorCostFunctionParameters::priorContinuation);
+	std::vector<double> branches      = getPriorValues(grid, &PriorCostFunctionParameters::priorBranch);
+
+	boost::shared_ptr<Segments> segments = boost::make_shared<Segments>();
+	std::map<unsigned int, double> baseCosts;
+
+	unsigned int id = 0;
+
+	// ends in the middle interval of three, continuations and branches in
+	// the last one
+	for (double threshold : getThresholds(ends)) {
+
+		segments->add(boost::make_shared<EndSegment>(id, Right, createSlice(id, 0)));
+		baseCosts[id] = -threshold;
+		id++;
+	}
+
+	for (double threshold : getThresholds(continuations)) {
+
+		segments->add(boost::make_shared<ContinuationSegment>(
+				id, Right, createSlice(id, 1), createSlice(id + 1, 2)));
+		baseCosts[id] = -threshold;
+		id += 2;
+	}
+
+	for (double threshold : getThresholds(branches)) {
+
+		segments->add(boost::make_shared<BranchSegment>(
+				id, Right, createSlice(id, 1), createSlice(id + 1, 2), createSlice(id + 2, 2)));
+		baseCosts[id] = -threshold;
+		id += 3;
+	}
+
+	boost::shared_ptr<CostFunction> costFunction = boost::make_shared<CostFunction>(
+			[&baseCosts](
+					const std::vector<boost::shared_ptr<EndSegment> >&          ends,
+					const std::vector<boost::shared_ptr<ContinuationSegment> >& continuations,
+					const std::vector<boost::shared_ptr<BranchSegment> >&       branches,
+					std::vector<double>& costs) {
+
+				unsigned int i = 0;
+
+				for (boost::shared_ptr<EndSegment> end : ends)
+					costs[i++] += baseCosts[end->getId()];
+				for (boost::shared_ptr<ContinuationSegment> continuation : continuations)
+					costs[i++] += baseCosts[continuation->getId()];
+				for (boost::shared_ptr<BranchSegment> branch : branches)
+					costs[i++] += baseCosts[branch->getId()];
+			});
+
+	// the ladders in the order of the objective
+	unsigned int endsBegin          = 0;
+	unsigned int continuationsBegin = endsBegin + ends.size() - 1;
+	unsigned int branchesBegin      = continuationsBegin + continuations.size() - 1;
+
+	std::atomic<unsigned int> numCalls(0);
+
+	pipeline::Process<ParallelGridSearch> gridSearch;
+	gridSearch->setNumThreads(numThreads);
+	gridSearch->setPruneMargin(pruneMargin);
+	gridSearch->setEvaluator([&](const Solution& solution) -> double {
+
+		numCalls++;
+
+		double priorEnd          = decodePrior(solution, endsBegin, ends);
+		double priorContinuation = decodePrior(solution, continuationsBegin, continuations);
+		double priorBranch       = decodePrior(solution, branchesBegin, branches);
+
+		for (const Point& point : grid)
+			if (point.priors.priorEnd          == priorEnd &&
+			    point.priors.priorContinuation == priorContinuation &&
+			    point.priors.priorBranch       == priorBranch)
+				return getValue(point, numLines);
+
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"the solution does not belong to any grid point");
+	});
+
+	gridSearch->setInput("segments", segments);
+	gridSearch->setInput("linear constraints", boost::make_shared<LinearConstraints>());
+	gridSearch->addInput("cost functions", costFunction);
+	gridSearch->setInput("membranes", createMembranes(3));
+
+	pipeline::Value<PriorCostFunctionParameters> priors = gridSearch->getOutput("prior cost parameters");
+
+	results      = gridSearch->getResults();
+	best         = *priors;
+	numEvaluated = numCalls;
+}
+
+/**
+ * Check that the search evaluated exactly the given points and found their
+ * scripted values.
+ */
+void
+checkResults(
+		const std::string&                             name,
+		const std::vector<Point>&                      grid,
+		unsigned int                                   numLines,
+		const std::vector<ParallelGridSearch::Result>& results,
+		unsigned int                                   numEvaluated,
+		const std::vector<bool>&                       pruned) {
+
+	unsigned int expectedEvaluated = 0;
+
+	for (unsigned int i = 0; i < grid.size(); i++) {
+
+		if (results[i].pruned != pruned[i])
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": point " << i << " was " << (results[i].pruned ? "" : "not ") << "pruned");
+
+		if (pruned[i])
+			continue;
+
+		expectedEvaluated++;
+
+		if (results[i].value != getValue(grid[i], numLines))
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					name << ": point " << i << " has value " << results[i].value << ", expected "
+					<< getValue(grid[i], numLines));
+	}
+
+	if (numEvaluated != expectedEvaluated)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": evaluated " << numEvaluated << " points, expected " << expectedEvaluated);
+}
+
+void
+checkBest(const std::string& name, const PriorCostFunctionParameters& best, const Point& expected) {
+
+	if (best.priorEnd          != expected.priors.priorEnd ||
+	    best.priorContinuation != expected.priors.priorContinuation ||
+	    best.priorBranch       != expected.priors.priorBranch)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": best priors differ from the minimum of the scripted values");
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		std::vector<Point> grid     = getGrid();
+		unsigned int       numLines = grid.back().line + 1;
+
+		// the minimum of the scripted values, the first one on ties
+		unsigned int minimum = 0;
+		for (unsigned int i = 0; i < grid.size(); i++)
+			if (getValue(grid[i], numLines) < getValue(grid[minimum], numLines))
+				minimum = i;
+
+		std::cout << "Grid has " << grid.size() << " points in " << numLines << " lines." << std::endl;
+
+		std::vector<ParallelGridSearch::Result> results;
+		PriorCostFunctionParameters             best;
+		unsigned int                            numEvaluated;
+
+		// without pruning, all points are evaluated
+
+		search(-1, 1, grid, numLines, results, best, numEvaluated);
+		checkResults("without pruning", grid, numLines, results, numEvaluated, std::vector<bool>(grid.size(), false));
+		checkBest("without pruning", best, grid[minimum]);
+
+		std::cout << "Without pruning, all points were evaluated." << std::endl;
+
+		// with pruning, the evaluated points follow the rule
+
+		std::vector<unsigned int> evaluated;
+		std::vector<bool>         pruned;
+		simulatePruning(grid, numLines, evaluated, pruned);
+
+		if (evaluated.size() == grid.size())
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"the scripted values do not lead to any pruning");
+
+		search(PruneMargin, 1, grid, numLines, results, best, numEvaluated);
+		checkResults("with pruning", grid, numLines, results, numEvaluated, pruned);
+		checkBest("with pruning", best, grid[minimum]);
+
+		std::cout
+				<< "With pruning, " << (grid.size() - evaluated.size()) << " points were skipped "
+				<< "and the best point was found." << std::endl;
+
+		// with several threads, the same points are pruned, repeat to catch
+		// different orders of the lines
+
+		for (unsigned int run = 0; run < 10; run++) {
+
+			search(PruneMargin, NumThreads, grid, numLines, results, best, numEvaluated);
+			checkResults("with threads", grid, numLines, results, numEvaluated, pruned);
+			checkBest("with threads", best, grid[minimum]);
+		}
+
+		std::cout << "With " << NumThreads << " threads, the same points were pruned." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -158,6 +158,23 @@ int main(int argc, char** argv)
 		boost::shared_ptr<SegmentDescriptions> retrievedSegments =
 				segmentStore.getSegmentsByBlocks(blocks, missingBlocks, false);
 
+		// the counts agree with what was read
+		unsigned int numConflictSets;
+		if (!sliceStore.getNumConflictSets(block, numConflictSets) ||
+		    numConflictSets != retrievedConflictSets->size())
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"conflict set count differs from the retrieved conflict sets");
+
+		unsigned int numSegments, numBranchSegments, numSlices;
+		if (!segmentStore.getSegmentCounts(block, numSegments, numBranchSegments, numSlices) ||
+		    numSegments != retrievedSegments->size() ||
+		    numBranchSegments != 0 ||
+		    numSlices != 2)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"segment counts differ from the retrieved segments");
+
 	} catch (boost::exception& e) {
 
 		handleException(e, std::cerr);
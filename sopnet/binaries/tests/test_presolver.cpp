@@ -0,0 +1,173 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <blockwise/ilp/Presolver.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "ReferenceSolvers.h"
+#include "SyntheticStack.h"
+
+LinearConstraint
+createConstraint(
+		const std::vector<std::pair<unsigned int, double> >& coefficients,
+		Relation                                             relation,
+		double                                               value) {
+
+	LinearConstraint constraint;
+	for (const auto& pair : coefficients)
+		constraint.setCoefficient(pair.first, pair.second);
+	constraint.setRelation(relation);
+	constraint.setValue(value);
+
+	return constraint;
+}
+
+void
+checkCount(const std::string& name, unsigned int count, unsigned int expected) {
+
+	if (count != expected)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << " is " << count << ", expected " << expected);
+}
+
+/**
+ * Solve the reduced problem with the given solver, expand the solution, and
+ * compare it to the solution of the original problem.
+ */
+template <typename Solve>
+void
+checkExpanded(
+		const std::string&         name,
+		const Presolver&           presolver,
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		Solve                      solve) {
+
+	std::vector<double> original = solve(costs, constraints);
+	std::vector<double> expanded = presolver.expand(solve(presolver.getReducedCosts(), presolver.getReducedConstraints()));
+
+	if (!isFeasible(constraints, expanded))
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": expanded solution is not feasible");
+
+	if (std::abs(getCost(costs, expanded) - getCost(costs, original)) > 1e-6)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				name << ": expanded solution has cost " << getCost(costs, expanded)
+				<< ", the original problem " << getCost(costs, original));
+
+	std::cout << name << ": reduced problem has the same optimum " << getCost(costs, original) << std::endl;
+}
+
+/**
+ * A problem in which every reduction applies once:
+ *
+ * - x0 = 1 fixes x0 to 1,
+ * - x0 + x1 <= 1 (given twice) fixes x1 to 0, although its cost is negative,
+ * - x2 + x3 <= 1 fixes the dominated x2 (positive cost) to 0, then x3 is free
+ *   of active constraints and is fixed to 1 by its negative cost,
+ * - x4 + x5 + x6 = 1 stays.
+ */
+void
+testReductions() {
+
+	std::vector<double> costs = { 1.0, -3.0, 0.5, -1.0, -1.0, -2.0, -1.5 };
+
+	LinearConstraints constraints;
+	constraints.add(createConstraint({{0, 1.0}}, Equal, 1.0));
+	constraints.add(createConstraint({{0, 1.0}, {1, 1.0}}, LessEqual, 1.0));
+	constraints.add(createConstraint({{0, 1.0}, {1, 1.0}}, LessEqual, 1.0));
+	constraints.add(createConstraint({{2, 1.0}, {3, 1.0}}, LessEqual, 1.0));
+	constraints.add(createConstraint({{4, 1.0}, {5, 1.0}, {6, 1.0}}, Equal, 1.0));
+
+	Presolver presolver(costs, constraints);
+
+	if (presolver.isInfeasible())
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"feasible problem was found to be infeasible");
+
+	checkCount("number of fixed variables", presolver.getNumFixedVariables(), 4);
+	checkCount("number of removed constraints", presolver.getNumRemovedConstraints(), 4);
+	checkCount("number of free variables", presolver.getReducedCosts().size(), 3);
+	checkCount("number of reduced constraints", presolver.getReducedConstraints().size(), 1);
+
+	// the fixed values show up in the expansion of any reduced solution
+	std::vector<double> values = presolver.expand(std::vector<double>(3, 0.0));
+	std::vector<double> fixed  = { 1.0, 0.0, 0.0, 1.0 };
+
+	for (unsigned int var = 0; var < fixed.size(); var++)
+		if (values[var] != fixed[var])
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"x" << var << " was fixed to " << values[var] << ", expected " << fixed[var]);
+
+	checkExpanded("reductions", presolver, costs, constraints, solveBruteForce);
+}
+
+/**
+ * x0 = 1 contradicts x0 <= 0.
+ */
+void
+testInfeasible() {
+
+	std::vector<double> costs = { -1.0, -1.0 };
+
+	LinearConstraints constraints;
+	constraints.add(createConstraint({{0, 1.0}}, Equal, 1.0));
+	constraints.add(createConstraint({{0, 1.0}}, LessEqual, 0.0));
+	constraints.add(createConstraint({{0, 1.0}, {1, 1.0}}, LessEqual, 1.0));
+
+	Presolver presolver(costs, constraints);
+
+	if (!presolver.isInfeasible())
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"infeasible problem was not recognized");
+
+	std::cout << "infeasible: recognized" << std::endl;
+}
+
+/**
+ * The synthetic stack, compared to a monolithic solve.
+ */
+void
+testSyntheticStack() {
+
+	SyntheticStack stack(6, 4);
+
+	std::vector<double> costs = stack.objective->getCoefficients();
+
+	Presolver presolver(costs, *stack.constraints);
+
+	if (presolver.isInfeasible())
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"synthetic stack was found to be infeasible");
+
+	checkExpanded("synthetic stack", presolver, costs, *stack.constraints, solveMonolithic);
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		testReductions();
+		testInfeasible();
+		testSyntheticStack();
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <iostream>
+
+#include <inference/Problems.h>
+#include <inference/ProblemsSolver.h>
+#include <inference/Solutions.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "SyntheticStack.h"
+
+const unsigned int NumSections        = 12;
+const unsigned int SegmentsPerSection = 4;
+const unsigned int Size               = 5;
+const unsigned int Overlap            = 2;
+
+/**
+ * The first section of each overlapping problem of the synthetic stack.
+ */
+std::vector<unsigned int>
+getStarts() {
+
+	std::vector<unsigned int> starts;
+	for (unsigned int start = 0; start + Overlap < NumSections; start += Size - Overlap)
+		starts.push_back(start);
+
+	return starts;
+}
+
+/**
+ * Decompose the synthetic stack into overlapping problems of Size sections. 
+ * The variables of each problem are numbered from 0, constraints are kept if 
+ * all their variables are part of the problem.
+ */
+boost::shared_ptr<Problems>
+createProblems(const SyntheticStack& stack) {
+
+	boost::shared_ptr<Problems> problems = boost::make_shared<Problems>();
+
+	for (unsigned int start : getStarts()) {
+
+		unsigned int end   = std::min(start + Size, NumSections);
+		unsigned int first = start*SegmentsPerSection;
+		unsigned int last  = end*SegmentsPerSection;
+
+		boost::shared_ptr<Problem> problem = boost::make_shared<Problem>(last - first);
+
+		for (unsigned int var = first; var < last; var++) {
+
+			EndSegment segment(1000 + 3*var, Right, createSlice(var, var/SegmentsPerSection));
+			problem->getConfiguration()->setVariable(segment, var - first);
+			problem->getObjective()->setCoefficient(var - first, stack.objective->getCoefficients()[var]);
+		}
+
+		for (const LinearConstraint& constraint : *stack.constraints) {
+
+			bool contained = true;
+			for (const auto& pair : constraint.getCoefficients())
+				if (pair.first < first || pair.first >= last)
+					contained = false;
+
+			if (!contained)
+				continue;
+
+			LinearConstraint local;
+			for (const auto& pair : constraint.getCoefficients())
+				local.setCoefficient(pair.first - first, pair.second);
+			local.setRelation(constraint.getRelation());
+			local.setValue(constraint.getValue());
+
+			problem->getLinearConstraints()->add(local);
+		}
+
+		problems->addProblem(problem);
+	}
+
+	return problems;
+}
+
+/**
+ * The problem that owns a variable: the one whose boundary is the farthest 
+ * from the section of the variable, the earlier one on ties.
+ */
+unsigned int
+getOwner(unsigned int var) {
+
+	std::vector<unsigned int> starts = getStarts();
+
+	unsigned int section = var/SegmentsPerSection;
+	unsigned int owner   = 0;
+	int          best    = -1;
+
+	for (unsigned int i = 0; i < starts.size(); i++) {
+
+		unsigned int end = std::min(starts[i] + Size, NumSections);
+
+		if (section < starts[i] || section >= end)
+			continue;
+
+		int depth = std::min(section - starts[i], end - 1 - section);
+
+		if (depth > best) {
+
+			best  = depth;
+			owner = i;
+		}
+	}
+
+	return owner;
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		std::cout << "Creating synthetic problems..." << std::endl;
+
+		SyntheticStack stack(NumSections, SegmentsPerSection);
+
+		boost::shared_ptr<Problems> problems = createProblems(stack);
+
+		std::vector<double> reference;
+		unsigned int        referenceDisagreements = 0;
+
+		for (unsigned int numThreads : {1, 2, 4, 0}) {
+
+			std::cout << "Solving " << problems->size() << " problems with " << numThreads << " threads..." << std::endl;
+
+			pipeline::Process<ProblemsSolver> solver;
+			solver->setNumThreads(numThreads);
+			solver->setInput("problems", problems);
+			solver->setInput("problem configuration", stack.configuration);
+
+			pipeline::Value<Solution>  solution  = solver->getOutput("solution");
+			pipeline::Value<Solutions> solutions = solver->getOutput("solutions");
+
+			// every variable is taken from its owner
+			for (unsigned int var = 0; var < solution->size(); var++) {
+
+				unsigned int owner = getOwner(var);
+				unsigned int start = getStarts()[owner];
+
+				if ((*solution)[var] != (*solutions->getSolution(owner))[var - start*SegmentsPerSection])
+					UTIL_THROW_EXCEPTION(
+							Exception,
+							"variable " << var << " was not taken from problem " << owner);
+			}
+
+			if (numThreads == 1) {
+
+				for (unsigned int var = 0; var < solution->size(); var++)
+					reference.push_back((*solution)[var]);
+				referenceDisagreements = solver->getNumDisagreements();
+
+				std::cout << "The problems disagree on " << referenceDisagreements << " variables." << std::endl;
+				continue;
+			}
+
+			if (solution->size() != reference.size())
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"solution has " << solution->size() << " variables, expected " << reference.size());
+
+			for (unsigned int var = 0; var < reference.size(); var++)
+				if ((*solution)[var] != reference[var])
+					UTIL_THROW_EXCEPTION(
+							Exception,
+							"variable " << var << " differs from the solution with one thread");
+
+			if (solver->getNumDisagreements() != referenceDisagreements)
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"number of disagreements differs from the solution with one thread");
+		}
+
+		std::cout << "Solutions are identical for all numbers of threads." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <sstream>
+
+#include <inference/ProblemConfiguration.h>
+#include <inference/Subproblems.h>
+#include <inference/SubproblemsExtractor.h>
+#include <inference/io/SubproblemsReader.h>
+#include <inference/io/SubproblemsWriter.h>
+#include <pipeline/Process.h>
+#include <pipeline/Value.h>
+#include <solvers/LinearConstraints.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "SyntheticStack.h"
+
+/**
+ * Render subproblems as text, one line per variable and constraint with the
+ * subproblems it is assigned to.
+ */
+std::string
+toText(Subproblems& subproblems) {
+
+	std::stringstream text;
+
+	boost::shared_ptr<Problem> problem = subproblems.getProblem();
+
+	for (const auto& pair : subproblems.getVariablesSubproblems()) {
+
+		text << "variable " << pair.first
+		     << " segment " << problem->getConfiguration()->getSegmentId(pair.first)
+		     << " cost " << problem->getObjective()->getCoefficients()[pair.first]
+		     << " subproblems";
+
+		for (unsigned int subproblem : pair.second)
+			text << " " << subproblem;
+
+		text << std::endl;
+	}
+
+	for (const auto& pair : subproblems.getConstraintsSubproblems()) {
+
+		const LinearConstraint& constraint = (*problem->getLinearConstraints())[pair.first];
+
+		text << "constraint " << pair.first << " relation " << constraint.getRelation()
+		     << " value " << constraint.getValue() << " coefficients";
+
+		for (const auto& coefficient : constraint.getCoefficients())
+			text << " " << coefficient.first << ":" << coefficient.second;
+
+		text << " subproblems";
+
+		for (unsigned int subproblem : pair.second)
+			text << " " << subproblem;
+
+		text << std::endl;
+	}
+
+	return text.str();
+}
+
+int main(int argc, char** argv) {
+
+	try {
+
+		util::ProgramOptions::init(argc, argv);
+		logger::LogManager::init();
+
+		unsigned int numSections        = 20;
+		unsigned int segmentsPerSection = 10;
+
+		std::cout << "Creating synthetic problem..." << std::endl;
+
+		SyntheticStack stack(numSections, segmentsPerSection);
+
+		pipeline::Process<SubproblemsExtractor> extractor;
+		extractor->setSubproblemsSize(5, 2);
+		extractor->setInput("objective", stack.objective);
+		extractor->setInput("linear constraints", stack.constraints);
+		extractor->setInput("problem configuration", stack.configuration);
+
+		pipeline::Value<Subproblems> original = extractor->getOutput("subproblems");
+
+		std::string expected = toText(*original);
+
+		for (bool singlePrecision : {false, true}) {
+
+			const std::string TEST_FILENAME = "test_subproblems.bin";
+
+			std::cout << "Writing subproblems in " << (singlePrecision ? "single" : "double") << " precision..." << std::endl;
+
+			boost::shared_ptr<SubproblemsWriter> writer = boost::make_shared<SubproblemsWriter>(TEST_FILENAME, singlePrecision);
+			writer->setInput("subproblems", extractor->getOutput("subproblems"));
+			writer->write();
+
+			std::cout << "Reading subproblems..." << std::endl;
+
+			boost::shared_ptr<SubproblemsReader> reader = boost::make_shared<SubproblemsReader>(TEST_FILENAME);
+			pipeline::Value<Subproblems> recovered = reader->getOutput("subproblems");
+
+			if (toText(*recovered) != expected) {
+
+				std::cout << "expected:" << std::endl << expected << std::endl;
+				std::cout << "got:" << std::endl << toText(*recovered) << std::endl;
+
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"Subproblems differ.");
+			}
+		}
+
+		std::cout << "Streaming subproblems from the extractor..." << std::endl;
+
+		{
+			const std::string TEST_FILENAME = "test_subproblems_streamed.bin";
+
+			pipeline::Process<SubproblemsExtractor> streamingExtractor;
+			streamingExtractor->setSubproblemsSize(5, 2);
+			streamingExtractor->setInput("objective", stack.objective);
+			streamingExtractor->setInput("linear constraints", stack.constraints);
+			streamingExtractor->setInput("problem configuration", stack.configuration);
+
+			boost::shared_ptr<SubproblemsWriter> writer = boost::make_shared<SubproblemsWriter>(TEST_FILENAME);
+			streamingExtractor->writeSubproblems(*writer);
+
+			boost::shared_ptr<SubproblemsReader> reader = boost::make_shared<SubproblemsReader>(TEST_FILENAME);
+			pipeline::Value<Subproblems> recovered = reader->getOutput("subproblems");
+
+			if (toText(*recovered) != expected) {
+
+				std::cout << "expected:" << std::endl << expected << std::endl;
+				std::cout << "got:" << std::endl << toText(*recovered) << std::endl;
+
+				UTIL_THROW_EXCEPTION(
+						Exception,
+						"Streamed subproblems differ.");
+			}
+		}
+
+		std::cout << "Subproblems are identical." << std::endl;
+
+	} catch (boost::exception& e) {
+
+		handleException(e, std::cerr);
+		return 1;
+	}
+
+	return 0;
+}
@@ -95,6 +95,26 @@ BlockUtils::getCoreAtLocation(const util::point<unsigned int, 3>& location) cons
 	return Core(location/_coreSizeInVoxels);
 }
 
+Cores
+BlockUtils::getCoresInBox(const util::box<unsigned int, 3>& box) const {
+
+	Cores cores;
+
+	if (box.volume() == 0)
+		return cores;
+
+	util::point<unsigned int, 3> minCoreCoordinate = box.min()/_coreSizeInVoxels;
+	util::point<unsigned int, 3> maxCoreCoordinate = (box.max() + _coreSizeInVoxels - util::point<unsigned int, 3>(1, 1, 1))/_coreSizeInVoxels;
+
+	for (unsigned int x = minCoreCoordinate.x(); x < maxCoreCoordinate.x(); x++)
+	for (unsigned int y = minCoreCoordinate.y(); y < maxCoreCoordinate.y(); y++)
+	for (unsigned int z = minCoreCoordinate.z(); z < maxCoreCoordinate.z(); z++)
+		if (isValidCoreCoordinate(x, y, z))
+			cores.add(Core(x, y, z));
+
+	return cores;
+}
+
 Blocks
 BlockUtils::getCoreBlocks(const Core& core) const {
 
@@ -183,3 +203,9 @@ BlockUtils::isValidBlockCoordinate(int x, int y, int z) const {
 
 	return _validBlockCoordinates.contains(util::point<int, 3>(x, y, z));
 }
+
+bool
+BlockUtils::isValidCoreCoordinate(int x, int y, int z) const {
+
+	return _validCoreCoordinates.contains(util::point<int, 3>(x, y, z));
+}
@@ -67,6 +67,11 @@ public:
 	 */
 	Core getCoreAtLocation(const util::point<unsigned int, 3>& location) const;
 
+	/**
+	 * Get all cores that intersect the given bounding box.
+	 */
+	Cores getCoresInBox(const util::box<unsigned int, 3>& box) const;
+
 	/**
 	 * Get all the blocks that constitute the gicen core.
 	 */
@@ -101,6 +106,9 @@ private:
 	// check whether the given coordinates correspond to a block in the stack
 	bool isValidBlockCoordinate(int x, int y, int z) const;
 
+	// check whether the given coordinates correspond to a core in the stack
+	bool isValidCoreCoordinate(int x, int y, int z) const;
+
 	// the size of the whole volume
 	const util::point<unsigned int, 3>& _volumeSize;
 
@@ -34,6 +34,11 @@ public:
 		return _coordinates < other._coordinates;
 	}
 
+	bool operator==(const Core& other) const {
+
+		return x() == other.x() && y() == other.y() && z() == other.z();
+	}
+
 private:
 
 	util::point<unsigned int, 3> _coordinates;
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+
+#include <util/Logger.h>
+#include "CoreCostEstimator.h"
+
+logger::LogChannel corecostestimatorlog("corecostestimatorlog", "[CoreCostEstimator] ");
+
+// the number of samples needed to fit the time model
+static const unsigned int MinTimeModelSamples = 5;
+
+// the solve time per variable assumed without any samples
+static const double NominalSecondsPerVariable = 1e-5;
+
+// solve times are clamped to this for the logarithm
+static const double MinSeconds = 1e-3;
+
+// the number of blocks to remember the counts of
+static const unsigned int MaxCachedBlocks = 4096;
+
+CoreCostEstimator::Counts&
+CoreCostEstimator::Counts::operator+=(const Counts& other) {
+
+	segments       += other.segments;
+	slices         += other.slices;
+	branchSegments += other.branchSegments;
+	conflictSets   += other.conflictSets;
+
+	return *this;
+}
+
+CoreCostEstimator::CoreCostEstimator(
+		const ProjectConfiguration&     projectConfiguration,
+		boost::shared_ptr<SegmentStore> segmentStore,
+		boost::shared_ptr<SliceStore>   sliceStore,
+		unsigned int                    corePadding) :
+	_segmentStore(segmentStore),
+	_sliceStore(sliceStore),
+	_corePadding(corePadding),
+	_variablesPerSegment(1.0),
+	_constraintsPerTerm(1.0),
+	_secondsPerVariable(NominalSecondsPerVariable),
+	_blockUtils(projectConfiguration) {}
+
+CoreCostEstimator::Estimate
+CoreCostEstimator::estimate(const Core& core) {
+
+	Counts counts = getCoreCounts(core);
+
+	Estimate estimate;
+
+	// one variable per segment, one overlap constraint per conflict set and
+	// about one continuation constraint per slice
+	estimate.numVariables   = _variablesPerSegment*counts.segments;
+	estimate.numConstraints = _constraintsPerTerm*(counts.conflictSets + counts.slices);
+	estimate.branchRatio    = getBranchRatio(counts);
+
+	if (_timeModel.empty())
+		estimate.seconds = _secondsPerVariable*estimate.numVariables;
+	else
+		estimate.seconds = std::exp(
+				_timeModel[0] +
+				_timeModel[1]*std::log(std::max(estimate.numVariables, 1.0)) +
+				_timeModel[2]*estimate.branchRatio);
+
+	LOG_DEBUG(corecostestimatorlog)
+			<< "core (" << core.x() << ", " << core.y() << ", " << core.z()
+			<< ") has about " << estimate.numVariables << " variables and "
+			<< estimate.numConstraints << " constraints, estimated solve time is "
+			<< estimate.seconds << "s" << std::endl;
+
+	return estimate;
+}
+
+void
+CoreCostEstimator::addSample(const Core& core, const SolutionGuarantor::SolveStatistics& statistics) {
+
+	Sample sample;
+	sample.counts         = getCoreCounts(core);
+	sample.numVariables   = statistics.numVariables;
+	sample.numConstraints = statistics.numConstraints;
+	sample.seconds        = statistics.seconds;
+
+	_samples.push_back(sample);
+
+	calibrate();
+}
+
+SolutionScheduler::CostEstimator
+CoreCostEstimator::getCostEstimator() {
+
+	return [this](const Core& core) { return estimate(core).seconds; };
+}
+
+CoreCostEstimator::Counts
+CoreCostEstimator::getCoreCounts(const Core& core) {
+
+	Blocks blocks = _blockUtils.getCoreBlocks(core);
+
+	_blockUtils.expand(
+			blocks,
+			_corePadding, _corePadding, _corePadding,
+			_corePadding, _corePadding, _corePadding);
+
+	Counts counts;
+	for (const Block& block : blocks)
+		counts += getBlockCounts(block);
+
+	return counts;
+}
+
+CoreCostEstimator::Counts
+CoreCostEstimator::getBlockCounts(const Block& block) {
+
+	std::map<Block, CachedCounts>::iterator i = _blockCounts.find(block);
+
+	if (i != _blockCounts.end()) {
+
+		_blockOrder.splice(_blockOrder.begin(), _blockOrder, i->second.position);
+		return i->second.counts;
+	}
+
+	Counts counts;
+
+	unsigned int numSegments       = 0;
+	unsigned int numBranchSegments = 0;
+	unsigned int numSlices         = 0;
+	unsigned int numConflictSets   = 0;
+
+	bool extracted = _segmentStore->getSegmentCounts(block, numSegments, numBranchSegments, numSlices);
+	extracted = _sliceStore->getNumConflictSets(block, numConflictSets) && extracted;
+
+	counts.segments       = numSegments;
+	counts.branchSegments = numBranchSegments;
+	counts.slices         = numSlices;
+	counts.conflictSets   = numConflictSets;
+
+	// don't remember blocks that were not extracted yet
+	if (!extracted)
+		return counts;
+
+	if (_blockCounts.size() >= MaxCachedBlocks) {
+
+		_blockCounts.erase(_blockOrder.back());
+		_blockOrder.pop_back();
+	}
+
+	_blockOrder.push_front(block);
+
+	CachedCounts& cached = _blockCounts[block];
+	cached.counts   = counts;
+	cached.position = _blockOrder.begin();
+
+	return counts;
+}
+
+void
+CoreCostEstimator::clearCache() {
+
+	_blockCounts.clear();
+	_blockOrder.clear();
+}
+
+void
+CoreCostEstimator::calibrate() {
+
+	double segments     = 0;
+	double terms        = 0;
+	double variables    = 0;
+	double constraints  = 0;
+	double seconds      = 0;
+
+	for (const Sample& sample : _samples) {
+
+		segments    += sample.counts.segments;
+		terms       += sample.counts.conflictSets + sample.counts.slices;
+		variables   += sample.numVariables;
+		constraints += sample.numConstraints;
+		seconds     += sample.seconds;
+	}
+
+	if (segments > 0)
+		_variablesPerSegment = variables/segments;
+	if (terms > 0)
+		_constraintsPerTerm = constraints/terms;
+	if (variables > 0)
+		_secondsPerVariable = seconds/variables;
+
+	if (_samples.size() < MinTimeModelSamples)
+		return;
+
+	// least squares fit of the time model via the normal equations, with a
+	// small ridge to keep them solvable for degenerate samples
+
+	const unsigned int n = 3;
+	double a[n][n + 1] = {};
+
+	for (const Sample& sample : _samples) {
+
+		double x[n] = {
+				1.0,
+				std::log(std::max(sample.numVariables, 1.0)),
+				getBranchRatio(sample.counts)
+		};
+		double y = std::log(std::max(sample.seconds, MinSeconds));
+
+		for (unsigned int i = 0; i < n; i++) {
+
+			for (unsigned int j = 0; j < n; j++)
+				a[i][j] += x[i]*x[j];
+
+			a[i][n] += x[i]*y;
+		}
+	}
+
+	for (unsigned int i = 0; i < n; i++)
+		a[i][i] += 1e-6;
+
+	// Gaussian elimination with partial pivoting
+	for (unsigned int col = 0; col < n; col++) {
+
+		unsigned int pivot = col;
+		for (unsigned int row = col + 1; row < n; row++)
+			if (std::abs(a[row][col]) > std::abs(a[pivot][col]))
+				pivot = row;
+
+		for (unsigned int j = 0; j <= n; j++)
+			std::swap(a[col][j], a[pivot][j]);
+
+		for (unsigned int row = 0; row < n; row++) {
+
+			if (row == col)
+				continue;
+
+			double factor = a[row][col]/a[col][col];
+			for (unsigned int j = col; j <= n; j++)
+				a[row][j] -= factor*a[col][j];
+		}
+	}
+
+	_timeModel.resize(n);
+	for (unsigned int i = 0; i < n; i++)
+		_timeModel[i] = a[i][n]/a[i][i];
+
+	LOG_DEBUG(corecostestimatorlog)
+			<< "calibrated with " << _samples.size() << " samples: "
+			<< _variablesPerSegment << " variables per segment, "
+			<< _constraintsPerTerm << " constraints per conflict set and slice, "
+			<< "log(seconds) = " << _timeModel[0] << " + " << _timeModel[1]
+			<< "*log(variables) + " << _timeModel[2] << "*branchRatio"
+			<< std::endl;
+}
+
+double
+CoreCostEstimator::getBranchRatio(const Counts& counts) {
+
+	if (counts.segments == 0)
+		return 0;
+
+	return counts.branchSegments/counts.segments;
+}
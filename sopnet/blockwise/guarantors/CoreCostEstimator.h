@@ -0,0 +1,166 @@
+#ifndef SOPNET_BLOCKWISE_GUARANTORS_CORE_COST_ESTIMATOR_H__
+#define SOPNET_BLOCKWISE_GUARANTORS_CORE_COST_ESTIMATOR_H__
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <blockwise/ProjectConfiguration.h>
+#include <blockwise/blocks/BlockUtils.h>
+#include <blockwise/blocks/Core.h>
+#include <blockwise/persistence/SegmentStore.h>
+#include <blockwise/persistence/SliceStore.h>
+#include "SolutionGuarantor.h"
+#include "SolutionScheduler.h"
+
+/**
+ * Predicts the size of the ILP of a core and the time to solve it, before
+ * solving it. The prediction is based on counts of segments, slices, branch
+ * segments, and conflict sets of each block in the padded core, which are
+ * counted by the stores and cached for the most recently used blocks.
+ *
+ * The estimator is calibrated with the statistics the guarantors record for
+ * solved cores (see SolutionGuarantor::getSolveStatistics()). The number of
+ * variables and constraints is predicted by the ratio to the block counts
+ * observed so far. The solve time is a least-squares fit of
+ *
+ *   log(seconds) = w0 + w1*log(variables) + w2*branchRatio,
+ *
+ * once enough samples are available, and proportional to the number of
+ * variables before.
+ */
+class CoreCostEstimator {
+
+public:
+
+	struct Estimate {
+
+		Estimate() :
+			numVariables(0),
+			numConstraints(0),
+			branchRatio(0),
+			seconds(0) {}
+
+		double numVariables;
+		double numConstraints;
+
+		// the fraction of segments that are branches
+		double branchRatio;
+
+		double seconds;
+	};
+
+	/**
+	 * Create an estimator for cores with the given (maximal) padding in
+	 * blocks.
+	 */
+	CoreCostEstimator(
+			const ProjectConfiguration&     projectConfiguration,
+			boost::shared_ptr<SegmentStore> segmentStore,
+			boost::shared_ptr<SliceStore>   sliceStore,
+			unsigned int                    corePadding);
+
+	/**
+	 * Estimate the size and solve time of a core.
+	 */
+	Estimate estimate(const Core& core);
+
+	/**
+	 * Add the recorded statistics of a solved core to the calibration.
+	 */
+	void addSample(const Core& core, const SolutionGuarantor::SolveStatistics& statistics);
+
+	/**
+	 * Get the number of samples the estimator is calibrated with.
+	 */
+	unsigned int getNumSamples() const { return _samples.size(); }
+
+	/**
+	 * Get a cost estimator for SolutionScheduler, which orders cores by their
+	 * estimated solve time. The estimator has to outlive the scheduler.
+	 */
+	SolutionScheduler::CostEstimator getCostEstimator();
+
+	/**
+	 * Forget the cached block counts, such that they are read again from the
+	 * stores. Call this when the extracted segments or slices might have
+	 * changed.
+	 */
+	void clearCache();
+
+private:
+
+	// counts of the segments, slices, and conflict sets of a block or a
+	// padded core
+	struct Counts {
+
+		Counts() :
+			segments(0),
+			slices(0),
+			branchSegments(0),
+			conflictSets(0) {}
+
+		Counts& operator+=(const Counts& other);
+
+		double segments;
+		double slices;
+		double branchSegments;
+		double conflictSets;
+	};
+
+	// the counts of a block and its position in the recently used list
+	struct CachedCounts {
+
+		Counts counts;
+
+		std::list<Block>::iterator position;
+	};
+
+	struct Sample {
+
+		Counts counts;
+
+		double numVariables;
+		double numConstraints;
+		double seconds;
+	};
+
+	Counts getCoreCounts(const Core& core);
+
+	Counts getBlockCounts(const Block& block);
+
+	// update the ratios and the time model from the samples
+	void calibrate();
+
+	static double getBranchRatio(const Counts& counts);
+
+	boost::shared_ptr<SegmentStore> _segmentStore;
+	boost::shared_ptr<SliceStore>   _sliceStore;
+
+	unsigned int _corePadding;
+
+	std::map<Block, CachedCounts> _blockCounts;
+
+	// the cached blocks, most recently used first
+	std::list<Block> _blockOrder;
+
+	std::vector<Sample> _samples;
+
+	// segments on block boundaries are counted for each block, these correct
+	// for that
+	double _variablesPerSegment;
+	double _constraintsPerTerm;
+
+	// solve time per variable, used until the time model is fit
+	double _secondsPerVariable;
+
+	// the weights of the time model, empty if not fit yet
+	std::vector<double> _timeModel;
+
+	BlockUtils _blockUtils;
+};
+
+#endif // SOPNET_BLOCKWISE_GUARANTORS_CORE_COST_ESTIMATOR_H__
+
@@ -85,7 +85,8 @@ GroundTruthGuarantor::guaranteeGroundTruth(const Core& core) {
 
 		SegmentDescription segmentDescription(*segment);
 
-		segmentDescription.setFeatures(features->get(segment->getId()));
+		Features::row_type segmentFeatures = features->get(segment->getId());
+		segmentDescription.setFeatures(segmentFeatures.begin(), segmentFeatures.end());
 
 		segmentDescriptions.add(segmentDescription);
 	}
@@ -15,7 +15,10 @@ SegmentGuarantor::SegmentGuarantor(
 	_segmentStore(segmentStore),
 	_sliceStore(sliceStore),
 	_rawStackStore(rawStackStore),
-	_blockUtils(projectConfiguration) {}
+	_blockUtils(projectConfiguration),
+	_numFeatureThreads(0),
+	_numFeatureThreadsSet(false),
+	_skipZeroWeightFeatures(false) {}
 
 Blocks
 SegmentGuarantor::guaranteeSegments(const Blocks& requestedBlocks) {
@@ -84,7 +87,11 @@ SegmentGuarantor::guaranteeSegments(const Blocks& requestedBlocks) {
 	segments = discardNonRequestedSegments(segments, requestedBlocks);
 
 	// compute the features for all extracted segments
-	boost::shared_ptr<Features> features = computeFeatures(segments);
+	std::vector<bool> activeFeatures;
+	if (_skipZeroWeightFeatures)
+		activeFeatures = getActiveFeatures();
+
+	boost::shared_ptr<Features> features = computeFeatures(segments, activeFeatures);
 
 	writeSegmentsAndFeatures(*segments, *features, requestedBlocks);
 
@@ -229,7 +236,8 @@ SegmentGuarantor::getSegmentDescriptions(
 		SegmentDescription segmentDescription(*segment);
 
 		// add features
-		segmentDescription.setFeatures(features.get(segment->getId()));
+		Features::const_row_type segmentFeatures = features.get(segment->getId());
+		segmentDescription.setFeatures(segmentFeatures.begin(), segmentFeatures.end());
 
 		// add to collection of segment descriptions for current block
 		segmentDescriptions.add(segmentDescription);
@@ -331,7 +339,9 @@ SegmentGuarantor::slicesBoundingBox(const Slices& slices)
 }
 
 boost::shared_ptr<Features>
-SegmentGuarantor::computeFeatures(boost::shared_ptr<Segments> segments)
+SegmentGuarantor::computeFeatures(
+		boost::shared_ptr<Segments> segments,
+		const std::vector<bool>&    activeFeatures)
 {
 	util::box<unsigned int, 3> box = segments->boundingBox();
 	Blocks blocks = _blockUtils.getBlocksInBox(box);
@@ -347,6 +357,11 @@ SegmentGuarantor::computeFeatures(boost::shared_ptr<Segments> segments)
 			<< "Extracting features for " << segments->size()
 			<< " segments" << std::endl;
 
+	if (_numFeatureThreadsSet)
+		featuresExtractor->setNumThreads(_numFeatureThreads);
+
+	featuresExtractor->setActiveFeatures(activeFeatures);
+
 	featuresExtractor->setInput("segments", segments);
 	featuresExtractor->setInput("raw sections", _rawStackStore->getImageStack(blocksBoundingBox));
 	featuresExtractor->setInput("crop offset", offset);
@@ -358,3 +373,24 @@ SegmentGuarantor::computeFeatures(boost::shared_ptr<Segments> segments)
 	return features;
 }
 
+std::vector<bool>
+SegmentGuarantor::getActiveFeatures() {
+
+	std::vector<double> weights = _segmentStore->getFeatureWeights();
+
+	std::vector<bool> activeFeatures(weights.size());
+	unsigned int numActive = 0;
+
+	for (unsigned int i = 0; i < weights.size(); i++) {
+
+		activeFeatures[i] = (weights[i] != 0);
+		if (activeFeatures[i])
+			numActive++;
+	}
+
+	LOG_DEBUG(segmentguarantorlog)
+			<< numActive << " of " << weights.size()
+			<< " features have non-zero weights" << std::endl;
+
+	return activeFeatures;
+}
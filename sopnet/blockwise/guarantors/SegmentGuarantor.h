@@ -19,6 +19,26 @@ public:
 			boost::shared_ptr<SliceStore>   sliceStore,
 			boost::shared_ptr<StackStore<IntensityImage> > rawStackStore);
 
+	/**
+	 * Set the number of threads to use for the feature extraction, overriding 
+	 * the program option. 0 uses all hardware threads.
+	 */
+	void setNumFeatureThreads(unsigned int numThreads) {
+
+		_numFeatureThreads    = numThreads;
+		_numFeatureThreadsSet = true;
+	}
+
+	/**
+	 * Compute only features that have a non-zero weight in the segment store. 
+	 * Groups of features with only zero weights are skipped and stored as 
+	 * Features::SkippedFeatureValue. Use this only if the feature weights are 
+	 * not going to change: SolutionGuarantor refuses to compute costs if a 
+	 * feature with a non-zero weight was skipped, and RandomForestCostFunction 
+	 * refuses skipped features altogether.
+	 */
+	void setSkipZeroWeightFeatures(bool skip) { _skipZeroWeightFeatures = skip; }
+
 	/**
 	 * Guarantee segments in the given blocks. If the request can not be 
 	 * processed due to missing slices, the returned blocks are non-emtpy, 
@@ -72,14 +92,26 @@ private:
 	// compute the bounding box of a set of slices
 	util::box<unsigned int, 3> slicesBoundingBox(const Slices& slices);
 
-	// extract the features for the given segments
-	boost::shared_ptr<Features> computeFeatures(const boost::shared_ptr<Segments> segments);
+	// extract the features for the given segments, only the active ones if 
+	// activeFeatures is not empty
+	boost::shared_ptr<Features> computeFeatures(
+			const boost::shared_ptr<Segments> segments,
+			const std::vector<bool>&          activeFeatures);
+
+	// get the features with non-zero weights
+	std::vector<bool> getActiveFeatures();
 
 	boost::shared_ptr<SegmentStore> _segmentStore;
 	boost::shared_ptr<SliceStore>   _sliceStore;
 	boost::shared_ptr<StackStore<IntensityImage> > _rawStackStore;
 
 	BlockUtils _blockUtils;
+
+	// number of feature extraction threads, only used if set explicitly
+	unsigned int _numFeatureThreads;
+	bool         _numFeatureThreadsSet;
+
+	bool _skipZeroWeightFeatures;
 };
 
 #endif //SEGMENT_GUARANTOR_H__
@@ -1,9 +1,17 @@
-#include <pipeline/Process.h>
-#include <pipeline/Value.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <boost/functional/hash.hpp>
+#include <boost/make_shared.hpp>
+
 #include <blockwise/persistence/SegmentDescriptions.h>
 #include <blockwise/persistence/exceptions.h>
 #include <blockwise/blocks/Cores.h>
-#include <solvers/LinearSolver.h>
+#include <blockwise/ilp/GreedySolver.h>
+#include <blockwise/ilp/UnionFind.h>
+#include <features/Features.h>
+#include <inference/LinearCostEvaluator.h>
 #include <util/Logger.h>
 #include "SolutionGuarantor.h"
 
@@ -20,9 +28,19 @@ SolutionGuarantor::SolutionGuarantor(
 	_segmentStore(segmentStore),
 	_sliceStore(sliceStore),
 	_corePadding(corePadding),
+	_maxCorePadding(0),
 	_forceExplanation(forceExplanation),
 	_readCosts(readCosts),
 	_storeCosts(storeCosts),
+	_greedyStart(false),
+	_approximate(false),
+	_stitching(false),
+	_keepProblems(false),
+	_maxKeptProblems(64),
+	_numStructuralConstraints(0),
+	_numStitchingConstraints(0),
+	_explicitConstraintsFingerprint(0),
+	_numSeamDisagreements(0),
 	_blockUtils(projectConfiguration) {
 
 	if (_corePadding == 0)
@@ -42,14 +60,367 @@ SolutionGuarantor::guaranteeSolution(const Core& core) {
 			<< core.x() << ", " << core.y() << ", " << core.z()
 			<< ")" << std::endl;
 
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	Padding padding(_corePadding);
+
+	boost::shared_ptr<SegmentDescriptions> segments;
+	std::vector<SegmentHash>               solution;
+	std::vector<SegmentHash>               culledSolution;
+
+	while (true) {
+
+		Blocks missingBlocks = solvePaddedCore(core, padding, segments, solution);
+
+		if (!missingBlocks.empty())
+			return missingBlocks;
+
+		// cull solution to requested core
+		std::vector<SegmentHash> previousCulledSolution = culledSolution;
+		culledSolution = cullSolutionToCore(solution, *segments, core);
+
+		// more context did not change the solution in the core
+		if (!previousCulledSolution.empty() && culledSolution == previousCulledSolution) {
+
+			LOG_DEBUG(solutionguarantorlog) << "solution in core is stable" << std::endl;
+			break;
+		}
+
+		if (_maxCorePadding <= _corePadding || !growPadding(core, *segments, solution, culledSolution, padding))
+			break;
+
+		LOG_DEBUG(solutionguarantorlog)
+				<< "solution in core depends on the padding boundary, growing padding to "
+				<< "(" << padding.negX << ", " << padding.negY << ", " << padding.negZ << ") - "
+				<< "(" << padding.posX << ", " << padding.posY << ", " << padding.posZ << ")"
+				<< std::endl;
+	}
+
+	// keep the ILP for re-optimizations with different costs
+	if (_keepProblems && _maxKeptProblems > 0) {
+
+		CoreProblem& problem = keepProblem(core);
+
+		problem.blocks       = getPaddedCoreBlocks(core, padding);
+		problem.segments     = segments;
+		problem.segmentIndex = _segmentIndex;
+		problem.constraints  = _constraints;
+		problem.values       = _values;
+
+		problem.numStructuralConstraints = _numStructuralConstraints;
+		problem.numStitchingConstraints  = _numStitchingConstraints;
+		problem.explicitConstraints      = _explicitConstraintsFingerprint;
+	}
+
+	storeSolution(culledSolution, *segments, core);
+
+	_solveStatistics.numVariables   = _segmentIndex.size();
+	_solveStatistics.numConstraints = _constraints->size();
+	_solveStatistics.seconds        = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	LOG_DEBUG(solutionguarantorlog) << "done" << std::endl;
+
+	// there are no missing blocks
+	return Blocks();
+}
+
+Blocks
+SolutionGuarantor::reoptimizeSolution(const Core& core) {
+
+	std::map<Core, CoreProblem>::iterator i = _problems.find(core);
+
+	if (i == _problems.end()) {
+
+		LOG_DEBUG(solutionguarantorlog)
+				<< "no ILP kept for core (" << core.x() << ", " << core.y() << ", " << core.z()
+				<< "), solving it from scratch" << std::endl;
+
+		return guaranteeSolution(core);
+	}
+
+	LOG_DEBUG(solutionguarantorlog)
+			<< "re-optimizing solution for core ("
+			<< core.x() << ", " << core.y() << ", " << core.z()
+			<< ")" << std::endl;
+
+	CoreProblem& problem = i->second;
+
+	// cached costs might have changed, read them again
+	if (_readCosts) {
+
+		Blocks missingBlocks;
+		boost::shared_ptr<SegmentDescriptions> segments = _segmentStore->getSegmentsByBlocks(problem.blocks, missingBlocks, true);
+
+		bool changed = !missingBlocks.empty() || segments->size() != problem.segments->size();
+
+		// the same number of segments, but they might have been replaced
+		if (!changed)
+			changed = std::any_of(
+					segments->begin(),
+					segments->end(),
+					[&problem](const SegmentDescription& segment) {
+						return problem.segmentIndex.find(segment.getHash()) == HashIndex::NotFound;
+					});
+
+		if (changed) {
+
+			LOG_DEBUG(solutionguarantorlog) << "segments of padded core changed, solving it from scratch" << std::endl;
+
+			dropProblem(i);
+			return guaranteeSolution(core);
+		}
+
+		problem.segments = segments;
+	}
+
+	touchProblem(problem);
+
+	_weights      = _segmentStore->getFeatureWeights();
+	_segmentIndex = problem.segmentIndex;
+
+	// only the costs changed, the previous solution is still feasible
+	resolveProblem(core, problem);
+
+	LOG_DEBUG(solutionguarantorlog) << "done" << std::endl;
+
+	return Blocks();
+}
+
+Cores
+SolutionGuarantor::updateExplicitConstraints(const Blocks& changedBlocks) {
+
+	Cores updated;
+
+	for (const Core& core : getAffectedCores(changedBlocks)) {
+
+		Cores cores;
+		cores.add(core);
+
+		// not solved yet, the new constraints will be used when it is
+		if (_segmentStore->getSolutionByCores(cores).empty())
+			continue;
+
+		std::map<Core, CoreProblem>::iterator i = _problems.find(core);
+
+		// the ILP was not kept, solve the core from scratch
+		if (i == _problems.end()) {
+
+			LOG_DEBUG(solutionguarantorlog)
+					<< "no ILP kept for core (" << core.x() << ", " << core.y() << ", " << core.z()
+					<< "), solving it again from scratch" << std::endl;
+
+			Blocks missingBlocks = guaranteeSolution(core);
+
+			if (!missingBlocks.empty()) {
+
+				LOG_USER(solutionguarantorlog)
+						<< "could not solve core (" << core.x() << ", " << core.y() << ", " << core.z()
+						<< ") again, blocks " << missingBlocks << " are missing" << std::endl;
+				continue;
+			}
+
+			updated.add(core);
+			continue;
+		}
+
+		CoreProblem& problem = i->second;
+
+		bool affected = false;
+		for (const Block& block : changedBlocks)
+			if (problem.blocks.contains(block)) {
+
+				affected = true;
+				break;
+			}
+
+		if (!affected)
+			continue;
+
+		SegmentConstraints explicitConstraints = *_segmentStore->getConstraintsByBlocks(problem.blocks);
+
+		std::size_t fingerprint = getFingerprint(explicitConstraints);
+
+		if (fingerprint == problem.explicitConstraints)
+			continue;
+
+		LOG_DEBUG(solutionguarantorlog)
+				<< "explicit constraints of core ("
+				<< core.x() << ", " << core.y() << ", " << core.z()
+				<< ") changed, solving it again" << std::endl;
+
+		_weights      = _segmentStore->getFeatureWeights();
+		_segmentIndex = problem.segmentIndex;
+
+		SegmentConstraints stitchingConstraints;
+		if (_stitching)
+			stitchingConstraints = createStitchingConstraints(core, problem.blocks, *problem.segments);
+
+		// keep the overlap and continuation constraints, replace the explicit 
+		// and stitching ones
+		boost::shared_ptr<LinearConstraints> constraints = boost::make_shared<LinearConstraints>();
+		for (unsigned int i = 0; i < problem.numStructuralConstraints; i++)
+			constraints->add((*problem.constraints)[i]);
+		addExplicitConstraints(explicitConstraints, *constraints);
+
+		unsigned int numConstraints = constraints->size();
+		addExplicitConstraints(stitchingConstraints, *constraints);
+
+		problem.constraints             = constraints;
+		problem.numStitchingConstraints = constraints->size() - numConstraints;
+		problem.explicitConstraints     = fingerprint;
+
+		touchProblem(problem);
+
+		std::vector<SegmentHash> solution = resolveProblem(core, problem);
+
+		if (_stitching)
+			checkSeams(core, solution);
+
+		updated.add(core);
+	}
+
+	LOG_DEBUG(solutionguarantorlog) << "solved " << updated.size() << " cores again" << std::endl;
+
+	return updated;
+}
+
+Cores
+SolutionGuarantor::getAffectedCores(const Blocks& changedBlocks) {
+
+	// with adaptive padding, a core might have been solved with up to the 
+	// maximal padding
+	unsigned int padding = std::max(_corePadding, _maxCorePadding);
+
+	Cores cores;
+
+	for (const Block& block : changedBlocks) {
+
+		// the cores whose padded blocks contain this block are the ones that 
+		// intersect the block grown by the padding
+		Blocks blocks;
+		blocks.add(block);
+		_blockUtils.expand(blocks, padding, padding, padding, padding, padding, padding);
+
+		cores.addAll(_blockUtils.getCoresInBox(_blockUtils.getBoundingBox(blocks)));
+	}
+
+	return cores;
+}
+
+SolutionGuarantor::CoreProblem&
+SolutionGuarantor::keepProblem(const Core& core) {
+
+	std::map<Core, CoreProblem>::iterator i = _problems.find(core);
+
+	if (i != _problems.end()) {
+
+		touchProblem(i->second);
+		return i->second;
+	}
+
+	while (!_problems.empty() && _problems.size() >= _maxKeptProblems)
+		dropProblem(_problems.find(_problemOrder.back()));
+
+	CoreProblem& problem = _problems[core];
+
+	_problemOrder.push_front(core);
+	problem.position = _problemOrder.begin();
+
+	return problem;
+}
+
+void
+SolutionGuarantor::touchProblem(CoreProblem& problem) {
+
+	_problemOrder.splice(_problemOrder.begin(), _problemOrder, problem.position);
+}
+
+void
+SolutionGuarantor::dropProblem(std::map<Core, CoreProblem>::iterator i) {
+
+	_problemOrder.erase(i->second.position);
+	_problems.erase(i);
+}
+
+std::vector<SegmentHash>
+SolutionGuarantor::resolveProblem(const Core& core, CoreProblem& problem) {
+
+	std::vector<double> costs = createObjective(*problem.segments);
+	problem.values = solveStitchedIlp(costs, problem.constraints, problem.numStitchingConstraints, problem.values);
+
+	std::vector<SegmentHash> solution = getSolutionSegments(problem.values);
+
+	storeSolution(cullSolutionToCore(solution, *problem.segments, core), *problem.segments, core);
+
+	return solution;
+}
+
+std::size_t
+SolutionGuarantor::getFingerprint(const SegmentConstraints& constraints) {
+
+	std::vector<std::size_t> hashes;
+	hashes.reserve(constraints.size());
+
+	for (const SegmentConstraint& constraint : constraints) {
+
+		std::size_t hash = 0;
+		boost::hash_combine(hash, static_cast<int>(constraint.getRelation()));
+		boost::hash_combine(hash, constraint.getValue());
+
+		for (const std::map<SegmentHash, double>::value_type& coeff : constraint.getCoefficients()) {
+
+			boost::hash_combine(hash, coeff.first);
+			boost::hash_combine(hash, coeff.second);
+		}
+
+		hashes.push_back(hash);
+	}
+
+	// the store does not guarantee an order of the constraints
+	std::sort(hashes.begin(), hashes.end());
+
+	std::size_t fingerprint = constraints.size();
+	for (std::size_t hash : hashes)
+		boost::hash_combine(fingerprint, hash);
+
+	return fingerprint;
+}
+
+void
+SolutionGuarantor::storeSolution(
+		const std::vector<SegmentHash>& culledSolution,
+		const SegmentDescriptions&      segments,
+		const Core&                     core) {
+
+	// extract assemblies
+	std::vector<std::set<SegmentHash> > assemblies = extractAssemblies(culledSolution, segments);
+
+	// store solution
+	_segmentStore->storeSolution(assemblies, core);
+	_segmentStore->storeSolutionStatus(_solutionStatus, core);
+
+	if (!_solutionStatus.isOptimal())
+		LOG_USER(solutionguarantorlog)
+				<< "solution for core (" << core.x() << ", " << core.y() << ", " << core.z()
+				<< ") is not optimal (" << SolutionStatus::statusName(_solutionStatus.getStatus())
+				<< "), its cost is " << _solutionStatus.getCost() << std::endl;
+}
+
+Blocks
+SolutionGuarantor::solvePaddedCore(
+		const Core&                             core,
+		const Padding&                          padding,
+		boost::shared_ptr<SegmentDescriptions>& segments,
+		std::vector<SegmentHash>&               solution) {
+
 	// get all the blocks in the padded core
-	Blocks blocks = getPaddedCoreBlocks(core);
+	Blocks blocks = getPaddedCoreBlocks(core, padding);
 
 	LOG_DEBUG(solutionguarantorlog) << "with padding this corresponds to blocks " << blocks << std::endl;
 
 	// get all segments for these blocks
 	Blocks missingBlocks;
-	boost::shared_ptr<SegmentDescriptions> segments = _segmentStore->getSegmentsByBlocks(blocks, missingBlocks, _readCosts);
+	segments = _segmentStore->getSegmentsByBlocks(blocks, missingBlocks, _readCosts);
 
 	if (!missingBlocks.empty())
 		return missingBlocks;
@@ -62,52 +433,232 @@ SolutionGuarantor::guaranteeSolution(const Core& core) {
 	if (!missingBlocks.empty())
 		return missingBlocks;
 
-	boost::shared_ptr<SegmentConstraints> explicitConstraints = _segmentStore->getConstraintsByBlocks(blocks);
+	SegmentConstraints explicitConstraints = *_segmentStore->getConstraintsByBlocks(blocks);
+	_explicitConstraintsFingerprint = getFingerprint(explicitConstraints);
+
+	// fix the segments of already solved neighbouring cores
+	SegmentConstraints stitchingConstraints;
+	if (_stitching)
+		stitchingConstraints = createStitchingConstraints(core, blocks, *segments);
 
 	LOG_DEBUG(solutionguarantorlog) << "computing solution..." << std::endl;
 
 	_weights = _segmentStore->getFeatureWeights();
 
 	// compute solution
-	std::vector<SegmentHash> solution = computeSolution(*segments, *conflictSets, *explicitConstraints);
+	solution = computeSolution(*segments, *conflictSets, explicitConstraints, stitchingConstraints);
 
 	LOG_DEBUG(solutionguarantorlog) << "solution contains " << solution.size() << " segments" << std::endl;
 
-	// cull solution to requested core
-	std::vector<SegmentHash> culledSolution = cullSolutionToCore(solution, *segments, core);
+	if (_stitching)
+		checkSeams(core, solution);
 
-	// extract assemblies
-	std::vector<std::set<SegmentHash> > assemblies = extractAssemblies(culledSolution, *segments);
+	return Blocks();
+}
 
-	// store solution
-	_segmentStore->storeSolution(assemblies, core);
+SegmentConstraints
+SolutionGuarantor::createStitchingConstraints(
+		const Core&                core,
+		const Blocks&              blocks,
+		const SegmentDescriptions& segments) {
 
-	LOG_DEBUG(solutionguarantorlog) << "done" << std::endl;
+	_neighbourSolution.clear();
+	_seamSegments.clear();
 
-	// there are no missing blocks
-	return Blocks();
+	// the bounding boxes and stored solutions of the solved neighbouring cores
+	std::vector<util::box<unsigned int, 3> > neighbourBoxes;
+	std::vector<std::set<SegmentHash> >      neighbourSolutions;
+
+	for (const Core& neighbour : _blockUtils.getCoresInBox(_blockUtils.getBoundingBox(blocks))) {
+
+		if (neighbour == core)
+			continue;
+
+		Cores cores;
+		cores.add(neighbour);
+
+		std::vector<std::set<SegmentHash> > assemblies = _segmentStore->getSolutionByCores(cores);
+
+		// not solved yet
+		if (assemblies.empty())
+			continue;
+
+		std::set<SegmentHash> neighbourSolution;
+		for (const std::set<SegmentHash>& assembly : assemblies)
+			neighbourSolution.insert(assembly.begin(), assembly.end());
+
+		_neighbourSolution.insert(neighbourSolution.begin(), neighbourSolution.end());
+
+		neighbourBoxes.push_back(_blockUtils.getBoundingBox(neighbour));
+		neighbourSolutions.push_back(neighbourSolution);
+	}
+
+	util::box<unsigned int, 3> coreBoundingBox = _blockUtils.getBoundingBox(core);
+
+	SegmentConstraints constraints;
+
+	unsigned int numInconsistent = 0;
+
+	for (const SegmentDescription& segment : segments) {
+
+		// the value of the segment in the neighbours it lies in, -1 if it 
+		// lies in none
+		int  value      = -1;
+		bool consistent = true;
+
+		for (unsigned int i = 0; i < neighbourBoxes.size(); i++) {
+
+			if (!intersects(segment, neighbourBoxes[i]))
+				continue;
+
+			int neighbourValue = neighbourSolutions[i].count(segment.getHash());
+
+			if (value >= 0 && value != neighbourValue)
+				consistent = false;
+
+			value = neighbourValue;
+		}
+
+		if (value < 0)
+			continue;
+
+		// segments on the seam stay free, the others are fixed to the stored 
+		// solution
+		if (intersects(segment, coreBoundingBox)) {
+
+			_seamSegments.insert(segment.getHash());
+			continue;
+		}
+
+		// the neighbours were solved independently and disagree on this 
+		// segment, fixing it to either value contradicts one of them
+		if (!consistent) {
+
+			numInconsistent++;
+			continue;
+		}
+
+		SegmentConstraint constraint;
+		constraint.setCoefficient(segment.getHash(), 1.0);
+		constraint.setRelation(Equal);
+		constraint.setValue(value);
+
+		constraints.push_back(constraint);
+	}
+
+	LOG_DEBUG(solutionguarantorlog)
+			<< "stitching to " << neighbourBoxes.size() << " solved neighbouring cores, fixed "
+			<< constraints.size() << " segments, " << _seamSegments.size() << " segments on the seams, "
+			<< numInconsistent << " segments left free since the neighbours disagree on them"
+			<< std::endl;
+
+	return constraints;
+}
+
+void
+SolutionGuarantor::checkSeams(
+		const Core&                     core,
+		const std::vector<SegmentHash>& solution) {
+
+	std::set<SegmentHash> solutionLookup(solution.begin(), solution.end());
+
+	_numSeamDisagreements = 0;
+
+	for (const SegmentHash& hash : _seamSegments)
+		if (solutionLookup.count(hash) != _neighbourSolution.count(hash))
+			_numSeamDisagreements++;
+
+	if (_numSeamDisagreements > 0)
+		LOG_USER(solutionguarantorlog)
+				<< "solution for core (" << core.x() << ", " << core.y() << ", " << core.z()
+				<< ") disagrees with the solutions of its neighbours on "
+				<< _numSeamDisagreements << " of " << _seamSegments.size() << " seam segments"
+				<< std::endl;
 }
 
 Blocks
-SolutionGuarantor::getPaddedCoreBlocks(const Core& core) {
+SolutionGuarantor::getPaddedCoreBlocks(const Core& core, const Padding& padding) {
 
 	// get the core blocks
 	Blocks blocks = _blockUtils.getCoreBlocks(core);
 
-	// grow by _corePadding in each direction
+	// grow by the padding in each direction
 	_blockUtils.expand(
 			blocks,
-			_corePadding, _corePadding, _corePadding,
-			_corePadding, _corePadding, _corePadding);
+			padding.posX, padding.posY, padding.posZ,
+			padding.negX, padding.negY, padding.negZ);
 
 	return blocks;
 }
 
+bool
+SolutionGuarantor::growPadding(
+		const Core&                     core,
+		const SegmentDescriptions&      segments,
+		const std::vector<SegmentHash>& solution,
+		const std::vector<SegmentHash>& culledSolution,
+		Padding&                        padding) {
+
+	// the segments of all assemblies that have a segment in the core
+	std::set<SegmentHash> coreSegments(culledSolution.begin(), culledSolution.end());
+	std::set<SegmentHash> connectedSegments;
+
+	for (const std::set<SegmentHash>& assembly : extractAssemblies(solution, segments))
+		for (const SegmentHash& hash : assembly)
+			if (coreSegments.count(hash)) {
+
+				connectedSegments.insert(assembly.begin(), assembly.end());
+				break;
+			}
+
+	SegmentDescriptions connected;
+	for (const SegmentDescription& segment : segments)
+		if (connectedSegments.count(segment.getHash()))
+			connected.add(segment);
+
+	if (connected.size() == 0)
+		return false;
+
+	util::box<unsigned int, 3> connectedBox = segmentsBoundingBox(connected);
+
+	// the padded core without its outermost layer of blocks, assemblies that 
+	// leave it depend on decisions near the padding boundary
+	Padding innerPadding = padding;
+	innerPadding.shrink();
+
+	util::box<unsigned int, 3> paddedBox = _blockUtils.getBoundingBox(getPaddedCoreBlocks(core, padding));
+	util::box<unsigned int, 3> innerBox  = _blockUtils.getBoundingBox(getPaddedCoreBlocks(core, innerPadding));
+	util::box<unsigned int, 3> volume    = _blockUtils.getVolumeBoundingBox();
+
+	bool grown = false;
+
+	// grow a face by one block, unless it is at the volume boundary or 
+	// already at the maximal padding
+	auto grow = [this, &grown](bool touched, bool atBoundary, unsigned int& facePadding) {
+
+		if (touched && !atBoundary && facePadding < _maxCorePadding) {
+
+			facePadding++;
+			grown = true;
+		}
+	};
+
+	grow(connectedBox.min().x() < innerBox.min().x(), paddedBox.min().x() <= volume.min().x(), padding.negX);
+	grow(connectedBox.min().y() < innerBox.min().y(), paddedBox.min().y() <= volume.min().y(), padding.negY);
+	grow(connectedBox.min().z() < innerBox.min().z(), paddedBox.min().z() <= volume.min().z(), padding.negZ);
+	grow(connectedBox.max().x() > innerBox.max().x(), paddedBox.max().x() >= volume.max().x(), padding.posX);
+	grow(connectedBox.max().y() > innerBox.max().y(), paddedBox.max().y() >= volume.max().y(), padding.posY);
+	grow(connectedBox.max().z() > innerBox.max().z(), paddedBox.max().z() >= volume.max().z(), padding.posZ);
+
+	return grown;
+}
+
 std::vector<SegmentHash>
 SolutionGuarantor::computeSolution(
 		const SegmentDescriptions& segments,
 		const ConflictSets&        conflictSets,
-		const SegmentConstraints&  explicitConstraints) {
+		const SegmentConstraints&  explicitConstraints,
+		const SegmentConstraints&  stitchingConstraints) {
 
 	unsigned int firstSection = std::numeric_limits<unsigned int>::max();
 	unsigned int lastSection  = 0;
@@ -127,90 +678,140 @@ SolutionGuarantor::computeSolution(
 			<< ", last section (inclusive) is "
 			<< lastSection << std::endl;
 
-	// create the hash <-> variable mappings and the slice -> [segments] 
-	// mappings
+	// assign dense indices to segments and slices, and create the slice -> 
+	// [segments] mappings
 
-	unsigned int numEnds          = 0;
-	unsigned int numContinuations = 0;
-	unsigned int numBranches      = 0;
+	createIndices(segments);
 
-	_rightSliceToSegments.clear();
-	_leftSliceToSegments.clear();
-	_slices.clear();
-	_variableToHash.clear();
+	// create linear constraints on the variables
 
-	std::set<SliceHash> hasEnd;
+	boost::shared_ptr<LinearConstraints> constraints = createConstraints(segments, conflictSets, explicitConstraints, stitchingConstraints);
 
-	unsigned int nextVar = 0;
-	for (const SegmentDescription& segment : segments) {
+	// create the cost function
 
-		SegmentHash segmentHash = segment.getHash();
+	std::vector<double> costs = createObjective(segments);
 
-		_hashToVariable[segmentHash] = nextVar;
-		_variableToHash[nextVar] = segmentHash;
-		nextVar++;
+	_constraints = constraints;
+	_values      = solveStitchedIlp(costs, _constraints, _numStitchingConstraints, std::vector<double>());
 
-		for (SliceHash leftSliceHash : segment.getLeftSlices()) {
+	return getSolutionSegments(_values);
+}
 
-			_leftSliceToSegments[leftSliceHash].push_back(segmentHash);
-			_slices.insert(leftSliceHash);
+std::vector<double>
+SolutionGuarantor::solveIlp(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		const std::vector<double>& start) {
 
-			if (segment.getType() == EndSegmentType) hasEnd.insert(leftSliceHash);
-		}
+	const unsigned int numVariables = costs.size();
 
-		for (SliceHash rightSliceHash : segment.getRightSlices()) {
+	// find a good solution with the greedy heuristic, starting from the 
+	// previous solution of the core (if any)
+
+	std::vector<double> solution;
+
+	bool   greedyFeasible = false;
+	double greedyCost     = 0;
+
+	if (_greedyStart || _approximate) {
+
+		GreedySolver greedySolver;
+		std::vector<double> greedySolution = greedySolver.solve(costs, constraints, start);
+
+		greedyFeasible = greedySolver.isFeasible();
+		greedyCost     = greedySolver.getCost();
+
+		LOG_USER(solutionguarantorlog)
+				<< "greedy solution has cost " << greedyCost << " and is "
+				<< (greedyFeasible ? "feasible" : "infeasible") << std::endl;
+
+		if (greedyFeasible && _approximate) {
 
-			_rightSliceToSegments[rightSliceHash].push_back(segmentHash);
-			_slices.insert(rightSliceHash);
+			solution = greedySolution;
 
-			if (segment.getType() == EndSegmentType) hasEnd.insert(rightSliceHash);
+		} else if (_approximate) {
+
+			LOG_ERROR(solutionguarantorlog)
+					<< "greedy solution is infeasible, solving the ILP instead" << std::endl;
 		}
+	}
 
-		if (segment.getType() == EndSegmentType)
-			numEnds++;
-		if (segment.getType() == ContinuationSegmentType)
-			numContinuations++;
-		if (segment.getType() == BranchSegmentType)
-			numBranches++;
+	// use the greedy solution, or solve the ILP component by component
+
+	if (!solution.empty()) {
+
+		_solutionStatus = SolutionStatus(SolutionStatus::Approximate, greedyCost);
+
+	} else {
+
+		solution = _ilpSolver.solve(costs, constraints);
+
+		double cost = 0;
+		for (unsigned int var = 0; var < numVariables; var++)
+			cost += costs[var]*solution[var];
+
+		SolutionStatus::Status status = SolutionStatus::Optimal;
+		if (_ilpSolver.getStatus() == IlpSolver::Infeasible)
+			status = SolutionStatus::Infeasible;
+
+		_solutionStatus = SolutionStatus(status, cost);
+
+		if (greedyFeasible)
+			LOG_USER(solutionguarantorlog)
+					<< "ILP cost is " << cost << ", the greedy solution has a gap of "
+					<< (greedyCost - cost) << " ("
+					<< 100.0*(greedyCost - cost)/std::max(std::abs(cost), 1e-6) << "%)"
+					<< std::endl;
 	}
 
-	// Leaf slices are slices without an end segment.
-	std::set_difference(_slices.begin(), _slices.end(), hasEnd.begin(), hasEnd.end(),
-			std::inserter(_leafSlices, _leafSlices.end()));
+	return solution;
+}
 
-	LOG_DEBUG(solutionguarantorlog)
-			<< "got " << numEnds << " end segments, "
-			<< numContinuations << " continuation segments, and "
-			<< numBranches << " branches" << std::endl;
+std::vector<double>
+SolutionGuarantor::solveStitchedIlp(
+		const std::vector<double>&            costs,
+		boost::shared_ptr<LinearConstraints>& constraints,
+		unsigned int&                         numStitchingConstraints,
+		const std::vector<double>&            start) {
 
-	// create linear constraints on the variables
+	std::vector<double> values = solveIlp(costs, *constraints, start);
 
-	boost::shared_ptr<LinearConstraints> constraints = createConstraints(segments, conflictSets, explicitConstraints);
+	if (_solutionStatus.getStatus() != SolutionStatus::Infeasible || numStitchingConstraints == 0)
+		return values;
 
-	// create the cost function
+	// even consistently fixed segments of different neighbours can conflict, 
+	// or leave a continuation without a partner
+	LOG_USER(solutionguarantorlog)
+			<< "the ILP is infeasible with the " << numStitchingConstraints
+			<< " stitching constraints, solving it without them" << std::endl;
 
-	boost::shared_ptr<LinearObjective> objective = createObjective(segments);
+	boost::shared_ptr<LinearConstraints> unstitched = boost::make_shared<LinearConstraints>();
+	for (unsigned int i = 0; i < constraints->size() - numStitchingConstraints; i++)
+		unstitched->add((*constraints)[i]);
 
-	// solve the ILP
+	constraints             = unstitched;
+	numStitchingConstraints = 0;
 
-	pipeline::Process<LinearSolver> solver;
+	values = solveIlp(costs, *constraints, start);
 
-	boost::shared_ptr<LinearSolverParameters> parameters =
-			boost::make_shared<LinearSolverParameters>(Binary);
+	// the solution does not agree with the neighbours, which makes it a 
+	// candidate for a re-solve
+	if (_solutionStatus.getStatus() != SolutionStatus::Infeasible)
+		_solutionStatus = SolutionStatus(SolutionStatus::Unstitched, _solutionStatus.getCost());
 
-	solver->setInput("objective", objective);
-	solver->setInput("linear constraints", constraints);
-	solver->setInput("parameters", parameters);
+	return values;
+}
 
-	pipeline::Value<Solution> solution = solver->getOutput();
+std::vector<SegmentHash>
+SolutionGuarantor::getSolutionSegments(const std::vector<double>& solution) {
 
 	// find the segment hashes that correspond to the solution
 
 	std::vector<SegmentHash> solutionSegments;
 
-	for (unsigned int var = 0; var < nextVar; var++)
-		if ((*solution)[var] == 1.0)
-			solutionSegments.push_back(_variableToHash[var]);
+	for (unsigned int var = 0; var < solution.size(); var++)
+		if (solution[var] == 1.0)
+			solutionSegments.push_back(_segmentIndex.getHash(var));
 
 	return solutionSegments;
 }
@@ -219,7 +820,8 @@ boost::shared_ptr<LinearConstraints>
 SolutionGuarantor::createConstraints(
 		const SegmentDescriptions& segments,
 		const ConflictSets&        conflictSets,
-		const SegmentConstraints&  explicitConstraints) {
+		const SegmentConstraints&  explicitConstraints,
+		const SegmentConstraints&  stitchingConstraints) {
 
 	LOG_DEBUG(solutionguarantorlog) << "creating constraints" << std::endl;
 
@@ -227,44 +829,176 @@ SolutionGuarantor::createConstraints(
 
 	addOverlapConstraints(segments, conflictSets, *constraints);
 	addContinuationConstraints(segments, *constraints);
+	_numStructuralConstraints = constraints->size();
 	addExplicitConstraints(explicitConstraints, *constraints);
 
+	// the stitching constraints come last, such that they can be dropped
+	unsigned int numConstraints = constraints->size();
+	addExplicitConstraints(stitchingConstraints, *constraints);
+	_numStitchingConstraints = constraints->size() - numConstraints;
+
 	return constraints;
 }
 
-boost::shared_ptr<LinearObjective>
+std::vector<double>
 SolutionGuarantor::createObjective(const SegmentDescriptions& segments) {
 
 	LOG_DEBUG(solutionguarantorlog) << "creating objective for " << segments.size() << " segments" << std::endl;
 
-	boost::shared_ptr<LinearObjective> objective = boost::make_shared<LinearObjective>(segments.size());
+	std::vector<double> objective(segments.size(), 0.0);
 
 	if (segments.size() == 0)
 		return objective;
 
+	// the costs of segments without cached costs are evaluated directly on the 
+	// features of their descriptions, row by row
+	LinearCostEvaluator evaluator(_weights);
+
+	const unsigned int numFeatures = _weights.size();
+
 	// newly computed segment costs
 	std::map<SegmentHash, double> newCosts;
 
 	for (const SegmentDescription& segment : segments) {
 
-		unsigned int var  = _hashToVariable[segment.getHash()];
-		double       cost = segment.getCost();
+		unsigned int var = _segmentIndex.find(segment.getHash());
 
-		if (!_readCosts || std::isnan(cost)) {
+		if (var == HashIndex::NotFound)
+			UTIL_THROW_EXCEPTION(
+					Exception,
+					"segment " << segment.getHash() << " is not a variable of the ILP");
 
-			cost = getCost(segment.getFeatures());
-			newCosts[segment.getHash()] = cost;
+		double& cost = objective[var];
+
+		if (_readCosts && !std::isnan(segment.getCost())) {
+
+			cost = segment.getCost();
+			continue;
 		}
 
-		objective->setCoefficient(var, cost);
+		if (segment.getFeatures().size() != numFeatures)
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"number of features " << segment.getFeatures().size() << " does not match number of weights " << numFeatures);
+
+		checkSkippedFeatures(segment);
+
+		evaluator.addCosts(segment.getFeatures().data(), 1, numFeatures, &cost);
+		newCosts[segment.getHash()] = cost;
 	}
 
+	LOG_DEBUG(solutionguarantorlog) << "computed costs for " << newCosts.size() << " segments" << std::endl;
+
 	// Store costs if requested.
 	if (_storeCosts && !newCosts.empty()) _segmentStore->storeSegmentCosts(newCosts);
 
 	return objective;
 }
 
+void
+SolutionGuarantor::checkSkippedFeatures(const SegmentDescription& segment) {
+
+	const std::vector<double>& features = segment.getFeatures();
+
+	for (unsigned int i = 0; i < _weights.size(); i++)
+		if (_weights[i] != 0 && features[i] == Features::SkippedFeatureValue)
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"feature " << i << " of segment " << segment.getHash() << " has weight "
+					<< _weights[i] << ", but was skipped during the segment extraction. "
+					"Extract the segments again without skipping zero-weight features.");
+}
+
+void
+SolutionGuarantor::createIndices(const SegmentDescriptions& segments) {
+
+	unsigned int numEnds          = 0;
+	unsigned int numContinuations = 0;
+	unsigned int numBranches      = 0;
+
+	std::vector<SegmentHash> segmentHashes;
+	std::vector<SliceHash>   sliceHashes;
+
+	segmentHashes.reserve(segments.size());
+
+	for (const SegmentDescription& segment : segments) {
+
+		segmentHashes.push_back(segment.getHash());
+		sliceHashes.insert(sliceHashes.end(), segment.getLeftSlices().begin(), segment.getLeftSlices().end());
+		sliceHashes.insert(sliceHashes.end(), segment.getRightSlices().begin(), segment.getRightSlices().end());
+
+		if (segment.getType() == EndSegmentType)
+			numEnds++;
+		if (segment.getType() == ContinuationSegmentType)
+			numContinuations++;
+		if (segment.getType() == BranchSegmentType)
+			numBranches++;
+	}
+
+	_segmentIndex.build(segmentHashes);
+	_sliceIndex.build(sliceHashes);
+
+	const unsigned int numSlices = _sliceIndex.size();
+
+	// count the segments on either side of each slice
+	_leftSliceToSegments.begin.assign(numSlices + 1, 0);
+	_rightSliceToSegments.begin.assign(numSlices + 1, 0);
+
+	// leaf slices are slices without an end segment
+	_leafSlices.assign(numSlices, true);
+
+	for (const SegmentDescription& segment : segments) {
+
+		for (SliceHash leftSliceHash : segment.getLeftSlices())
+			_leftSliceToSegments.begin[_sliceIndex.find(leftSliceHash) + 1]++;
+
+		for (SliceHash rightSliceHash : segment.getRightSlices())
+			_rightSliceToSegments.begin[_sliceIndex.find(rightSliceHash) + 1]++;
+	}
+
+	for (unsigned int i = 0; i < numSlices; i++) {
+
+		_leftSliceToSegments.begin[i + 1]  += _leftSliceToSegments.begin[i];
+		_rightSliceToSegments.begin[i + 1] += _rightSliceToSegments.begin[i];
+	}
+
+	_leftSliceToSegments.segments.resize(_leftSliceToSegments.begin[numSlices]);
+	_rightSliceToSegments.segments.resize(_rightSliceToSegments.begin[numSlices]);
+
+	// fill the segments of each slice
+	std::vector<unsigned int> nextLeft(_leftSliceToSegments.begin.begin(), _leftSliceToSegments.begin.end() - 1);
+	std::vector<unsigned int> nextRight(_rightSliceToSegments.begin.begin(), _rightSliceToSegments.begin.end() - 1);
+
+	unsigned int var = 0;
+	for (const SegmentDescription& segment : segments) {
+
+		for (SliceHash leftSliceHash : segment.getLeftSlices()) {
+
+			unsigned int slice = _sliceIndex.find(leftSliceHash);
+
+			_leftSliceToSegments.segments[nextLeft[slice]++] = var;
+
+			if (segment.getType() == EndSegmentType) _leafSlices[slice] = false;
+		}
+
+		for (SliceHash rightSliceHash : segment.getRightSlices()) {
+
+			unsigned int slice = _sliceIndex.find(rightSliceHash);
+
+			_rightSliceToSegments.segments[nextRight[slice]++] = var;
+
+			if (segment.getType() == EndSegmentType) _leafSlices[slice] = false;
+		}
+
+		var++;
+	}
+
+	LOG_DEBUG(solutionguarantorlog)
+			<< "got " << numEnds << " end segments, "
+			<< numContinuations << " continuation segments, and "
+			<< numBranches << " branches" << std::endl;
+}
+
 void
 SolutionGuarantor::addOverlapConstraints(
 		const SegmentDescriptions& /*segments*/,
@@ -275,7 +1009,7 @@ SolutionGuarantor::addOverlapConstraints(
 			<< "creating overlap constraints for " << conflictSets.size()
 			<< " conflict sets" << std::endl;
 
-	std::set<SliceHash> noConflictSlices = _slices;
+	std::vector<bool> inConflictSet(_sliceIndex.size(), false);
 
 	// for each conflict set:
 	for (const ConflictSet& conflictSet : conflictSets) {
@@ -288,32 +1022,20 @@ SolutionGuarantor::addOverlapConstraints(
 		// the sum of their variables to be at most one
 		for (const SliceHash& sliceHash : conflictSet.getSlices()) {
 
+			unsigned int slice = _sliceIndex.find(sliceHash);
+
 			// Because conflict sets from expanded blocks may include slices not
 			// in this set of segments, first check for the slice.
-			if (_slices.count(sliceHash)) {
-
-				anySet = true;
-
-				std::map<SliceHash, std::vector<SegmentHash> >* sliceToSegments = &_leftSliceToSegments;
+			if (slice == HashIndex::NotFound)
+				continue;
 
-				if (_leafSlices.count(sliceHash)) anyLeaf = true;
+			anySet = true;
+			inConflictSet[slice] = true;
 
-				// Find segments that use the slice on their left side, except
-				// if this is a slice in the last section or a leaf slice with
-				// no left segments. In this case, find segments that use it on
-				// their right side.
-				if (0 == sliceToSegments->count(sliceHash))
-					sliceToSegments = &_rightSliceToSegments;
+			if (_leafSlices[slice]) anyLeaf = true;
 
-				for (const SegmentHash& segmentHash : (*sliceToSegments)[sliceHash]) {
-
-					unsigned int var = _hashToVariable[segmentHash];
-
-					constraint.setCoefficient(var, 1.0);
-				}
-			}
-
-			noConflictSlices.erase(sliceHash);
+			for (unsigned int var : getSliceSegments(slice))
+				constraint.setCoefficient(var, 1.0);
 		}
 
 		// Do not force explanation if this conflict set involves a leaf slice.
@@ -321,69 +1043,74 @@ SolutionGuarantor::addOverlapConstraints(
 		constraint.setValue(1.0);
 
 		// Only add the constraint if any variables were set. This is necessary
-		// since some expanded block conflict sets do not involve any _slices.
+		// since some expanded block conflict sets do not involve any of our 
+		// slices.
 		if (anySet) constraints.add(constraint);
 	}
 
 	// Create an exclusivity constraint for the segments one one side of each
 	// slice not in any conflict set.
-	for (const SliceHash& sliceHash : noConflictSlices) {
-
-		LinearConstraint constraint;
+	for (unsigned int slice = 0; slice < _sliceIndex.size(); slice++) {
 
-		std::map<SliceHash, std::vector<SegmentHash> >* sliceToSegments = &_leftSliceToSegments;
+		if (inConflictSet[slice])
+			continue;
 
-		// Find segments that use the slice on their left side, except
-		// if this is a slice in the last section or a leaf slice with
-		// no left segments. In this case, find segments that use it on
-		// their right side.
-		if (0 == sliceToSegments->count(sliceHash))
-			sliceToSegments = &_rightSliceToSegments;
+		LinearConstraint constraint;
 
-		for (const SegmentHash& segmentHash : (*sliceToSegments)[sliceHash])
-			constraint.setCoefficient(_hashToVariable[segmentHash], 1.0);
+		for (unsigned int var : getSliceSegments(slice))
+			constraint.setCoefficient(var, 1.0);
 
 		// Do not force explanation if this is a leaf slice.
-		constraint.setRelation(_forceExplanation && 0 == _leafSlices.count(sliceHash) ? Equal : LessEqual);
+		constraint.setRelation(_forceExplanation && !_leafSlices[slice] ? Equal : LessEqual);
 		constraint.setValue(1.0);
 
 		constraints.add(constraint);
 	}
 }
 
+SolutionGuarantor::SegmentRange
+SolutionGuarantor::getSliceSegments(unsigned int slice) const {
+
+	// Find segments that use the slice on their left side, except if this is 
+	// a slice in the last section or a leaf slice with no left segments. In 
+	// this case, find segments that use it on their right side.
+	if (_leftSliceToSegments.numSegments(slice) > 0)
+		return _leftSliceToSegments.getSegments(slice);
+
+	return _rightSliceToSegments.getSegments(slice);
+}
+
 void
 SolutionGuarantor::addContinuationConstraints(
 		const SegmentDescriptions& /*segments*/,
 		LinearConstraints&         constraints) {
 
 	// for each slice
-	for (const SliceHash& sliceHash : _slices) {
+	for (unsigned int slice = 0; slice < _sliceIndex.size(); slice++) {
 
 		// If the slice has no segments on one side (some leaf, first, last
 		// slices), ignore it.
-		if (0 == _rightSliceToSegments.count(sliceHash) ||
-			0 == _leftSliceToSegments.count(sliceHash))
+		if (0 == _rightSliceToSegments.numSegments(slice) ||
+			0 == _leftSliceToSegments.numSegments(slice))
 			continue;
 
-		// get all segments that use this slice from the left
-		const std::vector<SegmentHash>& leftSegments = _rightSliceToSegments[sliceHash];
-
-		// get all segments that use this slice from the right
-		const std::vector<SegmentHash>& rightSegments = _leftSliceToSegments[sliceHash];
-
-		// require the sum of their variables to be equal
+		// require the sum of the variables of the segments that use this slice 
+		// from the left and from the right to be equal
 
 		LinearConstraint constraint;
 
-		LOG_ALL(solutionguarantorlog) << "create new continuation constraint for slice " << sliceHash << std::endl;
+		LOG_ALL(solutionguarantorlog) << "create new continuation constraint for slice " << _sliceIndex.getHash(slice) << std::endl;
 
-		for (SegmentHash segmentHash : leftSegments) {
-			constraint.setCoefficient(_hashToVariable[segmentHash], 1.0);
-			LOG_ALL(solutionguarantorlog) << _hashToVariable[segmentHash] << " is left segment" << std::endl;
+		// segments that use this slice from the left
+		for (unsigned int var : _rightSliceToSegments.getSegments(slice)) {
+			constraint.setCoefficient(var, 1.0);
+			LOG_ALL(solutionguarantorlog) << var << " is left segment" << std::endl;
 		}
-		for (SegmentHash segmentHash : rightSegments) {
-			constraint.setCoefficient(_hashToVariable[segmentHash], -1.0);
-			LOG_ALL(solutionguarantorlog) << _hashToVariable[segmentHash] << " is right segment" << std::endl;
+
+		// segments that use this slice from the right
+		for (unsigned int var : _leftSliceToSegments.getSegments(slice)) {
+			constraint.setCoefficient(var, -1.0);
+			LOG_ALL(solutionguarantorlog) << var << " is right segment" << std::endl;
 		}
 
 		constraint.setRelation(Equal);
@@ -401,38 +1128,36 @@ SolutionGuarantor::addExplicitConstraints(
 	typedef std::map<SegmentHash, double>::value_type segmentCoeff;
 	for (const SegmentConstraint& segmentConstraint : explicitConstraints) {
 		LinearConstraint constraint;
+		bool complete = true;
 
-		for (const segmentCoeff& coeff : segmentConstraint.getCoefficients())
-			constraint.setCoefficient(_hashToVariable[coeff.first], coeff.second);
+		for (const segmentCoeff& coeff : segmentConstraint.getCoefficients()) {
 
-		constraint.setRelation(segmentConstraint.getRelation());
-		constraint.setValue(segmentConstraint.getValue());
+			unsigned int var = _segmentIndex.find(coeff.first);
 
-		constraints.add(constraint);
-	}
-}
+			if (var == HashIndex::NotFound) {
 
-double
-SolutionGuarantor::getCost(const std::vector<double>& features) {
+				complete = false;
+				break;
+			}
 
-	if (features.size() != _weights.size())
-		UTIL_THROW_EXCEPTION(
-				UsageError,
-				"number of features " << features.size() << " does not match number of weights " << _weights.size());
+			constraint.setCoefficient(var, coeff.second);
+		}
 
-	double cost = 0;
+		// constraints on segments outside of the padded core can not be 
+		// enforced
+		if (!complete) {
 
-	std::vector<double>::const_iterator i = features.begin();
-	std::vector<double>::const_iterator j = _weights.begin();
+			LOG_DEBUG(solutionguarantorlog)
+					<< "skipping explicit constraint on segments outside of the padded core"
+					<< std::endl;
+			continue;
+		}
 
-	while (i != features.end()) {
+		constraint.setRelation(segmentConstraint.getRelation());
+		constraint.setValue(segmentConstraint.getValue());
 
-		cost += (*i)*(*j);
-		++i;
-		++j;
+		constraints.add(constraint);
 	}
-
-	return cost;
 }
 
 util::box<unsigned int, 3>
@@ -479,97 +1204,94 @@ SolutionGuarantor::cullSolutionToCore(
 	std::set<SegmentHash> solutionLookup(solution.begin(), solution.end());
 
 	util::box<unsigned int, 3> coreBoundingBox = _blockUtils.getBoundingBox(core);
-	util::box<unsigned int, 2> coreBoundingRect = coreBoundingBox.project<2>();
 
 	for (const SegmentDescription& segment : segments) {
 
 		SegmentHash segmentHash = segment.getHash();
 
-		if (solutionLookup.count(segmentHash)) {
-
-			// test in z
-			if (segment.getSection() >= coreBoundingBox.min().z() &&
-			    segment.getSection() <= coreBoundingBox.max().z() &&
-			    coreBoundingRect.intersects(segment.get2DBoundingBox())) {
-
-				culledSolution.push_back(segmentHash);
-			}
-		}
+		if (solutionLookup.count(segmentHash) && intersects(segment, coreBoundingBox))
+			culledSolution.push_back(segmentHash);
 	}
 
 	return culledSolution;
 }
 
+bool
+SolutionGuarantor::intersects(
+		const SegmentDescription&         segment,
+		const util::box<unsigned int, 3>& box) {
+
+	// test in z
+	return
+			segment.getSection() >= box.min().z() &&
+			segment.getSection() <= box.max().z() &&
+			box.project<2>().intersects(segment.get2DBoundingBox());
+}
+
 std::vector<std::set<SegmentHash> >
 SolutionGuarantor::extractAssemblies(
 		const std::vector<SegmentHash>& solution,
 		const SegmentDescriptions& segments) {
 
-	std::set<SegmentHash> solutionLookup(solution.begin(), solution.end());
-	std::set<SliceHash> unvisitedSlices;
-	std::stack<SliceHash> boundarySlices;
-	std::map<SliceHash, std::vector<SegmentHash> > sliceSegments;
-	std::map<SliceHash, std::vector<SliceHash> > sliceNeighbors;
-	std::vector<std::set<SegmentHash> > assemblies;
-
-	// Construct slice adjacency graph.
-	for (const SegmentDescription& segment : segments) {
+	// Assemblies are the connected components of the selected segments, where 
+	// two segments are connected if they share a slice. We give each selected 
+	// segment a dense index and merge it with the first selected segment seen 
+	// for each of its slices.
 
-		const SegmentHash segmentHash = segment.getHash();
+	HashIndex solutionIndex;
+	solutionIndex.build(std::vector<std::size_t>(solution.begin(), solution.end()));
 
-		if (solutionLookup.count(segmentHash)) {
+	std::vector<const SegmentDescription*> selected;
+	std::vector<std::size_t>               sliceHashes;
 
-			const std::vector<SliceHash>& leftSliceHashes = segment.getLeftSlices();
-			const std::vector<SliceHash>& rightSliceHashes = segment.getRightSlices();
-			unvisitedSlices.insert(leftSliceHashes.begin(), leftSliceHashes.end());
-			unvisitedSlices.insert(rightSliceHashes.begin(), rightSliceHashes.end());
-
-			for (const SliceHash leftHash : leftSliceHashes)
-				sliceSegments[leftHash].push_back(segmentHash);
-
-			for (const SliceHash rightHash : rightSliceHashes)
-				sliceSegments[rightHash].push_back(segmentHash);
+	for (const SegmentDescription& segment : segments) {
 
-			for (const SliceHash leftHash : leftSliceHashes) {
+		if (solutionIndex.find(segment.getHash()) == HashIndex::NotFound)
+			continue;
 
-				for (const SliceHash rightHash : rightSliceHashes) {
+		selected.push_back(&segment);
 
-					sliceNeighbors[leftHash].push_back(rightHash);
-					sliceNeighbors[rightHash].push_back(leftHash);
-				}
-			}
-		}
+		sliceHashes.insert(sliceHashes.end(), segment.getLeftSlices().begin(), segment.getLeftSlices().end());
+		sliceHashes.insert(sliceHashes.end(), segment.getRightSlices().begin(), segment.getRightSlices().end());
 	}
 
-	// Collect connected components (assemblies).
-	while (!unvisitedSlices.empty()) {
+	HashIndex sliceIndex;
+	sliceIndex.build(sliceHashes);
 
-		std::set<SegmentHash> assembly;
+	UnionFind components(selected.size());
+	std::vector<unsigned int> sliceSegment(sliceIndex.size(), static_cast<unsigned int>(HashIndex::NotFound));
 
-		SliceHash seedSlice = *(unvisitedSlices.begin());
-		boundarySlices.push(seedSlice);
+	for (unsigned int i = 0; i < selected.size(); i++)
+		for (const std::vector<SliceHash>* slices : { &selected[i]->getLeftSlices(), &selected[i]->getRightSlices() })
+			for (const SliceHash& sliceHash : *slices) {
 
-		while (!boundarySlices.empty()) {
+				unsigned int slice = sliceIndex.find(sliceHash);
 
-			SliceHash currentSlice = boundarySlices.top();
-			boundarySlices.pop();
+				if (sliceSegment[slice] == HashIndex::NotFound)
+					sliceSegment[slice] = i;
+				else
+					components.merge(sliceSegment[slice], i);
+			}
 
-			unvisitedSlices.erase(currentSlice);
+	// Collect the assemblies. They are ordered by their smallest slice hash, 
+	// as the slices are visited in that order.
 
-			const std::vector<SegmentHash>& currentSegments = sliceSegments[currentSlice];
-			assembly.insert(currentSegments.begin(), currentSegments.end());
+	std::vector<unsigned int> assemblyIds(selected.size(), static_cast<unsigned int>(HashIndex::NotFound));
+	std::vector<std::set<SegmentHash> > assemblies;
 
-			for (const SliceHash neighbor : sliceNeighbors[currentSlice]) {
+	for (unsigned int slice = 0; slice < sliceIndex.size(); slice++) {
 
-				if (unvisitedSlices.count(neighbor)) {
+		unsigned int root = components.find(sliceSegment[slice]);
 
-					boundarySlices.push(neighbor);
-				}
-			}
-		}
+		if (assemblyIds[root] == HashIndex::NotFound) {
 
-		assemblies.push_back(assembly);
+			assemblyIds[root] = assemblies.size();
+			assemblies.push_back(std::set<SegmentHash>());
+		}
 	}
 
+	for (unsigned int i = 0; i < selected.size(); i++)
+		assemblies[assemblyIds[components.find(i)]].insert(selected[i]->getHash());
+
 	return assemblies;
 }
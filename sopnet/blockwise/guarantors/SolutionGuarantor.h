@@ -1,6 +1,9 @@
 #ifndef SOLUTION_GUARANTOR_H__
 #define SOLUTION_GUARANTOR_H__
 
+#include <list>
+#include <map>
+
 #include <boost/shared_ptr.hpp>
 
 #include <blockwise/ProjectConfiguration.h>
@@ -8,10 +11,12 @@
 #include <blockwise/persistence/SliceStore.h>
 #include <blockwise/blocks/BlockUtils.h>
 #include <blockwise/blocks/Core.h>
+#include <blockwise/blocks/Cores.h>
+#include <blockwise/ilp/HashIndex.h>
+#include <blockwise/ilp/IlpSolver.h>
 
 #include <segments/SegmentHash.h>
 #include <solvers/LinearConstraints.h>
-#include <solvers/LinearObjective.h>
 
 class SolutionGuarantor {
 
@@ -35,7 +40,7 @@ public:
 	 *              The number of blocks to pad around a core in order to 
 	 *              eliminate border effects. The solution will be computed on 
 	 *              the padded core, but only the solution of the core will be 
-	 *              stored.
+	 *              stored. With adaptive padding, this is the initial padding.
 	 *
 	 * @param forceExplanation
 	 *              If true, exactly one member of each conflict set must be in
@@ -65,34 +70,341 @@ public:
 	 */
 	Blocks guaranteeSolution(const Core& core);
 
-protected:
+	/**
+	 * Solve a core again after the feature weights or the segment costs 
+	 * changed. If the ILP of the core was kept (see setKeepProblems()), only 
+	 * the objective is recomputed and the ILP is solved again, without reading 
+	 * the segments and constraints from the stores. Otherwise, this is the 
+	 * same as guaranteeSolution().
+	 *
+	 * @param core
+	 *              The core to compute the solution for.
+	 */
+	Blocks reoptimizeSolution(const Core& core);
+
+	/**
+	 * Solve cores again after explicit segment constraints were added to or 
+	 * removed from the segment store. All cores with a stored solution whose 
+	 * padded blocks (up to the maximal padding) contain one of the given 
+	 * blocks are considered. If the ILP of a core was kept (see 
+	 * setKeepProblems()), it is only solved again if its explicit constraints 
+	 * actually changed. Other cores are solved from scratch with 
+	 * guaranteeSolution().
+	 *
+	 * @param changedBlocks
+	 *              The blocks containing the slices of changed constraints.
+	 *
+	 * @return The cores that were solved again.
+	 */
+	Cores updateExplicitConstraints(const Blocks& changedBlocks);
+
+	/**
+	 * Set the number of independent components of the ILP to solve in 
+	 * parallel. 0 uses all hardware threads. Default is 1.
+	 */
+	void setNumComponentThreads(unsigned int numThreads) { _ilpSolver.setNumThreads(numThreads); }
+
+	/**
+	 * Set the pool of LinearSolvers to use. Share a pool between guarantors to 
+	 * reuse the solver backends between cores.
+	 */
+	void setSolverPool(boost::shared_ptr<LinearSolverPool> solverPool) { _ilpSolver.setSolverPool(solverPool); }
+
+	/**
+	 * If set, a greedy heuristic (see GreedySolver) is run before the ILP is 
+	 * solved, and its optimality gap is reported. Default is false.
+	 */
+	void setGreedyStart(bool greedyStart) { _greedyStart = greedyStart; }
+
+	/**
+	 * If set, the solution of the greedy heuristic is used directly, without 
+	 * solving the ILP. This is much faster, but not optimal. If the heuristic 
+	 * does not find a feasible solution, the ILP is solved instead. Default is 
+	 * false.
+	 */
+	void setApproximate(bool approximate) { _approximate = approximate; }
+
+	/**
+	 * Get the status of the solution of the last core. It is stored with the 
+	 * solution in the SegmentStore.
+	 */
+	const SolutionStatus& getSolutionStatus() const { return _solutionStatus; }
+
+	/**
+	 * Enable adaptive padding. If the solution in the core is connected to 
+	 * segments in the outermost padding blocks, the padding is grown by one 
+	 * block on the affected faces and the padded core is solved again. This 
+	 * is repeated until the solution in the core does not change anymore, no 
+	 * face is affected, or the maximal padding is reached.
+	 *
+	 * @param maxCorePadding
+	 *              The maximal padding on each face. Adaptive padding is 
+	 *              disabled if this is not larger than the core padding, which 
+	 *              is the default.
+	 */
+	void setAdaptivePadding(unsigned int maxCorePadding) { _maxCorePadding = maxCorePadding; }
+
+	/**
+	 * If set, the stored solutions of already solved neighbouring cores are 
+	 * used as boundary conditions: Segments of the padded core that lie in a 
+	 * solved neighbour (and not in the core itself) are fixed to their value 
+	 * in the stored solution. This allows a much smaller padding. Segments 
+	 * that cross the seam between the core and a neighbour stay free, 
+	 * disagreements with the neighbour's solution on them are reported. So 
+	 * do segments on which the neighbours disagree. If the fixed segments 
+	 * still make the ILP infeasible, it is solved without them and the 
+	 * solution is stored with the status Unstitched. Default is false.
+	 */
+	void setStitching(bool stitching) { _stitching = stitching; }
+
+	/**
+	 * Get the number of seam segments on which the solution of the last core 
+	 * disagrees with the stored solutions of its neighbours. Only computed 
+	 * with stitching enabled.
+	 */
+	unsigned int getNumSeamDisagreements() const { return _numSeamDisagreements; }
+
+	/**
+	 * If set, the segments and constraints of the ILP of each solved core are 
+	 * kept in memory for reoptimizeSolution(). With read costs enabled, the 
+	 * segment costs are read again on re-optimization, otherwise they are 
+	 * computed from the kept features and the current weights. Default is 
+	 * false.
+	 */
+	void setKeepProblems(bool keepProblems) { _keepProblems = keepProblems; }
+
+	/**
+	 * Set the maximal number of ILPs to keep with setKeepProblems(). If more 
+	 * cores are solved, the ILP of the least recently solved or re-optimized 
+	 * core is dropped. Cores without a kept ILP are solved from scratch. 
+	 * Default is 64.
+	 */
+	void setMaxKeptProblems(unsigned int maxProblems) { _maxKeptProblems = maxProblems; }
+
+	/**
+	 * The size of the ILP of a solved core and the time it took.
+	 */
+	struct SolveStatistics {
+
+		SolveStatistics() :
+			numVariables(0),
+			numConstraints(0),
+			seconds(0) {}
 
-	std::vector<std::set<SegmentHash> > extractAssemblies(
+		unsigned int numVariables;
+		unsigned int numConstraints;
+
+		// wall time of guaranteeSolution(), including reading from the stores 
+		// and growing the padding
+		double seconds;
+	};
+
+	/**
+	 * Get the statistics of the last core solved with guaranteeSolution().
+	 */
+	const SolveStatistics& getSolveStatistics() const { return _solveStatistics; }
+
+	/**
+	 * Group the segments of a solution into assemblies, the connected 
+	 * components of segments that share slices. The assemblies are ordered by 
+	 * their smallest slice hash.
+	 *
+	 * @param solution
+	 *              The hashes of the selected segments.
+	 * @param segments
+	 *              The descriptions of at least the selected segments.
+	 */
+	static std::vector<std::set<SegmentHash> > extractAssemblies(
 			const std::vector<SegmentHash>& solution,
 			const SegmentDescriptions& segments);
 
 private:
 
+	// the padding of a core in blocks for each face
+	struct Padding {
+
+		Padding(unsigned int padding) :
+			posX(padding), posY(padding), posZ(padding),
+			negX(padding), negY(padding), negZ(padding) {}
+
+		// remove one block from each face
+		void shrink() {
+
+			posX = (posX > 0 ? posX - 1 : 0);
+			posY = (posY > 0 ? posY - 1 : 0);
+			posZ = (posZ > 0 ? posZ - 1 : 0);
+			negX = (negX > 0 ? negX - 1 : 0);
+			negY = (negY > 0 ? negY - 1 : 0);
+			negZ = (negZ > 0 ? negZ - 1 : 0);
+		}
+
+		unsigned int posX, posY, posZ;
+		unsigned int negX, negY, negZ;
+	};
+
+	// a range of segment variables
+	struct SegmentRange {
+
+		SegmentRange(const unsigned int* begin_, const unsigned int* end_) :
+			_begin(begin_),
+			_end(end_) {}
+
+		const unsigned int* begin() const { return _begin; }
+		const unsigned int* end() const { return _end; }
+
+	private:
+
+		const unsigned int* _begin;
+		const unsigned int* _end;
+	};
+
+	// for each slice, the variables of the segments that use it on one side, 
+	// in compressed row storage: the segments of slice i are 
+	// segments[begin[i]] to segments[begin[i+1] - 1]
+	struct SliceSegments {
+
+		unsigned int numSegments(unsigned int slice) const { return begin[slice + 1] - begin[slice]; }
+
+		SegmentRange getSegments(unsigned int slice) const {
+
+			return SegmentRange(segments.data() + begin[slice], segments.data() + begin[slice + 1]);
+		}
+
+		std::vector<unsigned int> begin;
+		std::vector<unsigned int> segments;
+	};
+
+	// get the segments of the padded core and solve it, returns the missing 
+	// blocks, if any
+	Blocks solvePaddedCore(
+			const Core&                             core,
+			const Padding&                          padding,
+			boost::shared_ptr<SegmentDescriptions>& segments,
+			std::vector<SegmentHash>&               solution);
+
 	// get all blocks of the padded core
-	Blocks getPaddedCoreBlocks(const Core& core);
+	Blocks getPaddedCoreBlocks(const Core& core, const Padding& padding);
+
+	// get all cores whose padded blocks might contain one of the given blocks
+	Cores getAffectedCores(const Blocks& changedBlocks);
+
+	// create constraints that fix the segments of solved neighbouring cores 
+	// to their stored solution
+	SegmentConstraints createStitchingConstraints(
+			const Core&                core,
+			const Blocks&              blocks,
+			const SegmentDescriptions& segments);
+
+	// count the seam segments on which the solution disagrees with the 
+	// neighbouring solutions
+	void checkSeams(
+			const Core&                     core,
+			const std::vector<SegmentHash>& solution);
+
+	// grow the padding on the faces that assemblies in the core get close to, 
+	// returns false if no face was grown
+	bool growPadding(
+			const Core&                     core,
+			const SegmentDescriptions&      segments,
+			const std::vector<SegmentHash>& solution,
+			const std::vector<SegmentHash>& culledSolution,
+			Padding&                        padding);
+
+	// the ILP of a core, kept for re-optimizations
+	struct CoreProblem {
+
+		Blocks                                 blocks;
+		boost::shared_ptr<SegmentDescriptions> segments;
+		HashIndex                              segmentIndex;
+		boost::shared_ptr<LinearConstraints>   constraints;
+		std::vector<double>                    values;
+
+		// the number of constraints before the explicit ones
+		unsigned int                           numStructuralConstraints;
+
+		// the number of stitching constraints after the explicit ones
+		unsigned int                           numStitchingConstraints;
+
+		// fingerprint of the explicit constraints read from the segment store
+		std::size_t                            explicitConstraints;
+
+		// the position of the core in _problemOrder
+		std::list<Core>::iterator              position;
+	};
+
+	// get the kept ILP of a core, or keep a new one, dropping the least 
+	// recently used ones if there are too many
+	CoreProblem& keepProblem(const Core& core);
+
+	// mark a kept ILP as the most recently used one
+	void touchProblem(CoreProblem& problem);
+
+	void dropProblem(std::map<Core, CoreProblem>::iterator i);
+
+	// solve a kept ILP again and store the solution of the core, returns the 
+	// solution of the padded core
+	std::vector<SegmentHash> resolveProblem(const Core& core, CoreProblem& problem);
+
+	// an order-independent fingerprint of a set of explicit constraints
+	static std::size_t getFingerprint(const SegmentConstraints& constraints);
+
+	// extract the assemblies of the culled solution and store them with the 
+	// solution status
+	void storeSolution(
+			const std::vector<SegmentHash>& culledSolution,
+			const SegmentDescriptions&      segments,
+			const Core&                     core);
 
 	std::vector<SegmentHash> computeSolution(
 			const SegmentDescriptions& segments,
 			const ConflictSets&        conflictSets,
-			const SegmentConstraints&  explicitConstraints);
+			const SegmentConstraints&  explicitConstraints,
+			const SegmentConstraints&  stitchingConstraints);
+
+	// solve the ILP, using the greedy heuristic (from the start, if not empty) 
+	// and the ILP solver as configured, returns the value of each variable
+	std::vector<double> solveIlp(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints,
+			const std::vector<double>& start);
+
+	// solve the ILP with solveIlp(), if the last numStitchingConstraints 
+	// constraints make it infeasible, drop them and solve it again
+	std::vector<double> solveStitchedIlp(
+			const std::vector<double>&            costs,
+			boost::shared_ptr<LinearConstraints>& constraints,
+			unsigned int&                         numStitchingConstraints,
+			const std::vector<double>&            start);
+
+	// get the hashes of the segments that are part of the solution
+	std::vector<SegmentHash> getSolutionSegments(const std::vector<double>& solution);
+
+	// assign dense indices to the segments and slices and create the slice to 
+	// segment mappings
+	void createIndices(const SegmentDescriptions& segments);
 
 	boost::shared_ptr<LinearConstraints> createConstraints(
 			const SegmentDescriptions& segments,
 			const ConflictSets&        conflictSets,
-			const SegmentConstraints&  explicitConstraints);
+			const SegmentConstraints&  explicitConstraints,
+			const SegmentConstraints&  stitchingConstraints);
+
+	// get the cost of each variable
+	std::vector<double> createObjective(const SegmentDescriptions& segments);
 
-	boost::shared_ptr<LinearObjective> createObjective(const SegmentDescriptions& segments);
+	// throw if a feature with a non-zero weight was skipped during the 
+	// extraction of the segment
+	void checkSkippedFeatures(const SegmentDescription& segment);
 
 	void addOverlapConstraints(
 			const SegmentDescriptions& segments,
 			const ConflictSets&        conflictSets,
 			LinearConstraints&         constraints);
 
+	// get the variables of the segments that use the slice on the left side, 
+	// or on the right side if there are none on the left
+	SegmentRange getSliceSegments(unsigned int slice) const;
+
 	void addContinuationConstraints(
 			const SegmentDescriptions& segments,
 			LinearConstraints&         constraints);
@@ -101,8 +413,6 @@ private:
 			const SegmentConstraints&  explicitConstraints,
 			LinearConstraints&         constraints);
 
-	double getCost(const std::vector<double>& features);
-
 	util::box<unsigned int, 3> segmentsBoundingBox(const SegmentDescriptions& segments);
 
 	std::vector<SegmentHash> cullSolutionToCore(
@@ -110,34 +420,69 @@ private:
 			const SegmentDescriptions& segments,
 			const Core& core);
 
+	// check whether a segment lies in the given box
+	static bool intersects(
+			const SegmentDescription&         segment,
+			const util::box<unsigned int, 3>& box);
+
 	boost::shared_ptr<SegmentStore> _segmentStore;
 	boost::shared_ptr<SliceStore>   _sliceStore;
 
 	unsigned int _corePadding;
+	unsigned int _maxCorePadding;
 
 	bool _forceExplanation;
 	bool _readCosts;
 	bool _storeCosts;
+	bool _greedyStart;
+	bool _approximate;
+	bool _stitching;
+	bool _keepProblems;
+	unsigned int _maxKeptProblems;
 
-	// mappings from segment hashes to their variable number in the ILP
-	std::map<SegmentHash, unsigned int> _hashToVariable;
-	std::map<unsigned int, SegmentHash> _variableToHash;
+	// dense indices of the segments (the variables of the ILP) and slices of 
+	// the current padded core
+	HashIndex _segmentIndex;
+	HashIndex _sliceIndex;
 
-	// mappings from slice hashes to hashes of segments that use the slice 
+	// mappings from slices to the variables of segments that use the slice 
 	// either on the left or right side
-	std::map<SliceHash, std::vector<SegmentHash> > _leftSliceToSegments;
-	std::map<SliceHash, std::vector<SegmentHash> > _rightSliceToSegments;
+	SliceSegments _leftSliceToSegments;
+	SliceSegments _rightSliceToSegments;
 
-	// set of all slices
-	std::set<SliceHash> _slices;
+	// for each slice, whether it is a leaf slice (has no end segment)
+	std::vector<bool> _leafSlices;
 
-	// set of all slices not associated to the request blocks
-	std::set<SliceHash> _leafSlices;
+	// the constraints and solution of the last ILP
+	boost::shared_ptr<LinearConstraints> _constraints;
+	std::vector<double>                  _values;
+	unsigned int                         _numStructuralConstraints;
+	unsigned int                         _numStitchingConstraints;
+	std::size_t                          _explicitConstraintsFingerprint;
+
+	// the kept ILPs of solved cores, and their cores from the most to the 
+	// least recently used
+	std::map<Core, CoreProblem> _problems;
+	std::list<Core>             _problemOrder;
 
 	// the feature weights
 	std::vector<double> _weights;
 
+	// how the last solution was obtained
+	SolutionStatus _solutionStatus;
+
+	SolveStatistics _solveStatistics;
+
+	// the stored solutions of the solved neighbouring cores and the segments 
+	// on the seams to them, used for stitching
+	std::set<SegmentHash> _neighbourSolution;
+	std::set<SegmentHash> _seamSegments;
+
+	unsigned int _numSeamDisagreements;
+
 	BlockUtils _blockUtils;
+
+	IlpSolver _ilpSolver;
 };
 
 #endif //SOLUTION_GUARANTOR_H__
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
+#include <threads/ThreadPool.h>
+#include <util/Logger.h>
+#include "SolutionScheduler.h"
+
+logger::LogChannel solutionschedulerlog("solutionschedulerlog", "[SolutionScheduler] ");
+
+SolutionScheduler::SolutionScheduler(
+		const ProjectConfiguration& projectConfiguration,
+		unsigned int                corePadding,
+		GuarantorFactory            createGuarantor) :
+	_corePadding(corePadding),
+	_createGuarantor(createGuarantor),
+	_numThreads(0),
+	_blockUtils(projectConfiguration) {
+
+	_costEstimator = [this](const Core& core) { return static_cast<double>(getPaddedCoreBlocks(core).size()); };
+}
+
+Blocks
+SolutionScheduler::guaranteeSolutions(const Cores& cores) {
+
+	std::list<Job> pending;
+
+	_solveStatistics.clear();
+
+	for (const Core& core : cores)
+		pending.push_back(Job(core, _blockUtils.getBoundingBox(getPaddedCoreBlocks(core)), _costEstimator(core)));
+
+	if (pending.empty())
+		return Blocks();
+
+	// largest cores first
+	pending.sort([](const Job& a, const Job& b) { return a.cost > b.cost; });
+
+	// split the thread budget between cores and components
+	unsigned int numThreads          = ThreadPool::resolveNumThreads(_numThreads);
+	unsigned int numWorkers          = std::min(numThreads, static_cast<unsigned int>(pending.size()));
+	unsigned int numComponentThreads = std::max(1u, numThreads/numWorkers);
+
+	LOG_DEBUG(solutionschedulerlog)
+			<< "solving " << pending.size() << " cores with " << numWorkers
+			<< " workers and " << numComponentThreads << " component threads each"
+			<< std::endl;
+
+	std::vector<boost::shared_ptr<SolutionGuarantor> > idle;
+
+	for (unsigned int i = 0; i < numWorkers; i++) {
+
+		boost::shared_ptr<SolutionGuarantor> guarantor = _createGuarantor();
+		guarantor->setNumComponentThreads(numComponentThreads);
+
+		idle.push_back(guarantor);
+	}
+
+	std::list<Job> running;
+	Blocks         missingBlocks;
+
+	std::mutex              mutex;
+	std::condition_variable finished;
+
+	ThreadPool threadPool(numWorkers);
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!pending.empty()) {
+
+		// find the largest core that does not overlap with the running ones
+		std::list<Job>::iterator next = pending.end();
+
+		if (!idle.empty())
+			next = std::find_if(pending.begin(), pending.end(), [&running](const Job& job) {
+
+				for (const Job& other : running)
+					if (overlap(job.paddedBox, other.paddedBox))
+						return false;
+
+				return true;
+			});
+
+		if (next == pending.end()) {
+
+			finished.wait(lock);
+			continue;
+		}
+
+		// move the job to the running ones, the iterator stays valid
+		running.splice(running.end(), pending, next);
+
+		boost::shared_ptr<SolutionGuarantor> guarantor = idle.back();
+		idle.pop_back();
+
+		std::function<void(const Blocks&, bool)> finish = [&, next, guarantor](const Blocks& missing, bool solved) {
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			missingBlocks.addAll(missing);
+
+			if (solved && missing.empty())
+				_solveStatistics[next->core] = guarantor->getSolveStatistics();
+
+			running.erase(next);
+			idle.push_back(guarantor);
+
+			finished.notify_one();
+		};
+
+		threadPool.schedule([next, guarantor, finish]() {
+
+			Blocks missing;
+
+			try {
+
+				missing = guarantor->guaranteeSolution(next->core);
+
+			} catch (...) {
+
+				finish(missing, false);
+				throw;
+			}
+
+			finish(missing, true);
+		});
+	}
+
+	lock.unlock();
+
+	threadPool.wait();
+
+	LOG_DEBUG(solutionschedulerlog) << "done" << std::endl;
+
+	return missingBlocks;
+}
+
+Blocks
+SolutionScheduler::getPaddedCoreBlocks(const Core& core) {
+
+	Blocks blocks = _blockUtils.getCoreBlocks(core);
+
+	_blockUtils.expand(
+			blocks,
+			_corePadding, _corePadding, _corePadding,
+			_corePadding, _corePadding, _corePadding);
+
+	return blocks;
+}
+
+bool
+SolutionScheduler::overlap(const util::box<unsigned int, 3>& a, const util::box<unsigned int, 3>& b) {
+
+	return
+			a.min().x() < b.max().x() && b.min().x() < a.max().x() &&
+			a.min().y() < b.max().y() && b.min().y() < a.max().y() &&
+			a.min().z() < b.max().z() && b.min().z() < a.max().z();
+}
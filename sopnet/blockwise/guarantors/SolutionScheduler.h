@@ -0,0 +1,128 @@
+#ifndef SOPNET_BLOCKWISE_GUARANTORS_SOLUTION_SCHEDULER_H__
+#define SOPNET_BLOCKWISE_GUARANTORS_SOLUTION_SCHEDULER_H__
+
+#include <functional>
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+
+#include <blockwise/ProjectConfiguration.h>
+#include <blockwise/blocks/BlockUtils.h>
+#include <blockwise/blocks/Blocks.h>
+#include <blockwise/blocks/Cores.h>
+#include "SolutionGuarantor.h"
+
+/**
+ * Solves a set of cores in parallel. Cores are processed in the order of their
+ * estimated ILP size, largest first. Two cores are not solved at the same time
+ * if their padded regions overlap, since both would read and write the costs
+ * of the same segments.
+ *
+ * The scheduler owns one SolutionGuarantor (and with it one set of stores,
+ * i.e., one database connection) per worker thread, which is reused for all
+ * cores the worker solves. The thread budget is split between the number of
+ * cores solved at the same time and the number of threads each of them uses
+ * to solve its ILP components.
+ */
+class SolutionScheduler {
+
+public:
+
+	/**
+	 * Creates a configured SolutionGuarantor with its own stores.
+	 */
+	typedef std::function<boost::shared_ptr<SolutionGuarantor>()> GuarantorFactory;
+
+	/**
+	 * Estimates the cost of solving a core, e.g., the number of segments in its
+	 * padded region.
+	 */
+	typedef std::function<double(const Core&)> CostEstimator;
+
+	/**
+	 * Create a new scheduler.
+	 *
+	 * @param projectConfiguration
+	 *              The ProjectConfiguration used to configure Block and Core
+	 *              parameters.
+	 *
+	 * @param corePadding
+	 *              The (maximal) core padding used by the guarantors.
+	 *
+	 * @param createGuarantor
+	 *              Creates one SolutionGuarantor per worker. It is called from
+	 *              the thread calling guaranteeSolutions(). The guarantors
+	 *              should share a LinearSolverPool.
+	 */
+	SolutionScheduler(
+			const ProjectConfiguration& projectConfiguration,
+			unsigned int                corePadding,
+			GuarantorFactory            createGuarantor);
+
+	/**
+	 * Set the total number of threads to use. 0 uses all hardware threads.
+	 * Default is 0.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * Set the function to estimate the cost of solving a core. By default, the
+	 * number of blocks in the padded core is used.
+	 */
+	void setCostEstimator(CostEstimator costEstimator) { _costEstimator = costEstimator; }
+
+	/**
+	 * Get the solutions for the given cores.
+	 *
+	 * @param cores
+	 *              The cores to compute the solutions for.
+	 *
+	 * @return
+	 *              The blocks for which segments are missing to solve some of
+	 *              the cores. Empty on success.
+	 */
+	Blocks guaranteeSolutions(const Cores& cores);
+
+	/**
+	 * Get the statistics of the cores solved by the last call to 
+	 * guaranteeSolutions(), as recorded by the guarantors.
+	 */
+	const std::map<Core, SolutionGuarantor::SolveStatistics>& getSolveStatistics() const { return _solveStatistics; }
+
+private:
+
+	struct Job {
+
+		Job(const Core& core_, const util::box<unsigned int, 3>& paddedBox_, double cost_) :
+			core(core_),
+			paddedBox(paddedBox_),
+			cost(cost_) {}
+
+		Core core;
+
+		// the bounding box of the padded core
+		util::box<unsigned int, 3> paddedBox;
+
+		double cost;
+	};
+
+	// get all blocks of the padded core
+	Blocks getPaddedCoreBlocks(const Core& core);
+
+	static bool overlap(const util::box<unsigned int, 3>& a, const util::box<unsigned int, 3>& b);
+
+	unsigned int _corePadding;
+
+	GuarantorFactory _createGuarantor;
+
+	CostEstimator _costEstimator;
+
+	unsigned int _numThreads;
+
+	std::map<Core, SolutionGuarantor::SolveStatistics> _solveStatistics;
+
+	BlockUtils _blockUtils;
+};
+
+#endif // SOPNET_BLOCKWISE_GUARANTORS_SOLUTION_SCHEDULER_H__
+
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <deque>
+
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include "GreedySolver.h"
+
+logger::LogChannel greedysolverlog("greedysolverlog", "[GreedySolver] ");
+
+namespace {
+
+// tolerance for comparing row activities
+const double Tolerance = 1e-6;
+
+// minimal cost improvement for a move to be accepted
+const double CostTolerance = 1e-9;
+
+}
+
+GreedySolver::GreedySolver() :
+	_maxMoveSize(32),
+	_maxPasses(10),
+	_numViolated(0),
+	_cost(0),
+	_numMoves(0) {}
+
+std::vector<double>
+GreedySolver::solve(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		const std::vector<double>& start) {
+
+	if (!start.empty() && start.size() != costs.size())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"start solution has " << start.size() << " values, but there are " << costs.size() << " variables");
+
+	initialize(costs, constraints, start);
+
+	LOG_DEBUG(greedysolverlog)
+			<< "starting with cost " << _cost << " and "
+			<< _numViolated << " violated constraints" << std::endl;
+
+	// try the cheapest variables first
+	std::vector<unsigned int> order(costs.size());
+	for (unsigned int var = 0; var < order.size(); var++)
+		order[var] = var;
+
+	std::stable_sort(
+			order.begin(),
+			order.end(),
+			[&costs](unsigned int a, unsigned int b) { return costs[a] < costs[b]; });
+
+	for (unsigned int pass = 0; pass < _maxPasses; pass++) {
+
+		unsigned int numAccepted = 0;
+
+		for (unsigned int var : order)
+			if (tryMove(var))
+				numAccepted++;
+
+		LOG_DEBUG(greedysolverlog)
+				<< "pass " << pass << ": accepted " << numAccepted
+				<< " moves, cost is " << _cost << ", "
+				<< _numViolated << " violated constraints" << std::endl;
+
+		if (numAccepted == 0)
+			break;
+	}
+
+	if (_numViolated > 0)
+		LOG_DEBUG(greedysolverlog)
+				<< "could not find a feasible solution, " << _numViolated
+				<< " constraints are violated" << std::endl;
+
+	return std::vector<double>(_values.begin(), _values.end());
+}
+
+void
+GreedySolver::initialize(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints,
+		const std::vector<double>& start) {
+
+	const unsigned int numVariables = costs.size();
+
+	_costs = costs;
+
+	_rows.clear();
+	_rowCoefficients.clear();
+	_variableRows.assign(numVariables, std::vector<std::pair<unsigned int, double> >());
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		unsigned int row = _rows.size();
+
+		Row r;
+		r.relation = constraint.getRelation();
+		r.value    = constraint.getValue();
+
+		_rows.push_back(r);
+		_rowCoefficients.push_back(std::vector<std::pair<unsigned int, double> >(
+				constraint.getCoefficients().begin(),
+				constraint.getCoefficients().end()));
+
+		for (const std::pair<const unsigned int, double>& coefficient : constraint.getCoefficients())
+			_variableRows[coefficient.first].push_back(std::make_pair(row, coefficient.second));
+	}
+
+	_values.assign(numVariables, 0);
+	if (!start.empty())
+		for (unsigned int var = 0; var < numVariables; var++)
+			_values[var] = (start[var] > 0.5 ? 1 : 0);
+
+	_cost = 0;
+	for (unsigned int var = 0; var < numVariables; var++)
+		_cost += _values[var]*costs[var];
+
+	_activities.assign(_rows.size(), 0.0);
+	for (unsigned int row = 0; row < _rows.size(); row++)
+		for (const std::pair<unsigned int, double>& coefficient : _rowCoefficients[row])
+			_activities[row] += coefficient.second*_values[coefficient.first];
+
+	_numViolated = 0;
+	for (unsigned int row = 0; row < _rows.size(); row++)
+		if (violation(row, _activities[row]) != 0)
+			_numViolated++;
+
+	_move.clear();
+	_touched.clear();
+	_inMove.assign(numVariables, 0);
+	_deltas.assign(_rows.size(), 0.0);
+	_isTouched.assign(_rows.size(), 0);
+
+	_numMoves = 0;
+}
+
+bool
+GreedySolver::tryMove(unsigned int seed) {
+
+	flip(seed);
+
+	std::deque<unsigned int> rows(_touched.begin(), _touched.end());
+
+	// repair the rows touched by the move
+	while (!rows.empty() && _move.size() < _maxMoveSize) {
+
+		unsigned int row = rows.front();
+		rows.pop_front();
+
+		int direction = violation(row, _activities[row] + _deltas[row]);
+
+		if (direction == 0)
+			continue;
+
+		unsigned int candidate;
+		if (!findCandidate(row, direction, candidate))
+			continue;
+
+		flip(candidate);
+
+		rows.push_back(row);
+		for (const std::pair<unsigned int, double>& coefficient : _variableRows[candidate])
+			if (coefficient.first != row)
+				rows.push_back(coefficient.first);
+	}
+
+	int violatedChange = 0;
+	for (unsigned int row : _touched)
+		violatedChange +=
+				(violation(row, _activities[row] + _deltas[row]) != 0) -
+				(violation(row, _activities[row]) != 0);
+
+	double costChange = 0;
+	for (unsigned int var : _move)
+		costChange += _costs[var]*(flipped(var) - _values[var]);
+
+	bool accept = (violatedChange < 0 || (violatedChange == 0 && costChange < -CostTolerance));
+
+	if (accept) {
+
+		for (unsigned int var : _move)
+			_values[var] = flipped(var);
+
+		for (unsigned int row : _touched)
+			_activities[row] += _deltas[row];
+
+		_numViolated += violatedChange;
+		_cost        += costChange;
+		_numMoves++;
+	}
+
+	for (unsigned int var : _move)
+		_inMove[var] = 0;
+
+	for (unsigned int row : _touched) {
+
+		_deltas[row]    = 0;
+		_isTouched[row] = 0;
+	}
+
+	_move.clear();
+	_touched.clear();
+
+	return accept;
+}
+
+void
+GreedySolver::flip(unsigned int var) {
+
+	_inMove[var] = 1;
+	_move.push_back(var);
+
+	double change = flipped(var) - _values[var];
+
+	for (const std::pair<unsigned int, double>& coefficient : _variableRows[var]) {
+
+		unsigned int row = coefficient.first;
+
+		if (!_isTouched[row]) {
+
+			_isTouched[row] = 1;
+			_touched.push_back(row);
+		}
+
+		_deltas[row] += change*coefficient.second;
+	}
+}
+
+bool
+GreedySolver::findCandidate(unsigned int row, int direction, unsigned int& candidate) {
+
+	bool         found           = false;
+	unsigned int bestViolations  = 0;
+	double       bestCostChange  = 0;
+
+	for (const std::pair<unsigned int, double>& coefficient : _rowCoefficients[row]) {
+
+		unsigned int var = coefficient.first;
+
+		if (_inMove[var])
+			continue;
+
+		double change = flipped(var) - _values[var];
+
+		// does flipping the variable reduce the violation?
+		if (change*coefficient.second*direction <= 0)
+			continue;
+
+		// the number of other rows that would become violated
+		unsigned int violations = 0;
+		for (const std::pair<unsigned int, double>& other : _variableRows[var]) {
+
+			if (other.first == row)
+				continue;
+
+			double activity = _activities[other.first] + _deltas[other.first];
+
+			if (violation(other.first, activity) == 0 &&
+			    violation(other.first, activity + change*other.second) != 0)
+				violations++;
+		}
+
+		double costChange = _costs[var]*change;
+
+		if (!found ||
+		    violations < bestViolations ||
+		    (violations == bestViolations && costChange < bestCostChange)) {
+
+			found          = true;
+			candidate      = var;
+			bestViolations = violations;
+			bestCostChange = costChange;
+		}
+	}
+
+	return found;
+}
+
+int
+GreedySolver::violation(unsigned int row, double activity) const {
+
+	const Row& r = _rows[row];
+
+	if (r.relation != GreaterEqual && activity > r.value + Tolerance)
+		return -1;
+
+	if (r.relation != LessEqual && activity < r.value - Tolerance)
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+#ifndef SOPNET_BLOCKWISE_ILP_GREEDY_SOLVER_H__
+#define SOPNET_BLOCKWISE_ILP_GREEDY_SOLVER_H__
+
+#include <vector>
+
+#include <solvers/LinearConstraints.h>
+
+/**
+ * Approximately solves binary ILPs of the form
+ *
+ *   min c'x  s.t.  Ax (<=,==,>=) b,  x in {0,1}^n
+ *
+ * without an ILP solver, by local search over "moves": A move flips a seed
+ * variable and then, as long as one of the touched constraints is violated,
+ * flips the cheapest variable of that constraint that reduces the violation
+ * (and violates the fewest other constraints). For the SolutionGuarantor
+ * model, switching on a continuation segment this way pulls in the segments
+ * needed to satisfy the continuation constraints at both of its slices, and
+ * switching on a segment in a conflict set switches off the conflicting
+ * segment.
+ *
+ * A move is accepted, if it reduces the number of violated constraints, or
+ * keeps it and reduces the cost. Starting from the given start solution (or
+ * all zeros), moves are tried on all variables, lowest cost first, until no
+ * more moves are accepted. The first pass picks the lowest-cost segments, the
+ * following ones repair and improve the solution.
+ */
+class GreedySolver {
+
+public:
+
+	GreedySolver();
+
+	/**
+	 * The maximal number of variables flipped in a single move. Default is 32.
+	 */
+	void setMaxMoveSize(unsigned int size) { _maxMoveSize = size; }
+
+	/**
+	 * The maximal number of passes over all variables. Default is 10.
+	 */
+	void setMaxPasses(unsigned int passes) { _maxPasses = passes; }
+
+	/**
+	 * Find a good solution of the ILP.
+	 *
+	 * @param costs
+	 *              The cost of each variable.
+	 * @param constraints
+	 *              The linear constraints on the variables.
+	 * @param start
+	 *              An optional solution to start the search from. Empty, if
+	 *              the search should start with all variables set to 0.
+	 * @return
+	 *              The value (0 or 1) of each variable in the best solution
+	 *              found.
+	 */
+	std::vector<double> solve(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints,
+			const std::vector<double>& start = std::vector<double>());
+
+	/**
+	 * True, if the solution found in the last call to solve() satisfies all
+	 * constraints.
+	 */
+	bool isFeasible() const { return _numViolated == 0; }
+
+	/**
+	 * The cost of the solution found in the last call to solve().
+	 */
+	double getCost() const { return _cost; }
+
+	/**
+	 * The number of moves accepted in the last call to solve().
+	 */
+	unsigned int getNumMoves() const { return _numMoves; }
+
+private:
+
+	struct Row {
+
+		Relation relation;
+		double   value;
+	};
+
+	// set up rows, activities, and the start solution
+	void initialize(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints,
+			const std::vector<double>& start);
+
+	// try a move starting with the given variable, apply it if it improves
+	// the solution
+	bool tryMove(unsigned int seed);
+
+	// add a variable to the current move
+	void flip(unsigned int var);
+
+	// find the best variable to flip to reduce the violation of the given row
+	// in the given direction, returns false if there is none
+	bool findCandidate(unsigned int row, int direction, unsigned int& candidate);
+
+	// +1 if the activity of the row has to increase to satisfy it, -1 if it
+	// has to decrease, 0 if it is satisfied
+	int violation(unsigned int row, double activity) const;
+
+	// the value of a variable after it is flipped
+	int flipped(unsigned int var) const { return 1 - _values[var]; }
+
+	unsigned int _maxMoveSize;
+
+	unsigned int _maxPasses;
+
+	std::vector<Row> _rows;
+
+	// the coefficients of the rows each variable appears in
+	std::vector<std::vector<std::pair<unsigned int, double> > > _variableRows;
+
+	// the coefficients of each row
+	std::vector<std::vector<std::pair<unsigned int, double> > > _rowCoefficients;
+
+	std::vector<double> _costs;
+
+	// the current solution and the activity of each row
+	std::vector<int>    _values;
+	std::vector<double> _activities;
+
+	// the variables flipped by the current move, the change of the row
+	// activities, and the rows touched by it
+	std::vector<unsigned int> _move;
+	std::vector<char>         _inMove;
+	std::vector<double>       _deltas;
+	std::vector<unsigned int> _touched;
+	std::vector<char>         _isTouched;
+
+	unsigned int _numViolated;
+
+	double _cost;
+
+	unsigned int _numMoves;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_GREEDY_SOLVER_H__
+
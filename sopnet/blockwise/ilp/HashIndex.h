@@ -0,0 +1,106 @@
+#ifndef SOPNET_BLOCKWISE_ILP_HASH_INDEX_H__
+#define SOPNET_BLOCKWISE_ILP_HASH_INDEX_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * Assigns dense indices [0, size) to a set of hashes, in the order of the
+ * hashes. Lookups go through an open-addressing table with linear probing,
+ * which holds at most half as many entries as it has slots.
+ */
+class HashIndex {
+
+public:
+
+	static const unsigned int NotFound = std::numeric_limits<unsigned int>::max();
+
+	HashIndex() : _mask(0) {}
+
+	/**
+	 * Build the index for the given hashes. Duplicates are removed.
+	 */
+	void build(std::vector<std::size_t> hashes) {
+
+		std::sort(hashes.begin(), hashes.end());
+		hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+		_hashes.swap(hashes);
+
+		std::size_t numSlots = 2;
+		while (numSlots < 2*_hashes.size())
+			numSlots *= 2;
+
+		_mask = numSlots - 1;
+		_table.assign(numSlots, static_cast<unsigned int>(NotFound));
+
+		for (unsigned int i = 0; i < _hashes.size(); i++) {
+
+			std::size_t slot = mix(_hashes[i]) & _mask;
+
+			while (_table[slot] != NotFound)
+				slot = (slot + 1) & _mask;
+
+			_table[slot] = i;
+		}
+	}
+
+	/**
+	 * Get the index of a hash, or NotFound if it is not in the index.
+	 */
+	unsigned int find(std::size_t hash) const {
+
+		if (_hashes.empty())
+			return NotFound;
+
+		std::size_t slot = mix(hash) & _mask;
+
+		while (_table[slot] != NotFound) {
+
+			if (_hashes[_table[slot]] == hash)
+				return _table[slot];
+
+			slot = (slot + 1) & _mask;
+		}
+
+		return NotFound;
+	}
+
+	/**
+	 * Get the hash with the given index.
+	 */
+	std::size_t getHash(unsigned int index) const { return _hashes[index]; }
+
+	/**
+	 * Get all hashes, sorted by their index.
+	 */
+	const std::vector<std::size_t>& getHashes() const { return _hashes; }
+
+	unsigned int size() const { return _hashes.size(); }
+
+private:
+
+	// the hashes are not necessarily well distributed in their lower bits
+	static std::size_t mix(std::size_t hash) {
+
+		unsigned long long x = hash;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+
+		return static_cast<std::size_t>(x);
+	}
+
+	// the sorted hashes, the index of a hash is its position
+	std::vector<std::size_t> _hashes;
+
+	// open-addressing table of indices into _hashes
+	std::vector<unsigned int> _table;
+
+	std::size_t _mask;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_HASH_INDEX_H__
+
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/make_shared.hpp>
+
+#include <solvers/LinearObjective.h>
+#include <threads/ThreadPool.h>
+#include <util/Logger.h>
+#include "IlpSolver.h"
+#include "Presolver.h"
+#include "UnionFind.h"
+
+logger::LogChannel ilpsolverlog("ilpsolverlog", "[IlpSolver] ");
+
+IlpSolver::IlpSolver() :
+	_numThreads(1),
+	_maxEnumerationSize(8),
+	_presolve(true),
+	_numComponents(0),
+	_numSolverComponents(0),
+	_solverPool(boost::make_shared<LinearSolverPool>()),
+	_status(Optimal) {}
+
+std::vector<double>
+IlpSolver::solve(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints) {
+
+	if (!_presolve)
+		return solveComponents(costs, constraints);
+
+	Presolver presolver(costs, constraints);
+
+	// let the solver find a solution anyway, but report the infeasibility
+	if (presolver.isInfeasible()) {
+
+		LOG_ERROR(ilpsolverlog) << "presolve found the problem to be infeasible" << std::endl;
+
+		std::vector<double> values = solveComponents(costs, constraints);
+		_status = Infeasible;
+
+		return values;
+	}
+
+	std::vector<double> reducedValues = solveComponents(
+			presolver.getReducedCosts(),
+			presolver.getReducedConstraints());
+
+	return presolver.expand(reducedValues);
+}
+
+std::vector<double>
+IlpSolver::solveComponents(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints) {
+
+	std::vector<double> values(costs.size(), 0.0);
+
+	std::vector<Component> components = findComponents(costs.size(), constraints);
+
+	// solve the small components right away, collect the others for the
+	// solver
+	std::vector<const Component*> solverComponents;
+
+	for (const Component& component : components) {
+
+		if (component.variables.size() <= _maxEnumerationSize && enumerate(component, costs, values))
+			continue;
+
+		solverComponents.push_back(&component);
+	}
+
+	_numComponents       = components.size();
+	_numSolverComponents = solverComponents.size();
+
+	LOG_DEBUG(ilpsolverlog)
+			<< "found " << _numComponents << " independent components, "
+			<< (_numComponents - _numSolverComponents) << " of them solved by enumeration"
+			<< std::endl;
+
+	unsigned int numThreads = std::min(
+			ThreadPool::resolveNumThreads(_numThreads),
+			static_cast<unsigned int>(solverComponents.size()));
+
+	// how each solver component was solved
+	std::vector<Status> statuses(solverComponents.size(), Optimal);
+
+	if (numThreads <= 1) {
+
+		for (unsigned int i = 0; i < solverComponents.size(); i++)
+			statuses[i] = solveComponent(*solverComponents[i], costs, values);
+
+	} else {
+
+		solveComponentsParallel(solverComponents, numThreads, costs, values, statuses);
+	}
+
+	unsigned int numInfeasible = std::count(statuses.begin(), statuses.end(), Infeasible);
+
+	_status = (numInfeasible > 0 ? Infeasible : Optimal);
+
+	if (numInfeasible > 0)
+		LOG_ERROR(ilpsolverlog)
+				<< numInfeasible << " of " << statuses.size()
+				<< " solver components are infeasible" << std::endl;
+
+	return values;
+}
+
+void
+IlpSolver::solveComponentsParallel(
+		const std::vector<const Component*>& solverComponents,
+		unsigned int                         numThreads,
+		const std::vector<double>&           costs,
+		std::vector<double>&                 values,
+		std::vector<Status>&                 statuses) {
+
+	LOG_DEBUG(ilpsolverlog) << "solving components with " << numThreads << " threads" << std::endl;
+
+	// largest components first, to not wait for a big one at the end
+	std::vector<unsigned int> order(solverComponents.size());
+	for (unsigned int i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::sort(
+			order.begin(),
+			order.end(),
+			[&solverComponents](unsigned int a, unsigned int b) {
+				return solverComponents[a]->variables.size() > solverComponents[b]->variables.size();
+			});
+
+	ThreadPool threadPool(numThreads);
+
+	// components have disjoint variables, the tasks write to different values
+	for (unsigned int i : order)
+		threadPool.schedule([this, i, &solverComponents, &costs, &values, &statuses]() {
+
+			statuses[i] = solveComponent(*solverComponents[i], costs, values);
+		});
+
+	threadPool.wait();
+}
+
+std::vector<IlpSolver::Component>
+IlpSolver::findComponents(
+		unsigned int             numVariables,
+		const LinearConstraints& constraints) {
+
+	UnionFind sets(numVariables);
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		const std::map<unsigned int, double>& coefficients = constraint.getCoefficients();
+
+		if (coefficients.empty())
+			continue;
+
+		unsigned int first = coefficients.begin()->first;
+		for (const std::pair<const unsigned int, double>& coefficient : coefficients)
+			sets.merge(first, coefficient.first);
+	}
+
+	// number the components in the order of their first variable
+	std::vector<int> componentIndex(numVariables, -1);
+	std::vector<Component> components;
+
+	for (unsigned int var = 0; var < numVariables; var++) {
+
+		unsigned int root = sets.find(var);
+
+		if (componentIndex[root] < 0) {
+
+			componentIndex[root] = components.size();
+			components.push_back(Component());
+		}
+
+		components[componentIndex[root]].variables.push_back(var);
+	}
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		const std::map<unsigned int, double>& coefficients = constraint.getCoefficients();
+
+		if (coefficients.empty()) {
+
+			LOG_DEBUG(ilpsolverlog) << "ignoring constraint without variables" << std::endl;
+			continue;
+		}
+
+		unsigned int root = sets.find(coefficients.begin()->first);
+		components[componentIndex[root]].constraints.push_back(&constraint);
+	}
+
+	return components;
+}
+
+bool
+IlpSolver::enumerate(
+		const Component&           component,
+		const std::vector<double>& costs,
+		std::vector<double>&       values) {
+
+	const unsigned int numVariables = component.variables.size();
+
+	double       bestCost       = std::numeric_limits<double>::infinity();
+	unsigned int bestAssignment = 0;
+	bool         feasible       = false;
+
+	for (unsigned int assignment = 0; assignment < (1u << numVariables); assignment++) {
+
+		double cost = 0;
+
+		for (unsigned int i = 0; i < numVariables; i++) {
+
+			bool on = (assignment >> i) & 1;
+
+			values[component.variables[i]] = (on ? 1.0 : 0.0);
+			if (on)
+				cost += costs[component.variables[i]];
+		}
+
+		if (feasible && cost >= bestCost)
+			continue;
+
+		if (!isFeasible(component, values))
+			continue;
+
+		feasible       = true;
+		bestCost       = cost;
+		bestAssignment = assignment;
+	}
+
+	for (unsigned int i = 0; i < numVariables; i++)
+		values[component.variables[i]] = ((bestAssignment >> i) & 1 ? 1.0 : 0.0);
+
+	return feasible;
+}
+
+IlpSolver::Status
+IlpSolver::solveComponent(
+		const Component&           component,
+		const std::vector<double>& costs,
+		std::vector<double>&       values) {
+
+	const std::vector<unsigned int>& variables = component.variables;
+
+	boost::shared_ptr<LinearObjective>   objective   = boost::make_shared<LinearObjective>(variables.size());
+	boost::shared_ptr<LinearConstraints> constraints = boost::make_shared<LinearConstraints>();
+
+	for (unsigned int i = 0; i < variables.size(); i++)
+		objective->setCoefficient(i, costs[variables[i]]);
+
+	// variables are sorted, find the local index by binary search
+	for (const LinearConstraint* constraint : component.constraints) {
+
+		LinearConstraint local;
+
+		for (const std::pair<const unsigned int, double>& coefficient : constraint->getCoefficients()) {
+
+			unsigned int i = std::lower_bound(variables.begin(), variables.end(), coefficient.first) - variables.begin();
+			local.setCoefficient(i, coefficient.second);
+		}
+
+		local.setRelation(constraint->getRelation());
+		local.setValue(constraint->getValue());
+
+		constraints->add(local);
+	}
+
+	std::vector<double> solution = _solverPool->solve(objective, constraints);
+
+	for (unsigned int i = 0; i < variables.size(); i++)
+		values[variables[i]] = (solution[i] > 0.5 ? 1.0 : 0.0);
+
+	return (isFeasible(component, values) ? Optimal : Infeasible);
+}
+
+bool
+IlpSolver::isFeasible(const Component& component, const std::vector<double>& values) {
+
+	for (const LinearConstraint* constraint : component.constraints)
+		if (!isSatisfied(*constraint, values))
+			return false;
+
+	return true;
+}
+
+bool
+IlpSolver::isSatisfied(const LinearConstraint& constraint, const std::vector<double>& values) {
+
+	const double tolerance = 1e-6;
+
+	double sum = 0;
+	for (const std::pair<const unsigned int, double>& coefficient : constraint.getCoefficients())
+		sum += coefficient.second*values[coefficient.first];
+
+	switch (constraint.getRelation()) {
+
+		case LessEqual:
+			return sum <= constraint.getValue() + tolerance;
+
+		case GreaterEqual:
+			return sum >= constraint.getValue() - tolerance;
+
+		default:
+			return std::abs(sum - constraint.getValue()) <= tolerance;
+	}
+}
@@ -0,0 +1,176 @@
+#ifndef SOPNET_BLOCKWISE_ILP_ILP_SOLVER_H__
+#define SOPNET_BLOCKWISE_ILP_ILP_SOLVER_H__
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <solvers/LinearConstraints.h>
+#include "LinearSolverPool.h"
+
+/**
+ * Solves binary ILPs of the form
+ *
+ *   min c'x  s.t.  Ax (<=,==,>=) b,  x in {0,1}^n
+ *
+ * by presolving them (see Presolver) and splitting the reduced problem into
+ * independent components: Two variables are in the same component, if they
+ * appear together in a constraint. Components with only a few variables
+ * (e.g., a lone slice with its end segments) are solved by enumerating all
+ * assignments, all others are passed to the LinearSolver, optionally in
+ * parallel.
+ *
+ * The LinearSolver offers neither a time limit, a MIP gap, nor a MIP start,
+ * components are always solved to optimality from scratch.
+ */
+class IlpSolver {
+
+public:
+
+	/**
+	 * How the last call to solve() ended.
+	 */
+	enum Status {
+
+		// all components were solved to optimality
+		Optimal,
+
+		// the problem is infeasible, the returned solution violates some
+		// constraints
+		Infeasible
+	};
+
+	IlpSolver();
+
+	/**
+	 * Set the number of components that are passed to the LinearSolver at the
+	 * same time. 0 uses all hardware threads. Default is 1.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * The largest component size that can be solved by enumeration. The
+	 * number of assignments grows as 2^size, larger values are capped.
+	 */
+	static const unsigned int MaxEnumerationSize = 20;
+
+	/**
+	 * Components with at most this many variables are solved by enumerating
+	 * all assignments. Default is 8, values above MaxEnumerationSize are
+	 * capped to it.
+	 */
+	void setMaxEnumerationSize(unsigned int size) { _maxEnumerationSize = std::min(size, (unsigned int)MaxEnumerationSize); }
+
+	/**
+	 * Enable or disable the presolve. Default is enabled.
+	 */
+	void setPresolve(bool presolve) { _presolve = presolve; }
+
+	/**
+	 * Set the pool of LinearSolvers to use. By default, each IlpSolver has its
+	 * own pool, which keeps the solvers alive between calls to solve(). Share
+	 * a pool to reuse the solvers between IlpSolvers.
+	 */
+	void setSolverPool(boost::shared_ptr<LinearSolverPool> solverPool) { _solverPool = solverPool; }
+
+	/**
+	 * Get the pool of LinearSolvers used by this IlpSolver.
+	 */
+	boost::shared_ptr<LinearSolverPool> getSolverPool() const { return _solverPool; }
+
+	/**
+	 * How the last call to solve() ended.
+	 */
+	Status getStatus() const { return _status; }
+
+	/**
+	 * Solve the ILP.
+	 *
+	 * @param costs
+	 *              The cost of each variable.
+	 * @param constraints
+	 *              The linear constraints on the variables.
+	 * @return
+	 *              The value (0 or 1) of each variable in the optimal solution.
+	 */
+	std::vector<double> solve(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints);
+
+	/**
+	 * The number of independent components found in the last call to solve().
+	 */
+	unsigned int getNumComponents() const { return _numComponents; }
+
+	/**
+	 * The number of components of the last call to solve() that needed the
+	 * LinearSolver.
+	 */
+	unsigned int getNumSolverComponents() const { return _numSolverComponents; }
+
+private:
+
+	struct Component {
+
+		// the variables of this component, in increasing order
+		std::vector<unsigned int> variables;
+
+		// the constraints on these variables
+		std::vector<const LinearConstraint*> constraints;
+	};
+
+	// solve the ILP without presolve
+	std::vector<double> solveComponents(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints);
+
+	// find the independent components of the ILP
+	std::vector<Component> findComponents(
+			unsigned int             numVariables,
+			const LinearConstraints& constraints);
+
+	// try all assignments of the component's variables, returns false if none
+	// is feasible
+	bool enumerate(
+			const Component&           component,
+			const std::vector<double>& costs,
+			std::vector<double>&       values);
+
+	// solve the solver components on a thread pool
+	void solveComponentsParallel(
+			const std::vector<const Component*>& solverComponents,
+			unsigned int                         numThreads,
+			const std::vector<double>&           costs,
+			std::vector<double>&                 values,
+			std::vector<Status>&                 statuses);
+
+	// solve the component with the LinearSolver, returns Optimal unless the 
+	// component is infeasible
+	Status solveComponent(
+			const Component&           component,
+			const std::vector<double>& costs,
+			std::vector<double>&       values);
+
+	// check whether the values satisfy all constraints of the component
+	static bool isFeasible(const Component& component, const std::vector<double>& values);
+
+	static bool isSatisfied(const LinearConstraint& constraint, const std::vector<double>& values);
+
+	unsigned int _numThreads;
+
+	unsigned int _maxEnumerationSize;
+
+	bool _presolve;
+
+	unsigned int _numComponents;
+
+	unsigned int _numSolverComponents;
+
+	boost::shared_ptr<LinearSolverPool> _solverPool;
+
+	Status _status;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_ILP_SOLVER_H__
+
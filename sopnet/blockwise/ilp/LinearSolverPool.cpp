@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/make_shared.hpp>
+
+#include <pipeline/Value.h>
+#include <util/Logger.h>
+#include "LinearSolverPool.h"
+
+logger::LogChannel linearsolverpoollog("linearsolverpoollog", "[LinearSolverPool] ");
+
+// 64 bit FNV-1a over the little-endian bytes of the added values, such that 
+// the fingerprints of persisted solutions do not depend on the platform or 
+// library versions
+class Fnv1aHash {
+
+public:
+
+	Fnv1aHash() :
+		_hash(14695981039346656037ull) {}
+
+	void addInteger(std::uint64_t value) {
+
+		for (unsigned int i = 0; i < 8; i++) {
+
+			_hash ^= (value >> (8*i)) & 0xff;
+			_hash *= 1099511628211ull;
+		}
+	}
+
+	void addDouble(double value) {
+
+		// -0.0 and 0.0 are the same coefficient
+		if (value == 0)
+			value = 0;
+
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		addInteger(bits);
+	}
+
+	std::uint64_t get() const { return _hash; }
+
+private:
+
+	std::uint64_t _hash;
+};
+
+LinearSolverPool::LinearSolverPool() :
+	_parameters(boost::make_shared<LinearSolverParameters>(Binary)),
+	_numSolvers(0),
+	_numSolves(0),
+	_numCacheHits(0) {}
+
+std::vector<double>
+LinearSolverPool::solve(
+		boost::shared_ptr<LinearObjective>   objective,
+		boost::shared_ptr<LinearConstraints> constraints) {
+
+	boost::shared_ptr<SolutionCache> solutionCache;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		solutionCache = _solutionCache;
+	}
+
+	std::size_t fingerprint = 0;
+
+	if (solutionCache) {
+
+		fingerprint = getFingerprint(*objective, *constraints);
+
+		std::vector<double> values;
+
+		if (solutionCache->getSolution(fingerprint, values) && values.size() == objective->size()) {
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_numCacheHits++;
+
+			return values;
+		}
+	}
+
+	SolverPtr solver = acquire();
+
+	std::vector<double> values(objective->size());
+
+	try {
+
+		// setting new inputs marks the solver dirty, the backend is kept
+		(*solver)->setInput("objective", objective);
+		(*solver)->setInput("linear constraints", constraints);
+
+		pipeline::Value<Solution> solution = (*solver)->getOutput();
+
+		for (unsigned int i = 0; i < values.size(); i++)
+			values[i] = (*solution)[i];
+
+	} catch (...) {
+
+		// don't reuse a solver in an unknown state
+		std::lock_guard<std::mutex> lock(_mutex);
+		_numSolvers--;
+
+		throw;
+	}
+
+	release(solver);
+
+	if (solutionCache)
+		solutionCache->storeSolution(fingerprint, values);
+
+	return values;
+}
+
+void
+LinearSolverPool::setSolutionCache(boost::shared_ptr<SolutionCache> solutionCache) {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_solutionCache = solutionCache;
+}
+
+std::size_t
+LinearSolverPool::getFingerprint(
+		const LinearObjective&   objective,
+		const LinearConstraints& constraints) const {
+
+	Fnv1aHash fingerprint;
+
+	fingerprint.addInteger(static_cast<int>(_parameters->getVariableType()));
+	fingerprint.addInteger(objective.size());
+
+	for (double coefficient : objective.getCoefficients())
+		fingerprint.addDouble(coefficient);
+
+	// the coefficients of a constraint are sorted by variable, sort the 
+	// constraints by their hash
+	std::vector<std::uint64_t> constraintHashes;
+	constraintHashes.reserve(constraints.size());
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		Fnv1aHash constraintHash;
+
+		for (const std::pair<const unsigned int, double>& coefficient : constraint.getCoefficients()) {
+
+			constraintHash.addInteger(coefficient.first);
+			constraintHash.addDouble(coefficient.second);
+		}
+
+		constraintHash.addInteger(static_cast<int>(constraint.getRelation()));
+		constraintHash.addDouble(constraint.getValue());
+
+		constraintHashes.push_back(constraintHash.get());
+	}
+
+	std::sort(constraintHashes.begin(), constraintHashes.end());
+
+	fingerprint.addInteger(constraintHashes.size());
+	for (std::uint64_t constraintHash : constraintHashes)
+		fingerprint.addInteger(constraintHash);
+
+	return static_cast<std::size_t>(fingerprint.get());
+}
+
+unsigned int
+LinearSolverPool::getNumSolvers() {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _numSolvers;
+}
+
+unsigned int
+LinearSolverPool::getNumSolves() {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _numSolves;
+}
+
+unsigned int
+LinearSolverPool::getNumCacheHits() {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _numCacheHits;
+}
+
+LinearSolverPool::SolverPtr
+LinearSolverPool::acquire() {
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_numSolves++;
+
+		if (!_idle.empty()) {
+
+			SolverPtr solver = _idle.back();
+			_idle.pop_back();
+
+			return solver;
+		}
+
+		_numSolvers++;
+	}
+
+	LOG_DEBUG(linearsolverpoollog) << "creating a new linear solver" << std::endl;
+
+	SolverPtr solver = boost::make_shared<pipeline::Process<LinearSolver> >();
+	(*solver)->setInput("parameters", _parameters);
+
+	return solver;
+}
+
+void
+LinearSolverPool::release(SolverPtr solver) {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_idle.push_back(solver);
+}
@@ -0,0 +1,101 @@
+#ifndef SOPNET_BLOCKWISE_ILP_LINEAR_SOLVER_POOL_H__
+#define SOPNET_BLOCKWISE_ILP_LINEAR_SOLVER_POOL_H__
+
+#include <mutex>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <blockwise/persistence/SolutionCache.h>
+#include <pipeline/Process.h>
+#include <solvers/LinearConstraints.h>
+#include <solvers/LinearObjective.h>
+#include <solvers/LinearSolver.h>
+
+/**
+ * A pool of long-lived LinearSolver process nodes. Every LinearSolver creates
+ * its own solver backend (for Gurobi, a new environment), which dominates the
+ * time to solve the small ILPs of a single core. The pool keeps the solvers
+ * alive between solves and hands them out to one caller at a time, so that
+ * concurrent solves use different solvers.
+ *
+ * A pool can be shared between IlpSolvers (and thus guarantors) to reuse the
+ * solvers over the lifetime of a process.
+ *
+ * Optionally, solutions are looked up in a SolutionCache by a fingerprint of 
+ * the problem before a solver is invoked.
+ */
+class LinearSolverPool {
+
+public:
+
+	LinearSolverPool();
+
+	/**
+	 * Solve the given binary ILP with one of the pooled solvers.
+	 *
+	 * @return
+	 *              The value of each variable in the solution.
+	 */
+	std::vector<double> solve(
+			boost::shared_ptr<LinearObjective>   objective,
+			boost::shared_ptr<LinearConstraints> constraints);
+
+	/**
+	 * Set a cache for solutions of identical problems. 0 disables the cache, 
+	 * which is the default. The cache is used by all users of this pool.
+	 */
+	void setSolutionCache(boost::shared_ptr<SolutionCache> solutionCache);
+
+	/**
+	 * Get a hash of the problem that does not depend on the order of the 
+	 * constraints or of the coefficients within a constraint. The hash is a 
+	 * 64 bit FNV-1a over the values of the problem, it is stable across 
+	 * platforms and library versions and can be persisted.
+	 */
+	std::size_t getFingerprint(
+			const LinearObjective&   objective,
+			const LinearConstraints& constraints) const;
+
+	/**
+	 * The number of solvers created so far.
+	 */
+	unsigned int getNumSolvers();
+
+	/**
+	 * The number of solves performed so far.
+	 */
+	unsigned int getNumSolves();
+
+	/**
+	 * The number of solves answered from the solution cache.
+	 */
+	unsigned int getNumCacheHits();
+
+private:
+
+	typedef boost::shared_ptr<pipeline::Process<LinearSolver> > SolverPtr;
+
+	// get an idle solver or create a new one
+	SolverPtr acquire();
+
+	// put a solver back into the pool
+	void release(SolverPtr solver);
+
+	std::mutex _mutex;
+
+	std::vector<SolverPtr> _idle;
+
+	boost::shared_ptr<LinearSolverParameters> _parameters;
+
+	unsigned int _numSolvers;
+
+	unsigned int _numSolves;
+
+	unsigned int _numCacheHits;
+
+	boost::shared_ptr<SolutionCache> _solutionCache;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_LINEAR_SOLVER_POOL_H__
+
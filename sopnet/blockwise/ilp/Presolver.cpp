@@ -0,0 +1,290 @@
+#include <set>
+
+#include <util/Logger.h>
+#include "Presolver.h"
+
+logger::LogChannel presolverlog("presolverlog", "[Presolver] ");
+
+namespace {
+
+// tolerance for comparing row activities
+const double Tolerance = 1e-6;
+
+}
+
+Presolver::Presolver(
+		const std::vector<double>& costs,
+		const LinearConstraints&   constraints) :
+	_variableRows(costs.size()),
+	_fixed(costs.size(), -1),
+	_infeasible(false),
+	_numFixed(0),
+	_numRemovedConstraints(0) {
+
+	createRows(constraints);
+
+	while (!_infeasible) {
+
+		unsigned int numFixed = propagateRows();
+
+		if (_infeasible)
+			break;
+
+		numFixed += fixDominatedVariables(costs);
+
+		if (numFixed == 0)
+			break;
+	}
+
+	if (_infeasible) {
+
+		LOG_DEBUG(presolverlog) << "problem is infeasible" << std::endl;
+		return;
+	}
+
+	createReducedProblem(costs);
+
+	LOG_DEBUG(presolverlog)
+			<< "fixed " << _numFixed << " of " << costs.size()
+			<< " variables, removed " << _numRemovedConstraints << " of "
+			<< constraints.size() << " constraints" << std::endl;
+}
+
+std::vector<double>
+Presolver::expand(const std::vector<double>& reducedValues) const {
+
+	std::vector<double> values(_fixed.size());
+
+	for (unsigned int var = 0; var < _fixed.size(); var++)
+		values[var] = (_fixed[var] == 1 ? 1.0 : 0.0);
+
+	for (unsigned int i = 0; i < _freeVariables.size(); i++)
+		values[_freeVariables[i]] = reducedValues[i];
+
+	return values;
+}
+
+void
+Presolver::createRows(const LinearConstraints& constraints) {
+
+	typedef std::pair<std::pair<int, double>, std::vector<std::pair<unsigned int, double> > > RowKey;
+
+	std::set<RowKey> seen;
+
+	for (const LinearConstraint& constraint : constraints) {
+
+		Row row;
+		row.coefficients.assign(constraint.getCoefficients().begin(), constraint.getCoefficients().end());
+		row.relation = constraint.getRelation();
+		row.value    = constraint.getValue();
+		row.active   = true;
+
+		// coefficients are sorted by variable, equal constraints have equal
+		// keys
+		if (!seen.insert(RowKey(std::make_pair(static_cast<int>(row.relation), row.value), row.coefficients)).second) {
+
+			_numRemovedConstraints++;
+			continue;
+		}
+
+		for (const std::pair<unsigned int, double>& coefficient : row.coefficients)
+			_variableRows[coefficient.first].push_back(_rows.size());
+
+		_rows.push_back(row);
+	}
+}
+
+unsigned int
+Presolver::propagateRows() {
+
+	unsigned int numFixedBefore = _numFixed;
+
+	for (Row& row : _rows) {
+
+		if (!row.active)
+			continue;
+
+		// bounds of the row activity over all assignments of the free
+		// variables
+		double lower = 0;
+		double upper = 0;
+
+		for (const std::pair<unsigned int, double>& coefficient : row.coefficients) {
+
+			int fixed = _fixed[coefficient.first];
+
+			if (fixed >= 0) {
+
+				lower += fixed*coefficient.second;
+				upper += fixed*coefficient.second;
+
+			} else if (coefficient.second > 0) {
+
+				upper += coefficient.second;
+
+			} else {
+
+				lower += coefficient.second;
+			}
+		}
+
+		bool checkUpper = (row.relation == LessEqual    || row.relation == Equal);
+		bool checkLower = (row.relation == GreaterEqual || row.relation == Equal);
+
+		if ((checkUpper && lower > row.value + Tolerance) ||
+		    (checkLower && upper < row.value - Tolerance)) {
+
+			_infeasible = true;
+			return 0;
+		}
+
+		// satisfied for all assignments?
+		if ((!checkUpper || upper <= row.value + Tolerance) &&
+		    (!checkLower || lower >= row.value - Tolerance)) {
+
+			row.active = false;
+			_numRemovedConstraints++;
+			continue;
+		}
+
+		// fix variables that would violate the row with one of their values
+		for (const std::pair<unsigned int, double>& coefficient : row.coefficients) {
+
+			unsigned int var = coefficient.first;
+			double       a   = coefficient.second;
+
+			if (_fixed[var] >= 0)
+				continue;
+
+			if (checkUpper) {
+
+				if (a > 0 && lower + a > row.value + Tolerance)
+					fix(var, 0);
+				else if (a < 0 && lower - a > row.value + Tolerance)
+					fix(var, 1);
+			}
+
+			if (checkLower && _fixed[var] < 0) {
+
+				if (a > 0 && upper - a < row.value - Tolerance)
+					fix(var, 1);
+				else if (a < 0 && upper + a < row.value - Tolerance)
+					fix(var, 0);
+			}
+		}
+	}
+
+	return _numFixed - numFixedBefore;
+}
+
+unsigned int
+Presolver::fixDominatedVariables(const std::vector<double>& costs) {
+
+	unsigned int numFixedBefore = _numFixed;
+
+	for (unsigned int var = 0; var < _fixed.size(); var++) {
+
+		if (_fixed[var] >= 0)
+			continue;
+
+		// can the variable be decreased (increased) without violating any
+		// active row?
+		bool canDecrease = true;
+		bool canIncrease = true;
+
+		for (unsigned int r : _variableRows[var]) {
+
+			const Row& row = _rows[r];
+
+			if (!row.active)
+				continue;
+
+			if (row.relation == Equal) {
+
+				canDecrease = canIncrease = false;
+				break;
+			}
+
+			double a = 0;
+			for (const std::pair<unsigned int, double>& coefficient : row.coefficients)
+				if (coefficient.first == var)
+					a = coefficient.second;
+
+			bool increasesActivity = (a > 0);
+
+			if (row.relation == LessEqual) {
+
+				canIncrease &= !increasesActivity;
+				canDecrease &=  increasesActivity;
+
+			} else {
+
+				canIncrease &=  increasesActivity;
+				canDecrease &= !increasesActivity;
+			}
+
+			if (!canDecrease && !canIncrease)
+				break;
+		}
+
+		if (costs[var] >= 0 && canDecrease)
+			fix(var, 0);
+		else if (costs[var] <= 0 && canIncrease)
+			fix(var, 1);
+	}
+
+	return _numFixed - numFixedBefore;
+}
+
+void
+Presolver::fix(unsigned int var, int value) {
+
+	if (_fixed[var] >= 0) {
+
+		if (_fixed[var] != value)
+			_infeasible = true;
+
+		return;
+	}
+
+	_fixed[var] = value;
+	_numFixed++;
+}
+
+void
+Presolver::createReducedProblem(const std::vector<double>& costs) {
+
+	std::vector<int> reducedIndex(_fixed.size(), -1);
+
+	for (unsigned int var = 0; var < _fixed.size(); var++) {
+
+		if (_fixed[var] >= 0)
+			continue;
+
+		reducedIndex[var] = _freeVariables.size();
+		_freeVariables.push_back(var);
+		_reducedCosts.push_back(costs[var]);
+	}
+
+	for (const Row& row : _rows) {
+
+		if (!row.active)
+			continue;
+
+		LinearConstraint constraint;
+		double value = row.value;
+
+		for (const std::pair<unsigned int, double>& coefficient : row.coefficients) {
+
+			if (_fixed[coefficient.first] >= 0)
+				value -= _fixed[coefficient.first]*coefficient.second;
+			else
+				constraint.setCoefficient(reducedIndex[coefficient.first], coefficient.second);
+		}
+
+		constraint.setRelation(row.relation);
+		constraint.setValue(value);
+
+		_reducedConstraints.add(constraint);
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef SOPNET_BLOCKWISE_ILP_PRESOLVER_H__
+#define SOPNET_BLOCKWISE_ILP_PRESOLVER_H__
+
+#include <vector>
+
+#include <solvers/LinearConstraints.h>
+
+/**
+ * Reduces a binary ILP before it is passed to a solver:
+ *
+ * - duplicate constraints are removed,
+ * - variables are fixed, if a constraint can only be satisfied with one of
+ *   their values (this covers Equal rows with a single free variable),
+ * - constraints that are satisfied for every assignment of their free
+ *   variables are removed,
+ * - dominated variables are fixed: a variable with non-negative cost that
+ *   can always be set to zero without violating a constraint (e.g., a
+ *   segment with positive cost that only appears in <= 1 rows) is set to
+ *   zero, and vice versa.
+ *
+ * This is repeated until no more variables can be fixed. The solution of the
+ * reduced problem is mapped back with expand().
+ */
+class Presolver {
+
+public:
+
+	/**
+	 * Presolve the problem min c'x s.t. constraints, x binary.
+	 */
+	Presolver(
+			const std::vector<double>& costs,
+			const LinearConstraints&   constraints);
+
+	/**
+	 * True, if the presolve found a constraint that can not be satisfied. The
+	 * reduced problem is not valid in this case.
+	 */
+	bool isInfeasible() const { return _infeasible; }
+
+	/**
+	 * The costs of the free variables.
+	 */
+	const std::vector<double>& getReducedCosts() const { return _reducedCosts; }
+
+	/**
+	 * The remaining constraints on the free variables.
+	 */
+	const LinearConstraints& getReducedConstraints() const { return _reducedConstraints; }
+
+	/**
+	 * Map a solution of the reduced problem to a solution of the original
+	 * problem.
+	 */
+	std::vector<double> expand(const std::vector<double>& reducedValues) const;
+
+	unsigned int getNumFixedVariables() const { return _numFixed; }
+
+	unsigned int getNumRemovedConstraints() const { return _numRemovedConstraints; }
+
+private:
+
+	struct Row {
+
+		std::vector<std::pair<unsigned int, double> > coefficients;
+		Relation relation;
+		double   value;
+		bool     active;
+	};
+
+	// add all unique constraints to _rows
+	void createRows(const LinearConstraints& constraints);
+
+	// fix variables and deactivate redundant rows using the bounds of the row
+	// activities, returns the number of newly fixed variables
+	unsigned int propagateRows();
+
+	// fix dominated variables, returns the number of newly fixed variables
+	unsigned int fixDominatedVariables(const std::vector<double>& costs);
+
+	void fix(unsigned int var, int value);
+
+	void createReducedProblem(const std::vector<double>& costs);
+
+	std::vector<Row> _rows;
+
+	// the rows each variable appears in
+	std::vector<std::vector<unsigned int> > _variableRows;
+
+	// -1 for free variables, 0 or 1 for fixed ones
+	std::vector<int> _fixed;
+
+	// the original index of each free variable
+	std::vector<unsigned int> _freeVariables;
+
+	std::vector<double> _reducedCosts;
+
+	LinearConstraints _reducedConstraints;
+
+	bool _infeasible;
+
+	unsigned int _numFixed;
+
+	unsigned int _numRemovedConstraints;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_PRESOLVER_H__
+
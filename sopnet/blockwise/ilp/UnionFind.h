@@ -0,0 +1,73 @@
+#ifndef SOPNET_BLOCKWISE_ILP_UNION_FIND_H__
+#define SOPNET_BLOCKWISE_ILP_UNION_FIND_H__
+
+#include <utility>
+#include <vector>
+
+/**
+ * Disjoint sets over the elements [0, size), with path halving and union by
+ * size.
+ */
+class UnionFind {
+
+public:
+
+	UnionFind(unsigned int size = 0) { reset(size); }
+
+	/**
+	 * Put each of the elements [0, size) in its own set.
+	 */
+	void reset(unsigned int size) {
+
+		_parents.resize(size);
+		_sizes.assign(size, 1);
+
+		for (unsigned int i = 0; i < size; i++)
+			_parents[i] = i;
+	}
+
+	/**
+	 * Get the representative of the set containing element i.
+	 */
+	unsigned int find(unsigned int i) {
+
+		while (_parents[i] != i) {
+
+			_parents[i] = _parents[_parents[i]];
+			i = _parents[i];
+		}
+
+		return i;
+	}
+
+	/**
+	 * Merge the sets containing elements i and j. Returns the representative
+	 * of the merged set.
+	 */
+	unsigned int merge(unsigned int i, unsigned int j) {
+
+		i = find(i);
+		j = find(j);
+
+		if (i == j)
+			return i;
+
+		if (_sizes[i] < _sizes[j])
+			std::swap(i, j);
+
+		_parents[j] = i;
+		_sizes[i]  += _sizes[j];
+
+		return i;
+	}
+
+	unsigned int size() const { return _parents.size(); }
+
+private:
+
+	std::vector<unsigned int> _parents;
+	std::vector<unsigned int> _sizes;
+};
+
+#endif // SOPNET_BLOCKWISE_ILP_UNION_FIND_H__
+
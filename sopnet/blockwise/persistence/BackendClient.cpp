@@ -4,10 +4,12 @@
 #include <blockwise/persistence/postgresql/PostgreSqlProjectConfigurationStore.h>
 #include <blockwise/persistence/postgresql/PostgreSqlSliceStore.h>
 #include <blockwise/persistence/postgresql/PostgreSqlSegmentStore.h>
+#include <blockwise/persistence/postgresql/PostgreSqlSolutionCache.h>
 #endif
 #include <blockwise/persistence/local/LocalStackStore.h>
 #include <blockwise/persistence/local/LocalSliceStore.h>
 #include <blockwise/persistence/local/LocalSegmentStore.h>
+#include <blockwise/persistence/local/LocalSolutionCache.h>
 #include "BackendClient.h"
 #include <util/Logger.h>
 
@@ -102,3 +104,25 @@ BackendClient::createSegmentStore(const ProjectConfiguration& configuration, con
 
 	UTIL_THROW_EXCEPTION(UsageError, "unknown backend type " << configuration.getBackendType());
 }
+
+boost::shared_ptr<SolutionCache>
+BackendClient::createSolutionCache(const ProjectConfiguration& configuration, const StackType type) {
+
+	if (configuration.getBackendType() == ProjectConfiguration::Local) {
+
+		LOG_DEBUG(backendclientlog) << "[BackendClient] create local solution cache" << std::endl;
+
+		return boost::make_shared<LocalSolutionCache>();
+	}
+
+#ifdef HAVE_PostgreSQL
+	if (configuration.getBackendType() == ProjectConfiguration::PostgreSql) {
+
+		LOG_DEBUG(backendclientlog) << "[BackendClient] create postgresql solution cache" << std::endl;
+
+		return boost::make_shared<PostgreSqlSolutionCache>(configuration, type);
+	}
+#endif // HAVE_PostgreSQL
+
+	UTIL_THROW_EXCEPTION(UsageError, "unknown backend type " << configuration.getBackendType());
+}
@@ -6,6 +6,7 @@
 #include <blockwise/persistence/StackType.h>
 #include <blockwise/persistence/SliceStore.h>
 #include <blockwise/persistence/SegmentStore.h>
+#include <blockwise/persistence/SolutionCache.h>
 
 /**
  * Base class for backend clients. Provides helper functions to access the data 
@@ -38,6 +39,8 @@ public:
 	boost::shared_ptr<SliceStore>   createSliceStore(const ProjectConfiguration& configuration, const StackType type);
 
 	boost::shared_ptr<SegmentStore> createSegmentStore(const ProjectConfiguration& configuration, const StackType type);
+
+	boost::shared_ptr<SolutionCache> createSolutionCache(const ProjectConfiguration& configuration, const StackType type);
 };
 
 #endif // SOPNET_BLOCKWISE_PERSISTENCE_BACKEND_CLIENT_H__
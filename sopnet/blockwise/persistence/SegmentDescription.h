@@ -38,6 +38,9 @@ public:
 
 	void setFeatures(const std::vector<double>& features) { _features = features; }
 
+	template <typename Iterator>
+	void setFeatures(Iterator begin, Iterator end) { _features.assign(begin, end); }
+
 	const std::vector<double>& getFeatures() const { return _features; }
 
 	void setCost(double cost) { _cost = cost; }
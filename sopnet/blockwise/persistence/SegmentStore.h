@@ -9,6 +9,7 @@
 #include <blockwise/blocks/Cores.h>
 #include <blockwise/persistence/SegmentConstraints.h>
 #include <blockwise/persistence/SegmentDescriptions.h>
+#include <blockwise/persistence/SolutionStatus.h>
 
 /**
  * Segment store interface definition.
@@ -50,6 +51,27 @@ public:
 			Blocks&       missingBlocks,
 			bool          readCosts) = 0;
 
+	/**
+	 * Count the segments of a block without reading them.
+	 *
+	 * @param block
+	 *              The block to count the segments of.
+	 * @param numSegments
+	 *              Will be set to the number of segments.
+	 * @param numBranchSegments
+	 *              Will be set to the number of branch segments.
+	 * @param numSlices
+	 *              Will be set to the number of distinct slices used by the 
+	 *              segments.
+	 * @return
+	 *              False, if the segments of the block were not extracted yet.
+	 */
+	virtual bool getSegmentCounts(
+			const Block&  block,
+			unsigned int& numSegments,
+			unsigned int& numBranchSegments,
+			unsigned int& numSlices) = 0;
+
 	/**
 	 * Get additional constraints for segments in the given blocks. Typically
 	 * these would be user corrections to previous solutions or constraints
@@ -94,6 +116,28 @@ public:
 	 */
 	virtual std::vector<std::set<SegmentHash> > getSolutionByCores(const Cores& cores) = 0;
 
+	/**
+	 * Record how the last stored solution of a core was obtained.
+	 *
+	 * @param status
+	 *              The status and cost of the solution.
+	 * @param core
+	 *              The core for which the solution was generated.
+	 */
+	virtual void storeSolutionStatus(const SolutionStatus& status, const Core& core) = 0;
+
+	/**
+	 * Get the status of the last stored solution of a core.
+	 *
+	 * @param core
+	 *              The core to get the solution status for.
+	 * @param status
+	 *              Will be set to the status of the solution.
+	 * @return
+	 *              False, if there is no status for this core.
+	 */
+	virtual bool getSolutionStatus(const Core& core, SolutionStatus& status) = 0;
+
 	/**
 	 * Check whether the segments for the given block have already been 
 	 * extracted.
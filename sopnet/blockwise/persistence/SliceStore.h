@@ -76,6 +76,18 @@ public:
 	 */
 	virtual boost::shared_ptr<ConflictSets> getConflictSetsByBlocks(const Blocks& block, Blocks& missingBlocks) = 0;
 
+	/**
+	 * Count the conflict sets of a block without reading them.
+	 *
+	 * @param block
+	 *              The block to count the conflict sets of.
+	 * @param numConflictSets
+	 *              Will be set to the number of conflict sets.
+	 * @return
+	 *              False, if the slices of the block were not extracted yet.
+	 */
+	virtual bool getNumConflictSets(const Block& block, unsigned int& numConflictSets) = 0;
+
 	/**
 	 * Check whether the slices for the given block have already been extracted.
 	 */
@@ -0,0 +1,43 @@
+#ifndef SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_CACHE_H__
+#define SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_CACHE_H__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Solution cache interface definition. Stores solutions of binary ILPs under 
+ * a fingerprint of the problem (see LinearSolverPool::getFingerprint()), such 
+ * that solving the same problem again can be skipped. Implementations have to 
+ * be thread-safe.
+ */
+class SolutionCache {
+
+public:
+
+	virtual ~SolutionCache() {}
+
+	/**
+	 * Get the solution of a problem.
+	 *
+	 * @param fingerprint
+	 *              The fingerprint of the problem.
+	 * @param solution
+	 *              Will be set to the value of each variable in the solution.
+	 * @return
+	 *              False, if there is no solution for this fingerprint.
+	 */
+	virtual bool getSolution(std::size_t fingerprint, std::vector<double>& solution) = 0;
+
+	/**
+	 * Store the solution of a problem.
+	 *
+	 * @param fingerprint
+	 *              The fingerprint of the problem.
+	 * @param solution
+	 *              The value of each variable in the solution.
+	 */
+	virtual void storeSolution(std::size_t fingerprint, const std::vector<double>& solution) = 0;
+};
+
+#endif // SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_CACHE_H__
+
@@ -0,0 +1,77 @@
+#ifndef SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_STATUS_H__
+#define SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_STATUS_H__
+
+#include <string>
+
+/**
+ * How the solution of a core was obtained. Solutions that are not Optimal are
+ * candidates for a re-solve. The status values are persisted, don't renumber
+ * them.
+ */
+class SolutionStatus {
+
+public:
+
+	enum Status {
+
+		// the ILP was solved to optimality
+		Optimal = 0,
+
+		// 1 and 2 were the gap and time limits, which were removed
+
+		// the ILP was not solved, the solution is the one of the greedy
+		// heuristic
+		Approximate = 3,
+
+		// the stitching constraints to the neighbouring solutions made the ILP
+		// infeasible, the solution was found without them and does not agree
+		// with the neighbours
+		Unstitched = 4,
+
+		// the ILP is infeasible, the solution violates some constraints
+		Infeasible = 5
+	};
+
+	SolutionStatus() :
+		_status(Optimal),
+		_cost(0) {}
+
+	SolutionStatus(Status status, double cost) :
+		_status(status),
+		_cost(cost) {}
+
+	Status getStatus() const { return _status; }
+
+	/**
+	 * The cost of the solution.
+	 */
+	double getCost() const { return _cost; }
+
+	bool isOptimal() const { return _status == Optimal; }
+
+	static std::string statusName(Status status) {
+
+		switch (status) {
+
+			case Optimal:
+				return "optimal";
+			case Approximate:
+				return "approximate";
+			case Unstitched:
+				return "unstitched";
+			case Infeasible:
+				return "infeasible";
+			default:
+				return "unknown";
+		}
+	}
+
+private:
+
+	Status _status;
+
+	double _cost;
+};
+
+#endif // SOPNET_BLOCKWISE_PERSISTENCE_SOLUTION_STATUS_H__
+
@@ -1,5 +1,6 @@
 #include "LocalSegmentStore.h"
 #include <util/Logger.h>
+#include <set>
 
 logger::LogChannel localsegmentstorelog("localsegmentstorelog", "[LocalSegmentStore] ");
 
@@ -37,6 +38,36 @@ LocalSegmentStore::getSegmentsByBlocks(
 	return _blocksSegments;
 }
 
+bool
+LocalSegmentStore::getSegmentCounts(
+		const Block&  block,
+		unsigned int& numSegments,
+		unsigned int& numBranchSegments,
+		unsigned int& numSlices) {
+
+	std::map<Block, SegmentDescriptions>::const_iterator it = _segments.find(block);
+
+	if (it == _segments.end())
+		return false;
+
+	std::set<SliceHash> slices;
+	numBranchSegments = 0;
+
+	for (const SegmentDescription& segment : it->second) {
+
+		slices.insert(segment.getLeftSlices().begin(), segment.getLeftSlices().end());
+		slices.insert(segment.getRightSlices().begin(), segment.getRightSlices().end());
+
+		if (segment.getLeftSlices().size() + segment.getRightSlices().size() == 3)
+			numBranchSegments++;
+	}
+
+	numSegments = it->second.size();
+	numSlices   = slices.size();
+
+	return true;
+}
+
 boost::shared_ptr<SegmentConstraints>
 LocalSegmentStore::getConstraintsByBlocks(
 		const Blocks& /*blocks*/) {
@@ -82,6 +113,28 @@ LocalSegmentStore::getSolutionByCores(
 	return solution;
 }
 
+void
+LocalSegmentStore::storeSolutionStatus(
+		const SolutionStatus& status,
+		const Core&           core) {
+
+	_solutionStatus[core] = status;
+}
+
+bool
+LocalSegmentStore::getSolutionStatus(
+		const Core&     core,
+		SolutionStatus& status) {
+
+	std::map<Core, SolutionStatus>::const_iterator i = _solutionStatus.find(core);
+
+	if (i == _solutionStatus.end())
+		return false;
+
+	status = i->second;
+	return true;
+}
+
 bool
 LocalSegmentStore::getSegmentsFlag(
 		const Block& block) {
@@ -63,6 +63,18 @@ LocalSliceStore::getConflictSetsByBlocks(
 	return _blocksConflicts;
 }
 
+bool
+LocalSliceStore::getNumConflictSets(const Block& block, unsigned int& numConflictSets) {
+
+	std::map<Block, ConflictSets>::const_iterator it = _conflictSets.find(block);
+
+	if (it == _conflictSets.end())
+		return false;
+
+	numConflictSets = it->second.size();
+	return true;
+}
+
 bool
 LocalSliceStore::getSlicesFlag(const Block& block) {
 
@@ -0,0 +1,23 @@
+#include "LocalSolutionCache.h"
+
+bool
+LocalSolutionCache::getSolution(std::size_t fingerprint, std::vector<double>& solution) {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::map<std::size_t, std::vector<double> >::const_iterator i = _solutions.find(fingerprint);
+
+	if (i == _solutions.end())
+		return false;
+
+	solution = i->second;
+	return true;
+}
+
+void
+LocalSolutionCache::storeSolution(std::size_t fingerprint, const std::vector<double>& solution) {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_solutions[fingerprint] = solution;
+}
@@ -0,0 +1,28 @@
+#ifndef LOCAL_SOLUTION_CACHE_H__
+#define LOCAL_SOLUTION_CACHE_H__
+
+#include <map>
+#include <mutex>
+
+#include <blockwise/persistence/SolutionCache.h>
+
+/**
+ * A SolutionCache implemented locally in RAM.
+ */
+class LocalSolutionCache : public SolutionCache {
+
+public:
+
+	bool getSolution(std::size_t fingerprint, std::vector<double>& solution);
+
+	void storeSolution(std::size_t fingerprint, const std::vector<double>& solution);
+
+private:
+
+	std::mutex _mutex;
+
+	std::map<std::size_t, std::vector<double> > _solutions;
+};
+
+#endif //LOCAL_SOLUTION_CACHE_H__
+
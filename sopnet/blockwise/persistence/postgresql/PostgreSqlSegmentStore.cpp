@@ -333,6 +333,44 @@ PostgreSqlSegmentStore::getSegmentsByBlocks(
 	return segmentDescriptions;
 }
 
+bool
+PostgreSqlSegmentStore::getSegmentCounts(
+		const Block&  block,
+		unsigned int& numSegments,
+		unsigned int& numBranchSegments,
+		unsigned int& numSlices) {
+
+	if (!getSegmentsFlag(block))
+		return false;
+
+	const std::string blockQuery = PostgreSqlUtils::createBlockIdQuery(block);
+
+	// branch segments are the ones with three slices
+	std::string countQuery =
+			"WITH ss AS ("
+				"SELECT ss.segment_id, ss.slice_id "
+				"FROM segment_block_relation sbr "
+				"JOIN segment_slice ss ON ss.segment_id = sbr.segment_id "
+				"WHERE sbr.block_id = (" + blockQuery + ")), "
+			"s AS (SELECT count(*) AS n FROM ss GROUP BY ss.segment_id) "
+			"SELECT (SELECT count(*) FROM s), "
+			"(SELECT count(*) FROM s WHERE s.n = 3), "
+			"(SELECT count(DISTINCT ss.slice_id) FROM ss)";
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, countQuery.c_str());
+
+	PostgreSqlUtils::checkPostgreSqlError(queryResult, countQuery);
+
+	numSegments       = boost::lexical_cast<unsigned int>(PQgetvalue(queryResult, 0, 0));
+	numBranchSegments = boost::lexical_cast<unsigned int>(PQgetvalue(queryResult, 0, 1));
+	numSlices         = boost::lexical_cast<unsigned int>(PQgetvalue(queryResult, 0, 2));
+
+	PQclear(queryResult);
+
+	return true;
+}
+
 boost::shared_ptr<SegmentConstraints>
 PostgreSqlSegmentStore::getConstraintsByBlocks(
 		const Blocks& blocks) {
@@ -709,6 +747,67 @@ PostgreSqlSegmentStore::getSolutionByCores(const Cores& cores) {
 	return solution;
 }
 
+void
+PostgreSqlSegmentStore::storeSolutionStatus(
+		const SolutionStatus& status,
+		const Core&           core) {
+
+	// the status columns are added by migrations/0001_solution_status.sql,
+	// failing to store the status should not fail the solve
+	std::ostringstream query;
+	query << "UPDATE solution SET "
+			<< "status=" << static_cast<int>(status.getStatus()) << ", "
+			<< "cost=" << status.getCost() << " "
+			<< "WHERE id=(SELECT solution_id FROM solution_precedence WHERE core_id=("
+			<< PostgreSqlUtils::createCoreIdQuery(core) << "))";
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, query.str().c_str());
+
+	if (PQresultStatus(queryResult) != PGRES_COMMAND_OK)
+		LOG_ERROR(postgresqlsegmentstorelog)
+				<< "could not store solution status: "
+				<< PQresultErrorMessage(queryResult) << std::endl;
+
+	PQclear(queryResult);
+}
+
+bool
+PostgreSqlSegmentStore::getSolutionStatus(
+		const Core&     core,
+		SolutionStatus& status) {
+
+	std::ostringstream query;
+	query << "SELECT s.status, s.cost FROM solution s "
+			<< "JOIN solution_precedence sp ON sp.solution_id = s.id "
+			<< "WHERE sp.core_id=(" << PostgreSqlUtils::createCoreIdQuery(core) << ") "
+			<< "AND s.status IS NOT NULL";
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, query.str().c_str());
+
+	if (PQresultStatus(queryResult) != PGRES_TUPLES_OK) {
+
+		LOG_ERROR(postgresqlsegmentstorelog)
+				<< "could not get solution status: "
+				<< PQresultErrorMessage(queryResult) << std::endl;
+
+		PQclear(queryResult);
+		return false;
+	}
+
+	bool found = (PQntuples(queryResult) == 1);
+
+	if (found)
+		status = SolutionStatus(
+				static_cast<SolutionStatus::Status>(boost::lexical_cast<int>(PQgetvalue(queryResult, 0, 0))),
+				boost::lexical_cast<double>(PQgetvalue(queryResult, 0, 1)));
+
+	PQclear(queryResult);
+
+	return found;
+}
+
 bool
 PostgreSqlSegmentStore::getSegmentsFlag(const Block& block) {
 
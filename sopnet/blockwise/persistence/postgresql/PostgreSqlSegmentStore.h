@@ -58,6 +58,27 @@ public:
 			Blocks&       missingBlocks,
 			bool          readCosts);
 
+	/**
+	 * Count the segments of a block without reading them.
+	 *
+	 * @param block
+	 *              The block to count the segments of.
+	 * @param numSegments
+	 *              Will be set to the number of segments.
+	 * @param numBranchSegments
+	 *              Will be set to the number of branch segments.
+	 * @param numSlices
+	 *              Will be set to the number of distinct slices used by the 
+	 *              segments.
+	 * @return
+	 *              False, if the segments of the block were not extracted yet.
+	 */
+	bool getSegmentCounts(
+			const Block&  block,
+			unsigned int& numSegments,
+			unsigned int& numBranchSegments,
+			unsigned int& numSlices);
+
 	/**
 	 * Get additional constraints for segments in the given blocks. Typically
 	 * these would be user corrections to previous solutions or constraints
@@ -102,6 +123,28 @@ public:
 	 */
 	std::vector<std::set<SegmentHash> > getSolutionByCores(const Cores& cores);
 
+	/**
+	 * Record how the last stored solution of a core was obtained.
+	 *
+	 * @param status
+	 *              The status and cost of the solution.
+	 * @param core
+	 *              The core for which the solution was generated.
+	 */
+	void storeSolutionStatus(const SolutionStatus& status, const Core& core);
+
+	/**
+	 * Get the status of the last stored solution of a core.
+	 *
+	 * @param core
+	 *              The core to get the solution status for.
+	 * @param status
+	 *              Will be set to the status of the solution.
+	 * @return
+	 *              False, if there is no status for this core.
+	 */
+	bool getSolutionStatus(const Core& core, SolutionStatus& status);
+
 	/**
 	 * Check whether the segments for the given block have already been 
 	 * extracted.
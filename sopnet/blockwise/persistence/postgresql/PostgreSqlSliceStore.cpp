@@ -411,6 +411,34 @@ PostgreSqlSliceStore::getConflictSetsByBlocks(
 	return conflictSets;
 }
 
+bool
+PostgreSqlSliceStore::getNumConflictSets(const Block& block, unsigned int& numConflictSets) {
+
+	if (!getSlicesFlag(block))
+		return false;
+
+	const std::string blockQuery = PostgreSqlUtils::createBlockIdQuery(block);
+
+	// count the cliques as getConflictSetsByBlocks() reads them
+	std::string countQuery =
+			"SELECT count(DISTINCT cce.conflict_clique_id) "
+			"FROM conflict_clique_edge cce "
+			"JOIN block_conflict_relation bcr "
+			"ON bcr.slice_conflict_id = cce.slice_conflict_id "
+			"WHERE bcr.block_id = (" + blockQuery + ")";
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, countQuery.c_str());
+
+	PostgreSqlUtils::checkPostgreSqlError(queryResult, countQuery);
+
+	numConflictSets = boost::lexical_cast<unsigned int>(PQgetvalue(queryResult, 0, 0));
+
+	PQclear(queryResult);
+
+	return true;
+}
+
 bool
 PostgreSqlSliceStore::getSlicesFlag(const Block& block) {
 
@@ -81,6 +81,18 @@ public:
 			const Blocks& blocks,
 			Blocks&       missingBlocks);
 
+	/**
+	 * Count the conflict sets of a block without reading them.
+	 *
+	 * @param block
+	 *              The block to count the conflict sets of.
+	 * @param numConflictSets
+	 *              Will be set to the number of conflict sets.
+	 * @return
+	 *              False, if the slices of the block were not extracted yet.
+	 */
+	bool getNumConflictSets(const Block& block, unsigned int& numConflictSets);
+
 	/**
 	 * Check whether the slices for the given block have already been extracted.
 	 */
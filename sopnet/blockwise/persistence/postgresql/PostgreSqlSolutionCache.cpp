@@ -0,0 +1,106 @@
+#include "config.h"
+#ifdef HAVE_PostgreSQL
+
+#include <sstream>
+
+#include <util/Logger.h>
+#include "PostgreSqlSolutionCache.h"
+#include "PostgreSqlUtils.h"
+
+logger::LogChannel postgresqlsolutioncachelog("postgresqlsolutioncachelog", "[PostgreSqlSolutionCache] ");
+
+PostgreSqlSolutionCache::PostgreSqlSolutionCache(
+		const ProjectConfiguration& config,
+		const StackType type) {
+
+	_pgConnection = PostgreSqlUtils::getConnection(
+			config.getPostgreSqlHost(),
+			config.getPostgreSqlPort(),
+			config.getPostgreSqlDatabase(),
+			config.getPostgreSqlUser(),
+			config.getPostgreSqlPassword());
+
+	std::ostringstream q;
+	q << "SET search_path TO segstack_"
+	  << config.getCatmaidStack(type).segmentationId
+	  << ",public;";
+	PQsendQuery(_pgConnection, q.str().c_str());
+}
+
+PostgreSqlSolutionCache::~PostgreSqlSolutionCache() {
+
+	if (_pgConnection != 0) {
+		PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+		PQfinish(_pgConnection);
+	}
+}
+
+bool
+PostgreSqlSolutionCache::getSolution(std::size_t fingerprint, std::vector<double>& solution) {
+
+	std::ostringstream query;
+	query << "SELECT solution FROM solution_cache WHERE fingerprint="
+	      << PostgreSqlUtils::hashToPostgreSqlId(fingerprint);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, query.str().c_str());
+
+	// the cache is optional, don't fail if the table does not exist
+	if (PQresultStatus(queryResult) != PGRES_TUPLES_OK) {
+
+		LOG_ERROR(postgresqlsolutioncachelog)
+				<< "could not read solution cache: "
+				<< PQresultErrorMessage(queryResult) << std::endl;
+
+		PQclear(queryResult);
+		return false;
+	}
+
+	bool found = (PQntuples(queryResult) == 1);
+
+	if (found) {
+
+		const char* values = PQgetvalue(queryResult, 0, 0);
+		const int   size   = PQgetlength(queryResult, 0, 0);
+
+		solution.resize(size);
+		for (int i = 0; i < size; i++)
+			solution[i] = (values[i] == '1' ? 1.0 : 0.0);
+	}
+
+	PQclear(queryResult);
+
+	return found;
+}
+
+void
+PostgreSqlSolutionCache::storeSolution(std::size_t fingerprint, const std::vector<double>& solution) {
+
+	std::string values(solution.size(), '0');
+	for (unsigned int i = 0; i < solution.size(); i++)
+		if (solution[i] > 0.5)
+			values[i] = '1';
+
+	const PostgreSqlHash id = PostgreSqlUtils::hashToPostgreSqlId(fingerprint);
+
+	std::ostringstream query;
+	query << "INSERT INTO solution_cache (fingerprint, solution) "
+	      << "SELECT " << id << ", '" << values << "' "
+	      << "WHERE NOT EXISTS (SELECT 1 FROM solution_cache WHERE fingerprint=" << id << ")";
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	PostgreSqlUtils::waitForAsyncQuery(_pgConnection);
+	PGresult* queryResult = PQexec(_pgConnection, query.str().c_str());
+
+	if (PQresultStatus(queryResult) != PGRES_COMMAND_OK)
+		LOG_ERROR(postgresqlsolutioncachelog)
+				<< "could not store solution in cache: "
+				<< PQresultErrorMessage(queryResult) << std::endl;
+
+	PQclear(queryResult);
+}
+
+#endif // HAVE_PostgreSQL
@@ -0,0 +1,52 @@
+#ifndef POSTGRESQL_SOLUTION_CACHE_H__
+#define POSTGRESQL_SOLUTION_CACHE_H__
+
+#include "config.h"
+#ifdef HAVE_PostgreSQL
+
+#include <mutex>
+
+#include <blockwise/ProjectConfiguration.h>
+#include <blockwise/persistence/SolutionCache.h>
+#include <blockwise/persistence/StackType.h>
+#include <libpq-fe.h>
+
+/**
+ * A SolutionCache in the PostgreSql backend. Solutions are stored in the table 
+ * solution_cache (fingerprint bigint primary key, solution text) of the 
+ * segmentation stack, as a string of '0' and '1' per variable. Queries are 
+ * serialized, since a connection can not be shared between threads.
+ */
+class PostgreSqlSolutionCache : public SolutionCache {
+
+public:
+
+	/**
+	 * Create a PostgreSqlSolutionCache.
+	 *
+	 * @param config
+	 *             The project configuration with all required information.
+	 * @param type
+	 *             The stack type of the segmentation stack.
+	 */
+	PostgreSqlSolutionCache(
+			const ProjectConfiguration& config,
+			const StackType type);
+
+	~PostgreSqlSolutionCache();
+
+	bool getSolution(std::size_t fingerprint, std::vector<double>& solution);
+
+	void storeSolution(std::size_t fingerprint, const std::vector<double>& solution);
+
+private:
+
+	std::mutex _mutex;
+
+	PGconn* _pgConnection;
+};
+
+#endif // HAVE_PostgreSQL
+
+#endif //POSTGRESQL_SOLUTION_CACHE_H__
+
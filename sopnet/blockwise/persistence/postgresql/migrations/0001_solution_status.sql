@@ -0,0 +1,12 @@
+-- Adds the status of a solution (see SolutionStatus) to the solution table of
+-- a segmentation stack schema. Run once per segmentation stack, e.g.:
+--
+--   SET search_path TO segstack_<segmentation id>,public;
+--   \i 0001_solution_status.sql
+--
+-- The status of a core is the one of the solution its solution_precedence
+-- entry points to.
+
+ALTER TABLE solution
+	ADD COLUMN IF NOT EXISTS status integer,
+	ADD COLUMN IF NOT EXISTS cost double precision;
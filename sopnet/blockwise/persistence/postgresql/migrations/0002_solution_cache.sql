@@ -0,0 +1,13 @@
+-- Creates the table of PostgreSqlSolutionCache in a segmentation stack schema.
+-- Run once per segmentation stack, e.g.:
+--
+--   SET search_path TO segstack_<segmentation id>,public;
+--   \i 0002_solution_cache.sql
+--
+-- The fingerprint is the one of LinearSolverPool::getFingerprint(), the
+-- solution is a string of '0' and '1', one character per variable.
+
+CREATE TABLE IF NOT EXISTS solution_cache (
+	fingerprint bigint PRIMARY KEY,
+	solution text NOT NULL
+);
@@ -245,16 +245,27 @@ Distance::getDistanceMap(const Slice& slice) {
 
 	typedef std::map<unsigned int, distance_map_type> map_type;
 
-	map_type::const_iterator mapIter = _distanceMaps.find(slice.getId());
+	{
+		std::lock_guard<std::mutex> lock(_cacheMutex);
 
-	if (mapIter == _distanceMaps.end()) {
+		map_type::const_iterator mapIter = _distanceMaps.find(slice.getId());
 
-		std::pair<map_type::iterator, bool> newMap =
-				_distanceMaps.insert(map_type::value_type(slice.getId(), computeDistanceMap(slice)));
-		mapIter = newMap.first;
+		if (mapIter != _distanceMaps.end())
+			return mapIter->second;
 	}
 
-	return mapIter->second;
+	// compute the distance map without holding the lock -- if another thread 
+	// was faster, the insert below keeps its map and drops ours
+	distance_map_type distanceMap = computeDistanceMap(slice);
+
+	std::lock_guard<std::mutex> lock(_cacheMutex);
+
+	// references to map elements stay valid on insertion, so it is safe to 
+	// hand them out while other threads add more maps
+	std::pair<map_type::iterator, bool> newMap =
+			_distanceMaps.insert(map_type::value_type(slice.getId(), distanceMap));
+
+	return newMap.first->second;
 }
 
 const Distance::distance_map_type Distance::_EMPTY_DISTANCE_MAP = Distance::distance_map_type();
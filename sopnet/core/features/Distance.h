@@ -1,6 +1,9 @@
 #ifndef SOPNET_FEATURES_DISTANCE_H__
 #define SOPNET_FEATURES_DISTANCE_H__
 
+#include <map>
+#include <mutex>
+
 #include <vigra/multi_array.hxx>
 
 // forward declarations
@@ -10,6 +13,10 @@ class Slice;
  * Distance functor. Computes the pixel average and maximal minimal pixel 
  * distance between the pixels of one slice to all pixels of another slice.  
  * Caches distance maps internally. Use clearCache() to free memory.
+ *
+ * The cache is guarded by a mutex, such that the same Distance object can be 
+ * used from several threads concurrently. clearCache() must not be called 
+ * while other threads are still using the functor.
  */
 class Distance {
 
@@ -72,6 +79,7 @@ public:
 	 */
 	void clearCache() {
 
+		std::lock_guard<std::mutex> lock(_cacheMutex);
 		_distanceMaps.clear();
 	}
 
@@ -104,6 +112,9 @@ private:
 
 	std::map<unsigned int, distance_map_type> _distanceMaps;
 
+	// guards _distanceMaps
+	std::mutex _cacheMutex;
+
 	static const distance_map_type _EMPTY_DISTANCE_MAP;
 };
 
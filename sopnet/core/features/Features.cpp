@@ -1,10 +1,16 @@
+#include <algorithm>
+#include <boost/make_shared.hpp>
 #include <exceptions.h>
 #include "Features.h"
 
 double Features::NoFeatureValue = 0;
+double Features::SkippedFeatureValue = -1;
 
 Features::Features() :
-	_nextSegmentIndex(0) {}
+	_matrix(boost::make_shared<Matrix>()),
+	_firstColumn(0),
+	_numColumns(0),
+	_isView(false) {}
 
 void
 Features::addName(const std::string& name) {
@@ -21,103 +27,126 @@ Features::getNames() const {
 void
 Features::clear(){
 
-	_features.clear();
 	_featureNames.clear();
-	_segmentIdsMap.clear();
+	_matrix->segmentIdsMap.clear();
 
-	_nextSegmentIndex = 0;
+	_matrix->nextSegmentIndex = 0;
+}
+
+void
+Features::clearNames() {
+
+	_featureNames.clear();
 }
 
 void
 Features::resize(unsigned int numVectors, unsigned int numFeatures) {
 
-	std::vector<double> templ(numFeatures, 0.0);
+	if (!_isView) {
 
-	_features.resize(numVectors, templ);
-}
+		_matrix->numRows    = numVectors;
+		_matrix->numColumns = numFeatures;
+		_matrix->values.assign(numVectors*numFeatures, 0.0);
 
-unsigned int
-Features::numFeatures() {
+		_numColumns = numFeatures;
 
-	return _featureNames.size();
-}
+		return;
+	}
 
-std::vector<double>&
-Features::get(unsigned int segmentId) {
+	if (numFeatures != _numColumns)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"can not resize a view of " << _numColumns << " columns to " << numFeatures << " columns");
 
-	if (!_segmentIdsMap.count(segmentId)) {
+	if (_matrix->numRows != numVectors) {
 
-		_segmentIdsMap[segmentId] = _nextSegmentIndex;
-		_nextSegmentIndex++;
+		_matrix->numRows = numVectors;
+		_matrix->values.assign(numVectors*_matrix->numColumns, 0.0);
+
+		return;
 	}
 
-	return _features[_segmentIdsMap[segmentId]];
+	// reset only our block of columns, other views might already have written
+	// their values
+	for (unsigned int i = 0; i < _matrix->numRows; i++) {
+
+		row_type row = (*this)[i];
+		std::fill(row.begin(), row.end(), 0.0);
+	}
 }
 
-const std::vector<double>&
-Features::get(unsigned int segmentId) const {
+void
+Features::viewColumns(Features& matrix, unsigned int firstColumn, unsigned int numColumns) {
 
-	return _features.at(_segmentIdsMap.at(segmentId));
-}
+	if (firstColumn + numColumns > matrix._matrix->numColumns)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"columns [" << firstColumn << ", " << (firstColumn + numColumns)
+				<< ") exceed the " << matrix._matrix->numColumns << " columns of the matrix");
 
-unsigned int
-Features::count(unsigned int segmentId)
-{
-	return _segmentIdsMap.count(segmentId);
+	_matrix      = matrix._matrix;
+	_firstColumn = matrix._firstColumn + firstColumn;
+	_numColumns  = numColumns;
+	_isView      = true;
 }
 
 unsigned int
-Features::size(){
+Features::numFeatures() {
 
-	return _features.size();
+	return _featureNames.size();
 }
 
-Features::iterator
-Features::begin(){
+Features::row_type
+Features::get(unsigned int segmentId) {
+
+	segment_ids_map::const_iterator i = _matrix->segmentIdsMap.find(segmentId);
+
+	if (i == _matrix->segmentIdsMap.end())
+		i = _matrix->segmentIdsMap.insert(std::make_pair(segmentId, _matrix->nextSegmentIndex++)).first;
 
-	return _features.begin();
+	return (*this)[i->second];
 }
 
-Features::iterator
-Features::end(){
+Features::const_row_type
+Features::get(unsigned int segmentId) const {
 
-	return _features.end();
+	return (*this)[_matrix->segmentIdsMap.at(segmentId)];
 }
 
-Features::const_iterator
-Features::begin() const{
-
-	return _features.begin();
+unsigned int
+Features::count(unsigned int segmentId)
+{
+	return _matrix->segmentIdsMap.count(segmentId);
 }
 
-Features::const_iterator
-Features::end() const{
+unsigned int
+Features::size() const {
 
-	return _features.end();
+	return _matrix->numRows;
 }
 
-std::vector<double>&
+Features::row_type
 Features::operator[](unsigned int i) {
 
-	return _features[i];
+	return row_type(_matrix->values.data() + i*_matrix->numColumns + _firstColumn, _numColumns);
 }
 
-const std::vector<double>&
+Features::const_row_type
 Features::operator[](unsigned int i) const {
 
-	return _features[i];
+	return const_row_type(_matrix->values.data() + i*_matrix->numColumns + _firstColumn, _numColumns);
 }
 
 void
 Features::setSegmentIdsMap(const segment_ids_map& map) {
 
-	_segmentIdsMap = map;
+	_matrix->segmentIdsMap = map;
 }
 
 const Features::segment_ids_map&
 Features::getSegmentsIdsMap() const {
 
-	return _segmentIdsMap;
+	return _matrix->segmentIdsMap;
 }
 
 std::ostream&
@@ -8,49 +8,154 @@
 
 #include <pipeline/all.h>
 
+/**
+ * A row-major, contiguous matrix of segment features, one row per segment.
+ *
+ * Features can also be a view on a block of columns of another Features
+ * object. Views share the values and the mapping from segment ids to rows
+ * with the matrix they were created from. This is used by the feature
+ * extractors to write their feature groups directly into the final feature
+ * matrix. Rows are assigned to segments in the order of their first access,
+ * so all views on the same matrix have to visit the segments in the same
+ * order.
+ */
 class Features : public pipeline::Data {
 
-	typedef std::vector<std::vector<double> > features_type;
-
 	typedef std::map<unsigned int, unsigned int> segment_ids_map;
 
+	// the storage shared between a matrix and all its column views
+	struct Matrix {
+
+		Matrix() : numRows(0), numColumns(0), nextSegmentIndex(0) {}
+
+		// the feature values, row-major
+		std::vector<double> values;
+
+		unsigned int numRows;
+		unsigned int numColumns;
+
+		// a map from segment ids to the corresponding row
+		segment_ids_map segmentIdsMap;
+
+		unsigned int nextSegmentIndex;
+
+		template <class Archive>
+		void serialize(Archive& archive, const unsigned int /*version*/) {
+
+			archive & values;
+			archive & numRows;
+			archive & numColumns;
+			archive & segmentIdsMap;
+			archive & nextSegmentIndex;
+		}
+	};
+
 public:
 
-	Features();
+	/**
+	 * A lightweight view on the features of a single segment.
+	 */
+	template <typename ValueType>
+	class RowView {
+
+	public:
+
+		RowView(ValueType* begin, unsigned int size) :
+			_begin(begin),
+			_size(size) {}
 
-	typedef features_type::iterator iterator;
+		// allow conversion from mutable to const rows
+		template <typename OtherValueType>
+		RowView(const RowView<OtherValueType>& other) :
+			_begin(other.begin()),
+			_size(other.size()) {}
 
-	typedef features_type::const_iterator const_iterator;
+		ValueType& operator[](unsigned int i) const { return _begin[i]; }
+
+		unsigned int size() const { return _size; }
+
+		ValueType* begin() const { return _begin; }
+
+		ValueType* end() const { return _begin + _size; }
+
+	private:
+
+		ValueType*   _begin;
+		unsigned int _size;
+	};
+
+	typedef RowView<double>       row_type;
+	typedef RowView<const double> const_row_type;
+
+	Features();
 
 	void addName(const std::string& name);
 
 	const std::vector<std::string>& getNames() const;
 
+	/**
+	 * Remove all names and the mapping from segment ids to rows. The values
+	 * are kept until the next call to resize().
+	 */
 	void clear();
 
+	/**
+	 * Remove all names, but keep the mapping from segment ids to rows.
+	 */
+	void clearNames();
+
+	/**
+	 * Resize to the given number of rows and columns and set all values of
+	 * this matrix (or column view) to zero. For a view, numFeatures has to
+	 * match the width of the view. If the number of rows changes, the values
+	 * of all other views on the same matrix are reset as well.
+	 */
 	void resize(unsigned int numVectors, unsigned int numFeatures);
 
+	/**
+	 * Make this a view on the columns [firstColumn, firstColumn + numColumns)
+	 * of the given matrix.
+	 */
+	void viewColumns(Features& matrix, unsigned int firstColumn, unsigned int numColumns);
+
+	/**
+	 * Check whether this object shares its values with the given one.
+	 */
+	bool sharesMatrixWith(const Features& other) const { return _matrix == other._matrix; }
+
 	unsigned int numFeatures();
 
-	std::vector<double>& get(unsigned int segmentId);
+	/**
+	 * Get the features of the given segment. If the segment was not seen
+	 * before, the next free row is assigned to it.
+	 */
+	row_type get(unsigned int segmentId);
 
-	const std::vector<double>& get(unsigned int segmentId) const;
+	const_row_type get(unsigned int segmentId) const;
 
 	unsigned int count(unsigned int segmentId);
 
-	unsigned int size();
-
-	iterator begin();
+	/**
+	 * Get the index of the row of the given segment.
+	 */
+	unsigned int rowIndex(unsigned int segmentId) const { return _matrix->segmentIdsMap.at(segmentId); }
 
-	iterator end();
+	unsigned int size() const;
 
-	const_iterator begin() const;
+	row_type operator[](unsigned int i);
 
-	const_iterator end() const;
+	const_row_type operator[](unsigned int i) const;
 
-	std::vector<double>& operator[](unsigned int i);
+	/**
+	 * Direct access to the values of the first row. Consecutive rows are
+	 * stride() values apart.
+	 */
+	const double* data() const { return _matrix->values.data() + _firstColumn; }
 
-	const std::vector<double>& operator[](unsigned int i) const;
+	/**
+	 * The distance between two consecutive rows in data().
+	 */
+	unsigned int stride() const { return _matrix->numColumns; }
 
 	void setSegmentIdsMap(const segment_ids_map& map);
 
@@ -58,25 +163,35 @@ public:
 
 	static double NoFeatureValue;
 
+	/**
+	 * The value stored for features that were not computed, since their weight 
+	 * is zero. All features are non-negative, this value is not. It is finite, 
+	 * such that it vanishes in a weighted sum with zero weight.
+	 */
+	static double SkippedFeatureValue;
+
 private:
 
 	friend class boost::serialization::access;
 	template <class Archive>
-	void serialize(Archive& archive, const unsigned int version) {
+	void serialize(Archive& archive, const unsigned int /*version*/) {
 
-		archive & _features;
+		archive & *_matrix;
 		archive & _featureNames;
-		archive & _segmentIdsMap;
+		archive & _firstColumn;
+		archive & _numColumns;
+		archive & _isView;
 	}
 
-	features_type            _features;
+	boost::shared_ptr<Matrix> _matrix;
 
 	std::vector<std::string> _featureNames;
 
-	// a map from segment ids to the corresponding feature
-	segment_ids_map          _segmentIdsMap;
+	// the columns of the matrix covered by this object
+	unsigned int _firstColumn;
+	unsigned int _numColumns;
 
-	unsigned int             _nextSegmentIndex;
+	bool _isView;
 };
 
 std::ostream&
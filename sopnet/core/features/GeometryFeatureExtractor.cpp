@@ -21,23 +21,71 @@ GeometryFeatureExtractor::GeometryFeatureExtractor() :
 	_features(new Features()),
 	_overlap(false, false),
 	_alignedOverlap(false, true),
-	_noSliceDistance(optionDisableSliceDistanceFeature) {
+	_noSliceDistance(optionDisableSliceDistanceFeature),
+	_computeOverlap(true),
+	_computeAlignedOverlap(true),
+	_computeSliceDistance(!_noSliceDistance),
+	_computeAlignedSliceDistance(!_noSliceDistance) {
 
 	registerInput(_segments, "segments");
 	registerOutput(_features, "features");
 }
 
+unsigned int
+GeometryFeatureExtractor::getNumFeatures() const {
+
+	return (_noSliceDistance ? 12 : 16);
+}
+
+void
+GeometryFeatureExtractor::setActiveFeatures(const std::vector<bool>& activeFeatures) {
+
+	if (activeFeatures.empty()) {
+
+		_computeOverlap              = true;
+		_computeAlignedOverlap       = true;
+		_computeSliceDistance        = !_noSliceDistance;
+		_computeAlignedSliceDistance = !_noSliceDistance;
+
+		return;
+	}
+
+	if (activeFeatures.size() != getNumFeatures())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"got " << activeFeatures.size() << " active feature flags for "
+				<< getNumFeatures() << " geometry features");
+
+	// the set difference features are derived from the overlap
+	_computeOverlap =
+			activeFeatures[2]  || activeFeatures[3] ||
+			activeFeatures[8]  || activeFeatures[9];
+	_computeAlignedOverlap =
+			activeFeatures[4]  || activeFeatures[5] ||
+			activeFeatures[10] || activeFeatures[11];
+
+	_computeSliceDistance        = !_noSliceDistance && (activeFeatures[12] || activeFeatures[13]);
+	_computeAlignedSliceDistance = !_noSliceDistance && (activeFeatures[14] || activeFeatures[15]);
+
+	LOG_DEBUG(geometryfeatureextractorlog)
+			<< "computing overlap: " << _computeOverlap
+			<< ", aligned overlap: " << _computeAlignedOverlap
+			<< ", slice distance: " << _computeSliceDistance
+			<< ", aligned slice distance: " << _computeAlignedSliceDistance
+			<< std::endl;
+}
+
 void
 GeometryFeatureExtractor::updateOutputs() {
 
 	LOG_DEBUG(geometryfeatureextractorlog) << "extracting features" << std::endl;
 
+	// free memory of a previous parallel run
+	_distance.clearCache();
+
 	_features->clear();
 
-	if (_noSliceDistance)
-		_features->resize(_segments->size(), 12);
-	else
-		_features->resize(_segments->size(), 16);
+	_features->resize(_segments->size(), getNumFeatures());
 
 	// features for end segments
 	_features->addName("e size");
@@ -63,14 +111,16 @@ GeometryFeatureExtractor::updateOutputs() {
 		_features->addName("c&b aligned max slice distance");
 	}
 
-	for (boost::shared_ptr<EndSegment> segment : _segments->getEnds())
-		getFeatures(*segment);
+	getFeatures(_segments->getEnds());
+	getFeatures(_segments->getContinuations());
+	getFeatures(_segments->getBranches());
 
-	for (boost::shared_ptr<ContinuationSegment> segment : _segments->getContinuations())
-		getFeatures(*segment);
+	// in parallel mode, the features are not computed yet
+	if (_threadPool) {
 
-	for (boost::shared_ptr<BranchSegment> segment : _segments->getBranches())
-		getFeatures(*segment);
+		LOG_DEBUG(geometryfeatureextractorlog) << "scheduled feature computation" << std::endl;
+		return;
+	}
 
 	LOG_ALL(geometryfeatureextractorlog) << "found features: " << *_features << std::endl;
 
@@ -82,13 +132,40 @@ GeometryFeatureExtractor::updateOutputs() {
 
 template <typename SegmentType>
 void
-GeometryFeatureExtractor::getFeatures(const SegmentType& segment) {
+GeometryFeatureExtractor::getFeatures(const std::vector<boost::shared_ptr<SegmentType> >& segments) {
+
+	if (!_threadPool) {
+
+		for (boost::shared_ptr<SegmentType> segment : segments)
+			computeFeatures(*segment, _features->get(segment->getId()));
+
+		return;
+	}
+
+	typedef std::vector<std::pair<boost::shared_ptr<SegmentType>, Features::row_type> > work_type;
+
+	// Features::get() is not thread safe, so we find the rows of all segments 
+	// up-front -- the workers write straight into them
+	boost::shared_ptr<work_type> work = boost::make_shared<work_type>();
+	work->reserve(segments.size());
 
-	computeFeatures(segment, _features->get(segment.getId()));
+	for (boost::shared_ptr<SegmentType> segment : segments) {
+
+		work->push_back(std::make_pair(segment, _features->get(segment->getId())));
+
+		for (boost::shared_ptr<Slice> slice : segment->getSlices())
+			Overlap::prepare(*slice);
+	}
+
+	_threadPool->scheduleRange(work->size(), [this, work](unsigned int begin, unsigned int end) {
+
+		for (unsigned int i = begin; i < end; i++)
+			computeFeatures(*(*work)[i].first, (*work)[i].second);
+	});
 }
 
 void
-GeometryFeatureExtractor::computeFeatures(const EndSegment& end, std::vector<double>& features) {
+GeometryFeatureExtractor::computeFeatures(const EndSegment& end, Features::row_type features) {
 
 	features[0] = end.getSlice()->getComponent()->getSize();
 	features[1] = Features::NoFeatureValue;
@@ -113,7 +190,7 @@ GeometryFeatureExtractor::computeFeatures(const EndSegment& end, std::vector<dou
 }
 
 void
-GeometryFeatureExtractor::computeFeatures(const ContinuationSegment& continuation, std::vector<double>& features) {
+GeometryFeatureExtractor::computeFeatures(const ContinuationSegment& continuation, Features::row_type features) {
 
 	const util::point<double, 2>& sourceCenter = continuation.getSourceSlice()->getComponent()->getCenter();
 	const util::point<double, 2>& targetCenter = continuation.getTargetSlice()->getComponent()->getCenter();
@@ -125,54 +202,88 @@ GeometryFeatureExtractor::computeFeatures(const ContinuationSegment& continuatio
 
 	double distance = difference.x()*difference.x() + difference.y()*difference.y();
 
-	double overlap = _overlap(*continuation.getSourceSlice(), *continuation.getTargetSlice());
+	features[0] = Features::NoFeatureValue;
+	features[1] = distance;
+	features[6] = 0.5*(sourceSize + targetSize);
+	features[7] = abs(sourceSize - targetSize);
 
-	double overlapRatio = overlap/(sourceSize + targetSize - overlap);
+	// the aligned overlap ratio is normalized with the (unaligned) overlap
+	double overlap = Features::SkippedFeatureValue;
+	if (_computeOverlap || _computeAlignedOverlap)
+		overlap = _overlap(*continuation.getSourceSlice(), *continuation.getTargetSlice());
 
-	double alignedOverlap = _alignedOverlap(*continuation.getSourceSlice(), *continuation.getTargetSlice());
+	if (_computeOverlap) {
 
-	double alignedOverlapRatio = alignedOverlap/(sourceSize + targetSize - overlap);
+		double overlapRatio = overlap/(sourceSize + targetSize - overlap);
 
-	double setDifference = (sourceSize - overlap) + (targetSize - overlap);
+		double setDifference = (sourceSize - overlap) + (targetSize - overlap);
 
-	double setDifferenceRatio = setDifference/(sourceSize + targetSize);
+		double setDifferenceRatio = setDifference/(sourceSize + targetSize);
 
-	double alignedSetDifference = (sourceSize - alignedOverlap) + (targetSize - alignedOverlap);
+		features[2] = setDifference;
+		features[3] = setDifferenceRatio;
+		features[8] = overlap;
+		features[9] = overlapRatio;
 
-	double alignedSetDifferenceRatio = alignedSetDifference/(sourceSize + targetSize);
+	} else {
 
-	features[0] = Features::NoFeatureValue;
-	features[1] = distance;
-	features[2] = setDifference;
-	features[3] = setDifferenceRatio;
-	features[4] = alignedSetDifference;
-	features[5] = alignedSetDifferenceRatio;
-	features[6] = 0.5*(sourceSize + targetSize);
-	features[7] = abs(sourceSize - targetSize);
-	features[8] = overlap;
-	features[9] = overlapRatio;
-	features[10] = alignedOverlap;
-	features[11] = alignedOverlapRatio;
+		skip(features, {2, 3, 8, 9});
+	}
 
-	if (!_noSliceDistance) {
+	if (_computeAlignedOverlap) {
+
+		double alignedOverlap = _alignedOverlap(*continuation.getSourceSlice(), *continuation.getTargetSlice());
+
+		double alignedOverlapRatio = alignedOverlap/(sourceSize + targetSize - overlap);
+
+		double alignedSetDifference = (sourceSize - alignedOverlap) + (targetSize - alignedOverlap);
+
+		double alignedSetDifferenceRatio = alignedSetDifference/(sourceSize + targetSize);
+
+		features[4] = alignedSetDifference;
+		features[5] = alignedSetDifferenceRatio;
+		features[10] = alignedOverlap;
+		features[11] = alignedOverlapRatio;
+
+	} else {
+
+		skip(features, {4, 5, 10, 11});
+	}
+
+	if (_noSliceDistance)
+		return;
+
+	if (_computeSliceDistance) {
 
 		double averageSliceDistance, maxSliceDistance;
 
 		_distance(*continuation.getSourceSlice(), *continuation.getTargetSlice(), true, false, averageSliceDistance, maxSliceDistance);
 
+		features[12] = averageSliceDistance;
+		features[13] = maxSliceDistance;
+
+	} else {
+
+		skip(features, {12, 13});
+	}
+
+	if (_computeAlignedSliceDistance) {
+
 		double alignedAverageSliceDistance, alignedMaxSliceDistance;
 
 		_distance(*continuation.getSourceSlice(), *continuation.getTargetSlice(), true, true, alignedAverageSliceDistance, alignedMaxSliceDistance);
 
-		features[12] = averageSliceDistance;
-		features[13] = maxSliceDistance;
 		features[14] = alignedAverageSliceDistance;
 		features[15] = alignedMaxSliceDistance;
+
+	} else {
+
+		skip(features, {14, 15});
 	}
 }
 
 void
-GeometryFeatureExtractor::computeFeatures(const BranchSegment& branch, std::vector<double>& features) {
+GeometryFeatureExtractor::computeFeatures(const BranchSegment& branch, Features::row_type features) {
 
 	const util::point<double, 2>& sourceCenter  = branch.getSourceSlice()->getComponent()->getCenter();
 	const util::point<double, 2>& targetCenter1 = branch.getTargetSlice1()->getComponent()->getCenter();
@@ -188,48 +299,86 @@ GeometryFeatureExtractor::computeFeatures(const BranchSegment& branch, std::vect
 	double distance = difference.x()*difference.x() + difference.y()*difference.y();
 
 
-	double overlap = _overlap(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice());
+	features[0] = Features::NoFeatureValue;
+	features[1] = distance;
+	features[6] = 1.0/3.0*(sourceSize + targetSize);
+	features[7] = abs(sourceSize - targetSize);
+
+	if (_computeOverlap) {
 
-	double overlapRatio = overlap/(sourceSize + targetSize - overlap);
+		double overlap = _overlap(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice());
 
-	double alignedOverlap = _alignedOverlap(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice());
+		double overlapRatio = overlap/(sourceSize + targetSize - overlap);
 
-	double alignedOverlapRatio = alignedOverlap/(sourceSize + targetSize - alignedOverlap);
+		double setDifference = (sourceSize - overlap) + (targetSize - overlap);
 
-	double setDifference = (sourceSize - overlap) + (targetSize - overlap);
+		double setDifferenceRatio = setDifference/(sourceSize + targetSize);
 
-	double setDifferenceRatio = setDifference/(sourceSize + targetSize);
+		features[2] = setDifference;
+		features[3] = setDifferenceRatio;
+		features[8] = overlap;
+		features[9] = overlapRatio;
 
-	double alignedSetDifference = (sourceSize - alignedOverlap) + (targetSize - alignedOverlap);
+	} else {
 
-	double alignedSetDifferenceRatio = alignedSetDifference/(sourceSize + targetSize);
+		skip(features, {2, 3, 8, 9});
+	}
 
-	features[0] = Features::NoFeatureValue;
-	features[1] = distance;
-	features[2] = setDifference;
-	features[3] = setDifferenceRatio;
-	features[4] = alignedSetDifference;
-	features[5] = alignedSetDifferenceRatio;
-	features[6] = 1.0/3.0*(sourceSize + targetSize);
-	features[7] = abs(sourceSize - targetSize);
-	features[8] = overlap;
-	features[9] = overlapRatio;
-	features[10] = alignedOverlap;
-	features[11] = alignedOverlapRatio;
+	if (_computeAlignedOverlap) {
 
-	if (!_noSliceDistance) {
+		double alignedOverlap = _alignedOverlap(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice());
+
+		double alignedOverlapRatio = alignedOverlap/(sourceSize + targetSize - alignedOverlap);
+
+		double alignedSetDifference = (sourceSize - alignedOverlap) + (targetSize - alignedOverlap);
+
+		double alignedSetDifferenceRatio = alignedSetDifference/(sourceSize + targetSize);
+
+		features[4] = alignedSetDifference;
+		features[5] = alignedSetDifferenceRatio;
+		features[10] = alignedOverlap;
+		features[11] = alignedOverlapRatio;
+
+	} else {
+
+		skip(features, {4, 5, 10, 11});
+	}
+
+	if (_noSliceDistance)
+		return;
+
+	if (_computeSliceDistance) {
 
 		double averageSliceDistance, maxSliceDistance;
 
 		_distance(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice(), true, false, averageSliceDistance, maxSliceDistance);
 
+		features[12] = averageSliceDistance;
+		features[13] = maxSliceDistance;
+
+	} else {
+
+		skip(features, {12, 13});
+	}
+
+	if (_computeAlignedSliceDistance) {
+
 		double alignedAverageSliceDistance, alignedMaxSliceDistance;
 
 		_distance(*branch.getTargetSlice1(), *branch.getTargetSlice2(), *branch.getSourceSlice(), true, true, alignedAverageSliceDistance, alignedMaxSliceDistance);
 
-		features[12] = averageSliceDistance;
-		features[13] = maxSliceDistance;
 		features[14] = alignedAverageSliceDistance;
 		features[15] = alignedMaxSliceDistance;
+
+	} else {
+
+		skip(features, {14, 15});
 	}
 }
+
+void
+GeometryFeatureExtractor::skip(Features::row_type features, std::initializer_list<unsigned int> columns) {
+
+	for (unsigned int column : columns)
+		features[column] = Features::SkippedFeatureValue;
+}
@@ -1,7 +1,9 @@
 #ifndef SOPNET_GEOMETRY_FEATURE_EXTRACTOR_H_
 #define SOPNET_GEOMETRY_FEATURE_EXTRACTOR_H_
 
+#include <initializer_list>
 #include <pipeline/all.h>
+#include <threads/ThreadPool.h>
 #include <segments/Segments.h>
 #include "Distance.h"
 #include "Features.h"
@@ -13,16 +15,44 @@ public:
 
 	GeometryFeatureExtractor();
 
+	/**
+	 * Write the features directly into the given columns of another feature 
+	 * matrix, instead of allocating an own one.
+	 */
+	void writeToColumns(Features& matrix, unsigned int firstColumn) { _features->viewColumns(matrix, firstColumn, getNumFeatures()); }
+
+	/**
+	 * The number of features computed per segment.
+	 */
+	unsigned int getNumFeatures() const;
+
+	/**
+	 * Restrict the computation to groups of features that contain at least 
+	 * one active feature. Features of skipped groups are set to 
+	 * Features::SkippedFeatureValue. An empty vector activates all features.
+	 */
+	void setActiveFeatures(const std::vector<bool>& activeFeatures);
+
+	/**
+	 * Compute the features in parallel on the given thread pool. Features are 
+	 * only scheduled for computation in updateOutputs(), the owner of the pool 
+	 * has to wait() for it before the output can be used.
+	 */
+	void setThreadPool(boost::shared_ptr<ThreadPool> threadPool) { _threadPool = threadPool; }
+
 private:
 
 	template <typename SegmentType>
-	void getFeatures(const SegmentType& segment);
+	void getFeatures(const std::vector<boost::shared_ptr<SegmentType> >& segments);
+
+	void computeFeatures(const EndSegment& end, Features::row_type features);
 
-	void computeFeatures(const EndSegment& end, std::vector<double>& features);
+	void computeFeatures(const ContinuationSegment& continuation, Features::row_type features);
 
-	void computeFeatures(const ContinuationSegment& continuation, std::vector<double>& features);
+	void computeFeatures(const BranchSegment& branch, Features::row_type features);
 
-	void computeFeatures(const BranchSegment& branch, std::vector<double>& features);
+	// set the given columns to Features::SkippedFeatureValue
+	static void skip(Features::row_type features, std::initializer_list<unsigned int> columns);
 
 	void updateOutputs();
 
@@ -36,6 +66,14 @@ private:
 	Distance _distance;
 
 	bool _noSliceDistance;
+
+	// which of the expensive feature groups to compute
+	bool _computeOverlap;
+	bool _computeAlignedOverlap;
+	bool _computeSliceDistance;
+	bool _computeAlignedSliceDistance;
+
+	boost::shared_ptr<ThreadPool> _threadPool;
 };
 
 #endif // SOPNET_GEOMETRY_FEATURE_EXTRACTOR_H_
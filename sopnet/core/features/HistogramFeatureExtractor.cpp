@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 
 #include <imageprocessing/ConnectedComponent.h>
+#include <exceptions.h>
 #include <segments/EndSegment.h>
 #include <segments/ContinuationSegment.h>
 #include <segments/BranchSegment.h>
@@ -12,7 +14,9 @@ logger::LogChannel histogramfeaturelog("histogramfeaturelog", "[HistogramFeature
 
 HistogramFeatureExtractor::HistogramFeatureExtractor(unsigned int numBins) :
 	_features(new Features()),
-	_numBins(numBins) {
+	_numBins(numBins),
+	_computeEndHistograms(true),
+	_computeHistogramDifferences(true) {
 
 	registerInput(_segments, "segments");
 	registerInput(_sections, "raw sections");
@@ -20,6 +24,40 @@ HistogramFeatureExtractor::HistogramFeatureExtractor(unsigned int numBins) :
 	registerOutput(_features, "features");
 }
 
+unsigned int
+HistogramFeatureExtractor::getNumFeatures() const {
+
+	return 4*_numBins;
+}
+
+void
+HistogramFeatureExtractor::setActiveFeatures(const std::vector<bool>& activeFeatures) {
+
+	if (activeFeatures.empty()) {
+
+		_computeEndHistograms        = true;
+		_computeHistogramDifferences = true;
+
+		return;
+	}
+
+	if (activeFeatures.size() != getNumFeatures())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"got " << activeFeatures.size() << " active feature flags for "
+				<< getNumFeatures() << " histogram features");
+
+	std::vector<bool>::const_iterator differences = activeFeatures.begin() + 2*_numBins;
+
+	_computeEndHistograms        = std::find(activeFeatures.begin(), differences, true) != differences;
+	_computeHistogramDifferences = std::find(differences, activeFeatures.end(), true) != activeFeatures.end();
+
+	LOG_DEBUG(histogramfeaturelog)
+			<< "computing end histograms: " << _computeEndHistograms
+			<< ", histogram differences: " << _computeHistogramDifferences
+			<< std::endl;
+}
+
 void
 HistogramFeatureExtractor::updateOutputs() {
 
@@ -49,20 +87,50 @@ HistogramFeatureExtractor::updateOutputs() {
 	for (unsigned int i = 0; i < _numBins; i++)
 		_features->addName("c&b normalized histogram " + boost::lexical_cast<std::string>(i));
 
-	_features->resize(_segments->size(), 4*_numBins);
+	_features->resize(_segments->size(), getNumFeatures());
+
+	getFeatures(_segments->getEnds());
+	getFeatures(_segments->getContinuations());
+	getFeatures(_segments->getBranches());
+}
 
-	for (boost::shared_ptr<EndSegment> segment : _segments->getEnds())
-		getFeatures(*segment, _features->get(segment->getId()));
+template <typename SegmentType>
+void
+HistogramFeatureExtractor::getFeatures(const std::vector<boost::shared_ptr<SegmentType> >& segments) {
 
-	for (boost::shared_ptr<ContinuationSegment> segment : _segments->getContinuations())
-		getFeatures(*segment, _features->get(segment->getId()));
+	if (!_threadPool) {
 
-	for (boost::shared_ptr<BranchSegment> segment : _segments->getBranches())
-		getFeatures(*segment, _features->get(segment->getId()));
+		for (boost::shared_ptr<SegmentType> segment : segments)
+			getFeatures(*segment, _features->get(segment->getId()));
+
+		return;
+	}
+
+	typedef std::vector<std::pair<boost::shared_ptr<SegmentType>, Features::row_type> > work_type;
+
+	// Features::get() is not thread safe, so we find the rows of all segments 
+	// up-front -- the workers write straight into them
+	boost::shared_ptr<work_type> work = boost::make_shared<work_type>();
+	work->reserve(segments.size());
+
+	for (boost::shared_ptr<SegmentType> segment : segments)
+		work->push_back(std::make_pair(segment, _features->get(segment->getId())));
+
+	_threadPool->scheduleRange(work->size(), [this, work](unsigned int begin, unsigned int end) {
+
+		for (unsigned int i = begin; i < end; i++)
+			getFeatures(*(*work)[i].first, (*work)[i].second);
+	});
 }
 
 void
-HistogramFeatureExtractor::getFeatures(const EndSegment& end, std::vector<double>& features) {
+HistogramFeatureExtractor::getFeatures(const EndSegment& end, Features::row_type features) {
+
+	if (!_computeEndHistograms) {
+
+		std::fill(features.begin(), features.begin() + 2*_numBins, Features::SkippedFeatureValue);
+		return;
+	}
 
 	std::vector<double> histogram = computeHistogram(*end.getSlice().get());
 
@@ -78,7 +146,13 @@ HistogramFeatureExtractor::getFeatures(const EndSegment& end, std::vector<double
 }
 
 void
-HistogramFeatureExtractor::getFeatures(const ContinuationSegment& continuation, std::vector<double>& features) {
+HistogramFeatureExtractor::getFeatures(const ContinuationSegment& continuation, Features::row_type features) {
+
+	if (!_computeHistogramDifferences) {
+
+		std::fill(features.begin() + 2*_numBins, features.end(), Features::SkippedFeatureValue);
+		return;
+	}
 
 	std::vector<double> sourceHistogram = computeHistogram(*continuation.getSourceSlice().get());
 	std::vector<double> targetHistogram = computeHistogram(*continuation.getTargetSlice().get());
@@ -99,7 +173,13 @@ HistogramFeatureExtractor::getFeatures(const ContinuationSegment& continuation,
 }
 
 void
-HistogramFeatureExtractor::getFeatures(const BranchSegment& branch, std::vector<double>& features) {
+HistogramFeatureExtractor::getFeatures(const BranchSegment& branch, Features::row_type features) {
+
+	if (!_computeHistogramDifferences) {
+
+		std::fill(features.begin() + 2*_numBins, features.end(), Features::SkippedFeatureValue);
+		return;
+	}
 
 	std::vector<double> sourceHistogram  = computeHistogram(*branch.getSourceSlice().get());
 	std::vector<double> targetHistogram1 = computeHistogram(*branch.getTargetSlice1().get());
@@ -5,6 +5,7 @@
 #include <imageprocessing/ImageStack.h>
 #include <segments/Segments.h>
 #include <features/Features.h>
+#include <threads/ThreadPool.h>
 #include <util/point.hpp>
 
 class HistogramFeatureExtractor : public pipeline::SimpleProcessNode<> {
@@ -13,15 +14,43 @@ public:
 
 	HistogramFeatureExtractor(unsigned int numBins);
 
+	/**
+	 * Write the features directly into the given columns of another feature 
+	 * matrix, instead of allocating an own one.
+	 */
+	void writeToColumns(Features& matrix, unsigned int firstColumn) { _features->viewColumns(matrix, firstColumn, getNumFeatures()); }
+
+	/**
+	 * The number of features computed per segment.
+	 */
+	unsigned int getNumFeatures() const;
+
+	/**
+	 * Restrict the computation to groups of features that contain at least 
+	 * one active feature. Features of skipped groups are set to 
+	 * Features::SkippedFeatureValue. An empty vector activates all features.
+	 */
+	void setActiveFeatures(const std::vector<bool>& activeFeatures);
+
+	/**
+	 * Compute the features in parallel on the given thread pool. Features are 
+	 * only scheduled for computation in updateOutputs(), the owner of the pool 
+	 * has to wait() for it before the output can be used.
+	 */
+	void setThreadPool(boost::shared_ptr<ThreadPool> threadPool) { _threadPool = threadPool; }
+
 private:
 
 	void updateOutputs();
 
-	void getFeatures(const EndSegment& end, std::vector<double>& slice);
+	template <typename SegmentType>
+	void getFeatures(const std::vector<boost::shared_ptr<SegmentType> >& segments);
+
+	void getFeatures(const EndSegment& end, Features::row_type features);
 
-	void getFeatures(const ContinuationSegment& continuation, std::vector<double>& slice);
+	void getFeatures(const ContinuationSegment& continuation, Features::row_type features);
 
-	void getFeatures(const BranchSegment& branch, std::vector<double>& slice);
+	void getFeatures(const BranchSegment& branch, Features::row_type features);
 
 	std::vector<double> computeHistogram(const Slice& slice);
 
@@ -34,6 +63,13 @@ private:
 	pipeline::Output<Features> _features;
 
 	unsigned int _numBins;
+
+	// compute the histograms of end segments and the histogram differences of 
+	// continuation and branch segments
+	bool _computeEndHistograms;
+	bool _computeHistogramDifferences;
+
+	boost::shared_ptr<ThreadPool> _threadPool;
 };
 
 #endif // SOPNET_HISTOGRAM_FEATURE_EXTRACTOR_H_
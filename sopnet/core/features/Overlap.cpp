@@ -4,7 +4,7 @@
 #include "Overlap.h"
 
 double
-Overlap::operator()(const Slice& slice1, const Slice& slice2) {
+Overlap::operator()(const Slice& slice1, const Slice& slice2) const {
 
 	// values to add to slice2's pixel positions
 	util::point<int, 2> offset2(0, 0);
@@ -29,7 +29,7 @@ Overlap::operator()(const Slice& slice1, const Slice& slice2) {
 }
 
 double
-Overlap::operator()(const Slice& slice1a, const Slice& slice1b, const Slice& slice2) {
+Overlap::operator()(const Slice& slice1a, const Slice& slice1b, const Slice& slice2) const {
 
 	// values to add to slice2's pixel positions
 	util::point<int, 2> offset2(0, 0);
@@ -70,14 +70,14 @@ Overlap::operator()(const Slice& slice1a, const Slice& slice1b, const Slice& sli
 }
 
 bool
-Overlap::exceeds(const Slice& slice1, const Slice& slice2, double value) {
+Overlap::exceeds(const Slice& slice1, const Slice& slice2, double value) const {
 
 	double _;
 	return exceeds(slice1, slice2, value, _);
 }
 
 bool
-Overlap::exceeds(const Slice& slice1, const Slice& slice2, double value, double& exceededValue) {
+Overlap::exceeds(const Slice& slice1, const Slice& slice2, double value, double& exceededValue) const {
 
 	/**
 	 * First, compute the upper bound for the slice overlap based on the 
@@ -115,7 +115,7 @@ Overlap::exceeds(const Slice& slice1, const Slice& slice2, double value, double&
 }
 
 bool
-Overlap::exceeds(const Slice& slice1a, const Slice& slice1b, const Slice& slice2, double value) {
+Overlap::exceeds(const Slice& slice1a, const Slice& slice1b, const Slice& slice2, double value) const {
 
 	/**
 	 * First, compute the upper bound for the slice overlap based on the 
@@ -162,7 +162,7 @@ unsigned int
 Overlap::overlap(
 		const ConnectedComponent& c1,
 		const ConnectedComponent& c2,
-		const util::point<int, 2>& offset2) {
+		const util::point<int, 2>& offset2) const {
 
 	if (!c1.getBoundingBox().intersects(c2.getBoundingBox() + offset2))
 		return 0;
@@ -219,3 +219,9 @@ Overlap::normalize(const Slice& slice1a, const Slice& slice1b, const Slice& slic
 
 	return static_cast<double>(overlap)/totalSize;
 }
+
+void
+Overlap::prepare(const Slice& slice) {
+
+	slice.getComponent()->getBitmap();
+}
@@ -25,7 +25,7 @@ struct Overlap {
 	 * Compute the overlap between the pixels in slice1 and slice2.
 	 *
 	 */
-	double operator()(const Slice& slice1, const Slice& slice2);
+	double operator()(const Slice& slice1, const Slice& slice2) const;
 
 	/**
 	 * Compute the overlap between the union of the pixels in slice1a and
@@ -37,7 +37,7 @@ struct Overlap {
 	 *              other. For slice1a and slice1b, the mean of the centers is
 	 *              used.
 	 */
-	double operator()(const Slice& slice1a, const Slice& slice1b, const Slice& slice2);
+	double operator()(const Slice& slice1a, const Slice& slice1b, const Slice& slice2) const;
 
 	/**
 	 * Returns true if the overlap between the given slices exceeds the 
@@ -48,7 +48,7 @@ struct Overlap {
 	 * @param slice2 The second slice.
 	 * @param value  The overlap threshold value.
 	 */
-	bool exceeds(const Slice& slice1, const Slice& slice2, double value);
+	bool exceeds(const Slice& slice1, const Slice& slice2, double value) const;
 
 	/**
 	 * Returns true if the overlap between the given slices exceeds the 
@@ -61,7 +61,7 @@ struct Overlap {
 	 * @param exceededValue If value was exceeded, this value will contain the 
 	 * actual overlap value.
 	 */
-	bool exceeds(const Slice& slice1, const Slice& slice2, double value, double& exceededValue);
+	bool exceeds(const Slice& slice1, const Slice& slice2, double value, double& exceededValue) const;
 
 	/**
 	 * Returns true if the overlap between the given slices exceeds the 
@@ -73,7 +73,7 @@ struct Overlap {
 	 * @param slice2  The second slice.
 	 * @param value   The overlap threshold value.
 	 */
-	bool exceeds(const Slice& slice1a, const Slice& slice1b, const Slice& slice2, double value);
+	bool exceeds(const Slice& slice1a, const Slice& slice1b, const Slice& slice2, double value) const;
 
 	/**
 	 * Normalize an absolute overlap value to the range [0, 1].
@@ -97,12 +97,21 @@ struct Overlap {
 	 */
 	static double normalize(const Slice& slice1a, const Slice& slice1b, const Slice& slice2, unsigned int overlap);
 
+	/**
+	 * Overlap itself does not hold any state, but the connected components of 
+	 * slices compute their bitmaps lazily on first access. Call this for every 
+	 * slice before using Overlap concurrently from several threads.
+	 *
+	 * @param slice The slice to prepare.
+	 */
+	static void prepare(const Slice& slice);
+
 private:
 
 	unsigned int overlap(
 			const ConnectedComponent& c1,
 			const ConnectedComponent& c2,
-			const util::point<int, 2>& offset2);
+			const util::point<int, 2>& offset2) const;
 
 	bool _normalized;
 
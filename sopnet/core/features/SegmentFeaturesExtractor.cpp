@@ -1,3 +1,5 @@
+#include <util/ProgramOptions.h>
+#include <exceptions.h>
 #include "SegmentFeaturesExtractor.h"
 #include "GeometryFeatureExtractor.h"
 #include "HistogramFeatureExtractor.h"
@@ -5,6 +7,12 @@
 
 logger::LogChannel segmentfeaturesextractorlog("segmentfeaturesextractorlog", "[SegmentFeaturesExtractor] ");
 
+util::ProgramOption optionFeatureExtractionThreads(
+		util::_module           = "sopnet.features",
+		util::_long_name        = "featureExtractionThreads",
+		util::_description_text = "The number of threads to use for the extraction of segment features. Set to 0 to use all hardware threads.",
+		util::_default_value    = 1);
+
 SegmentFeaturesExtractor::SegmentFeaturesExtractor() :
 	_geometryFeatureExtractor(boost::make_shared<GeometryFeatureExtractor>()),
 	_histogramFeatureExtractor(boost::make_shared<HistogramFeatureExtractor>(10)),
@@ -24,6 +32,94 @@ SegmentFeaturesExtractor::SegmentFeaturesExtractor() :
 	_featuresAssembler->addInput(_geometryFeatureExtractor->getOutput());
 	_featuresAssembler->addInput(_histogramFeatureExtractor->getOutput());
 	_featuresAssembler->addInput(_typeFeatureExtractor->getOutput());
+
+	// let the extractors write directly into their columns of the assembled 
+	// feature matrix
+	Features& allFeatures = _featuresAssembler->getAllFeatures();
+
+	unsigned int numGeometryFeatures  = _geometryFeatureExtractor->getNumFeatures();
+	unsigned int numHistogramFeatures = _histogramFeatureExtractor->getNumFeatures();
+	unsigned int numTypeFeatures      = _typeFeatureExtractor->getNumFeatures();
+
+	allFeatures.resize(0, numGeometryFeatures + numHistogramFeatures + numTypeFeatures);
+
+	_geometryFeatureExtractor->writeToColumns(allFeatures, 0);
+	_histogramFeatureExtractor->writeToColumns(allFeatures, numGeometryFeatures);
+	_typeFeatureExtractor->writeToColumns(allFeatures, numGeometryFeatures + numHistogramFeatures);
+
+	setNumThreads(optionFeatureExtractionThreads.as<unsigned int>());
+}
+
+SegmentFeaturesExtractor::~SegmentFeaturesExtractor() {
+
+	// Work might still be scheduled, if the assembler was never asked for its 
+	// output. Make sure it is done before the extractors go away.
+	if (_threadPool) {
+
+		try {
+
+			_threadPool->wait();
+
+		} catch (...) {
+
+			LOG_ERROR(segmentfeaturesextractorlog) << "feature extraction failed" << std::endl;
+		}
+	}
+}
+
+void
+SegmentFeaturesExtractor::setNumThreads(unsigned int numThreads) {
+
+	if (_threadPool)
+		_threadPool->wait();
+
+	boost::shared_ptr<ThreadPool> threadPool;
+
+	if (ThreadPool::resolveNumThreads(numThreads) > 1)
+		threadPool = boost::make_shared<ThreadPool>(numThreads);
+
+	LOG_DEBUG(segmentfeaturesextractorlog)
+			<< "extracting features with "
+			<< (threadPool ? threadPool->size() : 1) << " threads" << std::endl;
+
+	_threadPool = threadPool;
+
+	// The type features are cheap to compute, they stay serial. The geometry 
+	// and histogram extractors only schedule their work on the pool, such that 
+	// both of them are processed concurrently until the assembler waits for 
+	// the pool.
+	_geometryFeatureExtractor->setThreadPool(threadPool);
+	_histogramFeatureExtractor->setThreadPool(threadPool);
+	_featuresAssembler->setThreadPool(threadPool);
+}
+
+void
+SegmentFeaturesExtractor::setActiveFeatures(const std::vector<bool>& activeFeatures) {
+
+	if (activeFeatures.empty()) {
+
+		_geometryFeatureExtractor->setActiveFeatures(activeFeatures);
+		_histogramFeatureExtractor->setActiveFeatures(activeFeatures);
+
+		return;
+	}
+
+	unsigned int numGeometryFeatures  = _geometryFeatureExtractor->getNumFeatures();
+	unsigned int numHistogramFeatures = _histogramFeatureExtractor->getNumFeatures();
+	unsigned int numTypeFeatures      = _typeFeatureExtractor->getNumFeatures();
+
+	if (activeFeatures.size() != numGeometryFeatures + numHistogramFeatures + numTypeFeatures)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"got " << activeFeatures.size() << " active feature flags, but there are "
+				<< (numGeometryFeatures + numHistogramFeatures + numTypeFeatures) << " features");
+
+	std::vector<bool>::const_iterator histogramBegin = activeFeatures.begin() + numGeometryFeatures;
+	std::vector<bool>::const_iterator histogramEnd   = histogramBegin + numHistogramFeatures;
+
+	// the type features are always computed, they are cheap
+	_geometryFeatureExtractor->setActiveFeatures(std::vector<bool>(activeFeatures.begin(), histogramBegin));
+	_histogramFeatureExtractor->setActiveFeatures(std::vector<bool>(histogramBegin, histogramEnd));
 }
 
 void
@@ -55,56 +151,34 @@ SegmentFeaturesExtractor::FeaturesAssembler::FeaturesAssembler() :
 void
 SegmentFeaturesExtractor::FeaturesAssembler::updateOutputs() {
 
+	if (_threadPool) {
+
+		LOG_DEBUG(segmentfeaturesextractorlog) << "waiting for feature extractors" << std::endl;
+		_threadPool->wait();
+	}
+
 	LOG_DEBUG(segmentfeaturesextractorlog) << "assembling features from " << _features.size() << " feature groups" << std::endl;
 
-	_allFeatures->clear();
+	// The values were written into our columns by the feature extractors 
+	// already, and the segment ids map is shared. We only collect the names.
+	_allFeatures->clearNames();
 
 	for (boost::shared_ptr<Features> features : _features) {
 
-		LOG_ALL(segmentfeaturesextractorlog) << "processing feature group" << std::endl << std::endl << *features << std::endl;
-
-		for (const std::string& name : features->getNames()) {
+		if (!features->sharesMatrixWith(*_allFeatures))
+			UTIL_THROW_EXCEPTION(
+					UsageError,
+					"feature groups have to be written into the columns of the assembled features");
 
-			LOG_ALL(segmentfeaturesextractorlog) << "adding name " << name << std::endl;
+		for (const std::string& name : features->getNames())
 			_allFeatures->addName(name);
-		}
-
-		if (_allFeatures->size() == 0) {
-
-			LOG_ALL(segmentfeaturesextractorlog) << "initialising all features with " << features->size() << " feature vectors from current feature group" << std::endl;
-
-			unsigned int numFeatures = (features->size() > 0  ? (*features)[0].size() : 0);
-
-			_allFeatures->resize(features->size(), numFeatures);
-
-			unsigned int i = 0;
-			for (const std::vector<double>& feature : *features) {
-
-				std::copy(feature.begin(), feature.end(), (*_allFeatures)[i].begin());
-				i++;
-			}
-
-		} else {
-
-			LOG_ALL(segmentfeaturesextractorlog) << "appending " << features->size() << " features from current feature group" << std::endl;
-
-			unsigned int i = 0;
-			for (const std::vector<double>& feature : *features) {
-
-				unsigned int prevSize = (*_allFeatures)[i].size();
-				unsigned int newSize  = prevSize + feature.size();
-
-				(*_allFeatures)[i].resize(newSize);
-
-				std::copy(feature.begin(), feature.end(), (*_allFeatures)[i].begin() + prevSize);
-
-				i++;
-			}
-		}
-
-		LOG_ALL(segmentfeaturesextractorlog) << "all features are now:" << std::endl << std::endl << *_allFeatures << std::endl;
 	}
 
-	// the new features should have the same segment ids map like every features
-	_allFeatures->setSegmentIdsMap(_features[0]->getSegmentsIdsMap());
+	if (_allFeatures->numFeatures() != _allFeatures->stride())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"got " << _allFeatures->numFeatures() << " feature names for "
+				<< _allFeatures->stride() << " feature columns");
+
+	LOG_ALL(segmentfeaturesextractorlog) << "all features are:" << std::endl << std::endl << *_allFeatures << std::endl;
 }
@@ -3,6 +3,7 @@
 
 #include <pipeline/all.h>
 #include <imageprocessing/ImageStack.h>
+#include <threads/ThreadPool.h>
 #include <segments/Segments.h>
 #include <util/point.hpp>
 #include "Features.h"
@@ -27,9 +28,36 @@ public:
 	 * 
 	 * Outputs:
 	 *  Features "all features" - the Features extracted from "segments" 
+	 *
+	 * The number of threads used for the extraction is read from the program 
+	 * option sopnet.features.featureExtractionThreads.
 	 */
 	SegmentFeaturesExtractor();
 
+	~SegmentFeaturesExtractor();
+
+	/**
+	 * Set the number of threads to use for the feature extraction. With more 
+	 * than one thread, the segments are split into chunks that are processed 
+	 * by all feature extractors concurrently.
+	 *
+	 * @param numThreads
+	 *              The number of threads. 0 uses all hardware threads, 1 
+	 *              extracts the features serially.
+	 */
+	void setNumThreads(unsigned int numThreads);
+
+	/**
+	 * Compute only the feature groups that contain at least one active 
+	 * feature, e.g., one with a non-zero weight. The other features are set to 
+	 * Features::SkippedFeatureValue.
+	 *
+	 * @param activeFeatures
+	 *              One flag per column of "all features". An empty vector 
+	 *              activates all features.
+	 */
+	void setActiveFeatures(const std::vector<bool>& activeFeatures);
+
 private:
 
 	class FeaturesAssembler : public pipeline::SimpleProcessNode<> {
@@ -38,10 +66,24 @@ private:
 
 		FeaturesAssembler();
 
+		/**
+		 * The pool the feature extractors scheduled their work on. The 
+		 * assembler waits for it before reading the feature groups.
+		 */
+		void setThreadPool(boost::shared_ptr<ThreadPool> threadPool) { _threadPool = threadPool; }
+
+		/**
+		 * The assembled feature matrix. The feature groups have to be column 
+		 * views on it (see Features::viewColumns()).
+		 */
+		Features& getAllFeatures() { return *_allFeatures; }
+
 	private:
 
 		void updateOutputs();
 
+		boost::shared_ptr<ThreadPool> _threadPool;
+
 		pipeline::Inputs<Features> _features;
 
 		pipeline::Output<Features> _allFeatures;
@@ -64,6 +106,10 @@ private:
 	boost::shared_ptr<TypeFeatureExtractor> _typeFeatureExtractor;
 
 	boost::shared_ptr<FeaturesAssembler> _featuresAssembler;
+
+	// shared by the feature extractors and the assembler, if extracting in 
+	// parallel
+	boost::shared_ptr<ThreadPool> _threadPool;
 };
 
 #endif // SOPNET_SEGMENT_FEATURES_EXTRACTOR_H__
@@ -12,6 +12,12 @@ TypeFeatureExtractor::TypeFeatureExtractor() :
 	registerOutput(_features, "features");
 }
 
+unsigned int
+TypeFeatureExtractor::getNumFeatures() const {
+
+	return 3;
+}
+
 void
 TypeFeatureExtractor::updateOutputs() {
 
@@ -20,7 +26,7 @@ TypeFeatureExtractor::updateOutputs() {
 	_features->clear();
 
 	// end, continuation, branch
-	_features->resize(_segments->size(), 3);
+	_features->resize(_segments->size(), getNumFeatures());
 
 	_features->addName("is end");
 	_features->addName("is continuation");
@@ -11,16 +11,27 @@ public:
 
 	TypeFeatureExtractor();
 
+	/**
+	 * Write the features directly into the given columns of another feature 
+	 * matrix, instead of allocating an own one.
+	 */
+	void writeToColumns(Features& matrix, unsigned int firstColumn) { _features->viewColumns(matrix, firstColumn, getNumFeatures()); }
+
+	/**
+	 * The number of features computed per segment.
+	 */
+	unsigned int getNumFeatures() const;
+
 private:
 
 	template <typename SegmentType>
 	void getFeatures(const SegmentType& segment);
 
-	void computeFeatures(const EndSegment& end, std::vector<double>& features);
+	void computeFeatures(const EndSegment& end, Features::row_type features);
 
-	void computeFeatures(const ContinuationSegment& continuation, std::vector<double>& features);
+	void computeFeatures(const ContinuationSegment& continuation, Features::row_type features);
 
-	void computeFeatures(const BranchSegment& branch, std::vector<double>& features);
+	void computeFeatures(const BranchSegment& branch, Features::row_type features);
 
 	void updateOutputs();
 
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <stack>
+
+#include <util/Logger.h>
+#include <exceptions.h>
+#include "CompiledRandomForest.h"
+
+static logger::LogChannel compiledrandomforestlog("compiledrandomforestlog", "[CompiledRandomForest] ");
+
+CompiledRandomForest::CompiledRandomForest() :
+	_numFeatures(0),
+	_numClasses(0) {}
+
+void
+CompiledRandomForest::compile(const vigra::RandomForest<unsigned int>& rf) {
+
+	_nodes.clear();
+	_roots.clear();
+	_leafValues.clear();
+
+	_numFeatures = rf.feature_count();
+	_numClasses  = rf.class_count();
+
+	const bool weighted = rf.options_.predict_weighted_;
+
+	for (int t = 0; t < rf.tree_count(); t++) {
+
+		const vigra::ArrayVector<vigra::Int32>& topology   = rf.trees_[t].topology_;
+		const vigra::ArrayVector<double>&       parameters = rf.trees_[t].parameters_;
+
+		_roots.push_back(_nodes.size());
+
+		// pairs of (vigra node index, index of the parent's child slot to
+		// update, or -1 for the root)
+		std::stack<std::pair<vigra::Int32, int> > pending;
+
+		// vigra stores the number of features and classes in front of the root
+		pending.push(std::make_pair(2, -1));
+
+		while (!pending.empty()) {
+
+			vigra::Int32 index  = pending.top().first;
+			int          parent = pending.top().second;
+			pending.pop();
+
+			unsigned int nodeIndex = _nodes.size();
+
+			if (parent >= 0)
+				_nodes[parent/2].children[parent%2] = nodeIndex;
+
+			Node node;
+
+			vigra::Int32 type          = topology[index];
+			vigra::Int32 parameterAddr = topology[index + 1];
+
+			if (type == vigra::e_ConstProbNode) {
+
+				double leafWeight = (weighted ? parameters[parameterAddr] : 1.0);
+
+				node.feature     = -1;
+				node.threshold   = 0;
+				node.children[0] = _leafValues.size();
+				node.children[1] = 0;
+
+				for (unsigned int c = 0; c < _numClasses; c++)
+					_leafValues.push_back(leafWeight*parameters[parameterAddr + 1 + c]);
+
+				_nodes.push_back(node);
+
+			} else if (type == vigra::i_ThresholdNode) {
+
+				node.feature     = topology[index + 4];
+				node.threshold   = parameters[parameterAddr + 1];
+				node.children[0] = 0;
+				node.children[1] = 0;
+
+				_nodes.push_back(node);
+
+				// push the right child first, such that the left one directly
+				// follows its parent
+				pending.push(std::make_pair(topology[index + 3], 2*nodeIndex + 1));
+				pending.push(std::make_pair(topology[index + 2], 2*nodeIndex));
+
+			} else {
+
+				UTIL_THROW_EXCEPTION(
+						NotYetImplemented,
+						"random forest node type " << type << " is not supported, only threshold splits are");
+			}
+		}
+	}
+
+	LOG_DEBUG(compiledrandomforestlog)
+			<< "compiled " << _roots.size() << " trees with "
+			<< _nodes.size() << " nodes" << std::endl;
+}
+
+void
+CompiledRandomForest::getProbabilities(
+		const double* samples,
+		unsigned int  numSamples,
+		unsigned int  stride,
+		double*       probabilities,
+		ThreadPool*   threadPool) const {
+
+	if (!isCompiled())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"the random forest was not compiled");
+
+	if (numSamples > 0 && stride < _numFeatures)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"samples have a stride of " << stride << ", but the random forest uses " << _numFeatures << " features");
+
+	if (!threadPool) {
+
+		predict(samples, 0, numSamples, stride, probabilities);
+		return;
+	}
+
+	threadPool->scheduleRange(numSamples, [this, samples, stride, probabilities](unsigned int begin, unsigned int end) {
+
+		predict(samples, begin, end, stride, probabilities);
+	});
+
+	threadPool->wait();
+}
+
+void
+CompiledRandomForest::predict(
+		const double* samples,
+		unsigned int  begin,
+		unsigned int  end,
+		unsigned int  stride,
+		double*       probabilities) const {
+
+	std::fill(probabilities + begin*_numClasses, probabilities + end*_numClasses, 0.0);
+
+	// evaluate tree by tree, such that the nodes of one tree stay in the cache
+	// for all samples
+	for (unsigned int root : _roots) {
+
+		for (unsigned int s = begin; s < end; s++) {
+
+			const double* sample = samples + static_cast<size_t>(s)*stride;
+
+			const Node* node = &_nodes[root];
+			while (node->feature >= 0)
+				node = &_nodes[node->children[sample[node->feature] < node->threshold ? 0 : 1]];
+
+			const double* leafValues = &_leafValues[node->children[0]];
+			double*       p          = probabilities + s*_numClasses;
+
+			for (unsigned int c = 0; c < _numClasses; c++)
+				p[c] += leafValues[c];
+		}
+	}
+
+	for (unsigned int s = begin; s < end; s++) {
+
+		double* p = probabilities + s*_numClasses;
+
+		double total = 0;
+		for (unsigned int c = 0; c < _numClasses; c++)
+			total += p[c];
+
+		if (total > 0)
+			for (unsigned int c = 0; c < _numClasses; c++)
+				p[c] /= total;
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef SOPNET_INFERENCE_COMPILED_RANDOM_FOREST_H__
+#define SOPNET_INFERENCE_COMPILED_RANDOM_FOREST_H__
+
+#include <vector>
+
+#include <vigra/random_forest.hxx>
+
+#include <threads/ThreadPool.h>
+
+/**
+ * A read-only copy of a trained vigra random forest, flattened into
+ * contiguous node arrays for fast batch prediction. Only forests with
+ * threshold splits (the vigra default) are supported.
+ *
+ * Predictions are the same as vigra's predictProbabilities(): the class
+ * distributions of the leaves reached in each tree are summed (weighted by
+ * the leaf weight, if the forest predicts weighted) and normalized.
+ */
+class CompiledRandomForest {
+
+public:
+
+	CompiledRandomForest();
+
+	/**
+	 * Flatten the trees of the given forest.
+	 */
+	void compile(const vigra::RandomForest<unsigned int>& rf);
+
+	/**
+	 * True, if compile() was called on a forest with at least one tree.
+	 */
+	bool isCompiled() const { return !_roots.empty(); }
+
+	unsigned int getNumFeatures() const { return _numFeatures; }
+
+	unsigned int getNumClasses() const { return _numClasses; }
+
+	/**
+	 * Get the class probabilities for a batch of samples.
+	 *
+	 * @param samples
+	 *              Pointer to the first feature of the first sample.
+	 * @param numSamples
+	 *              The number of samples.
+	 * @param stride
+	 *              The distance between two consecutive samples in samples.
+	 * @param probabilities
+	 *              Pointer to numSamples*getNumClasses() values, receives the
+	 *              class probabilities of each sample, one row per sample.
+	 * @param threadPool
+	 *              Optional thread pool to split the samples over.
+	 */
+	void getProbabilities(
+			const double* samples,
+			unsigned int  numSamples,
+			unsigned int  stride,
+			double*       probabilities,
+			ThreadPool*   threadPool = 0) const;
+
+private:
+
+	// A split or leaf node. For splits, feature is the feature to compare
+	// against threshold, and children[0] and [1] are the indices of the nodes
+	// for smaller and greater or equal values. For leaves, feature is -1 and
+	// children[0] is the offset of the class distribution in _leafValues.
+	struct Node {
+
+		int          feature;
+		double       threshold;
+		unsigned int children[2];
+	};
+
+	// evaluate all trees for samples [begin, end)
+	void predict(
+			const double* samples,
+			unsigned int  begin,
+			unsigned int  end,
+			unsigned int  stride,
+			double*       probabilities) const;
+
+	// the nodes of all trees, each tree is stored depth-first
+	std::vector<Node> _nodes;
+
+	// the index of the root node of each tree
+	std::vector<unsigned int> _roots;
+
+	// the (weighted) class distributions of all leaves
+	std::vector<double> _leafValues;
+
+	unsigned int _numFeatures;
+	unsigned int _numClasses;
+};
+
+#endif // SOPNET_INFERENCE_COMPILED_RANDOM_FOREST_H__
+
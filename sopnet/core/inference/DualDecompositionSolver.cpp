@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/make_shared.hpp>
+
+#include <pipeline/Value.h>
+#include <threads/ThreadPool.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "DualDecompositionSolver.h"
+
+logger::LogChannel dualdecompositionsolverlog("dualdecompositionsolverlog", "[DualDecompositionSolver] ");
+
+util::ProgramOption optionDualDecompositionIterations(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "dualDecompositionIterations",
+		util::_description_text = "The maximal number of subgradient iterations of the dual decomposition solver.",
+		util::_default_value    = 100);
+
+util::ProgramOption optionDualDecompositionThreads(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "dualDecompositionThreads",
+		util::_description_text = "The number of slave problems to solve in parallel. Set to 0 to use all hardware threads.",
+		util::_default_value    = 1);
+
+util::ProgramOption optionDualDecompositionStepSize(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "dualDecompositionStepSize",
+		util::_description_text = "The scale of the subgradient step size of the dual decomposition solver.",
+		util::_default_value    = 1.0);
+
+DualDecompositionSolver::DualDecompositionSolver() :
+	_solution(new Solution()),
+	_constant(0),
+	_maxIterations(optionDualDecompositionIterations.as<unsigned int>()),
+	_numThreads(optionDualDecompositionThreads.as<unsigned int>()),
+	_stepSize(optionDualDecompositionStepSize.as<double>()) {
+
+	registerInput(_problems, "problems");
+	registerInput(_configuration, "problem configuration");
+	registerOutput(_solution, "solution");
+}
+
+void
+DualDecompositionSolver::updateOutputs() {
+
+	createSlaves();
+
+	unsigned int numThreads = std::min(
+			ThreadPool::resolveNumThreads(_numThreads),
+			(unsigned int)_slaves.size());
+
+	const double infinity = std::numeric_limits<double>::infinity();
+
+	double bestDual   = -infinity;
+	double bestPrimal =  infinity;
+
+	std::vector<double> assignment(_numCopies.size());
+	std::vector<double> bestAssignment;
+	std::vector<double> averages(_numCopies.size());
+
+	_iterations.clear();
+
+	for (unsigned int iteration = 0; iteration < _maxIterations; iteration++) {
+
+		double dual = solveSlaves(numThreads);
+
+		// average the slave solutions on the global variables
+
+		std::fill(averages.begin(), averages.end(), 0.0);
+
+		for (const Slave& slave : _slaves)
+			for (unsigned int i = 0; i < slave.values.size(); i++)
+				averages[slave.globalVariables[i]] += slave.values[i];
+
+		for (unsigned int var = 0; var < averages.size(); var++)
+			if (_numCopies[var] > 0)
+				averages[var] /= _numCopies[var];
+
+		// the subgradient of the dual is the difference of each slave to the
+		// average
+
+		double norm = 0;
+		for (const Slave& slave : _slaves)
+			for (unsigned int i = 0; i < slave.values.size(); i++)
+				norm += std::pow(slave.values[i] - averages[slave.globalVariables[i]], 2);
+
+		// the primal assignment is the majority vote of the slaves
+
+		for (unsigned int var = 0; var < averages.size(); var++)
+			assignment[var] = (averages[var] > 0.5 ? 1.0 : 0.0);
+
+		double primal = getPrimalValue(assignment);
+
+		if (primal < bestPrimal) {
+
+			bestPrimal     = primal;
+			bestAssignment = assignment;
+		}
+
+		bestDual = std::max(bestDual, dual);
+
+		Iteration bounds;
+		bounds.dual   = dual;
+		bounds.primal = primal;
+		_iterations.push_back(bounds);
+
+		LOG_USER(dualdecompositionsolverlog)
+				<< "iteration " << iteration << ": dual bound " << dual
+				<< ", primal " << primal << ", best gap "
+				<< (bestPrimal - bestDual) << std::endl;
+
+		// all slaves agree, the solution is optimal
+		if (norm == 0) {
+
+			LOG_USER(dualdecompositionsolverlog) << "slaves agree on all shared variables" << std::endl;
+			break;
+		}
+
+		// without a feasible primal, there is no gap to close
+		if (bestPrimal < infinity && bestPrimal - bestDual <= 1e-6*std::abs(bestPrimal)) {
+
+			LOG_USER(dualdecompositionsolverlog) << "primal and dual bounds met" << std::endl;
+			break;
+		}
+
+		// Polyak step if we have a feasible primal, diminishing step otherwise
+		double step;
+		if (bestPrimal < infinity)
+			step = _stepSize*(bestPrimal - dual)/norm;
+		else
+			step = _stepSize/(iteration + 1);
+
+		// the multipliers of each variable sum to zero, such that the slaves
+		// together still model the original objective
+		for (Slave& slave : _slaves)
+			for (unsigned int i = 0; i < slave.values.size(); i++)
+				slave.multipliers[i] += step*(slave.values[i] - averages[slave.globalVariables[i]]);
+	}
+
+	if (bestAssignment.empty()) {
+
+		LOG_USER(dualdecompositionsolverlog) << "no feasible assignment found, using majority vote" << std::endl;
+		bestAssignment = assignment;
+	}
+
+	*_solution = Solution(bestAssignment.size());
+	for (unsigned int var = 0; var < bestAssignment.size(); var++)
+		(*_solution)[var] = bestAssignment[var];
+}
+
+void
+DualDecompositionSolver::createSlaves() {
+
+	std::set<unsigned int> variables = _configuration->getVariables();
+
+	unsigned int numVariables = (variables.empty() ? 0 : *variables.rbegin() + 1);
+
+	_slaves.clear();
+	_slaves.resize(_problems->size());
+	_numCopies.assign(numVariables, 0);
+	_globalCosts.assign(numVariables, 0.0);
+	_constant = 0;
+
+	for (unsigned int i = 0; i < _problems->size(); i++) {
+
+		Slave& slave = _slaves[i];
+
+		slave.problem = _problems->getProblem(i);
+
+		boost::shared_ptr<LinearObjective>      objective     = slave.problem->getObjective();
+		boost::shared_ptr<ProblemConfiguration> configuration = slave.problem->getConfiguration();
+
+		slave.globalVariables.resize(objective->size());
+		slave.costs.resize(objective->size());
+		slave.multipliers.assign(objective->size(), 0.0);
+		slave.values.assign(objective->size(), 0.0);
+
+		for (unsigned int var = 0; var < objective->size(); var++) {
+
+			unsigned int globalVar = _configuration->getVariable(configuration->getSegmentId(var));
+
+			slave.globalVariables[var] = globalVar;
+			_numCopies[globalVar]++;
+			_globalCosts[globalVar] = objective->getCoefficients()[var];
+		}
+
+		_constant += objective->getConstant();
+
+		// only the objective changes between iterations
+		slave.solver->setInput("linear constraints", slave.problem->getLinearConstraints());
+		slave.solver->setInput("parameters", boost::make_shared<LinearSolverParameters>(Binary));
+	}
+
+	// split the costs of each variable evenly between its slaves
+	for (Slave& slave : _slaves)
+		for (unsigned int var = 0; var < slave.costs.size(); var++) {
+
+			unsigned int globalVar = slave.globalVariables[var];
+
+			slave.costs[var] = _globalCosts[globalVar]/_numCopies[globalVar];
+		}
+
+	LOG_DEBUG(dualdecompositionsolverlog)
+			<< "created " << _slaves.size() << " slaves over "
+			<< numVariables << " variables" << std::endl;
+}
+
+double
+DualDecompositionSolver::solveSlaves(unsigned int numThreads) {
+
+	// set the objectives here, the workers only pull the outputs
+
+	for (Slave& slave : _slaves) {
+
+		slave.objective = boost::make_shared<LinearObjective>(*slave.problem->getObjective());
+
+		for (unsigned int var = 0; var < slave.costs.size(); var++)
+			slave.objective->setCoefficient(var, slave.costs[var] + slave.multipliers[var]);
+
+		// setting a new objective marks the solver dirty, the backend is kept
+		slave.solver->setInput("objective", slave.objective);
+	}
+
+	ThreadPool threadPool(std::max(numThreads, 1u));
+
+	for (unsigned int i = 0; i < _slaves.size(); i++)
+		threadPool.schedule([this, i]() {
+
+			Slave& slave = _slaves[i];
+
+			pipeline::Value<Solution> solution = slave.solver->getOutput("solution");
+
+			for (unsigned int var = 0; var < slave.values.size(); var++)
+				slave.values[var] = (*solution)[var];
+		});
+
+	threadPool.wait();
+
+	// the sum of the slave minima is a lower bound
+
+	double dual = 0;
+	for (const Slave& slave : _slaves) {
+
+		dual += slave.objective->getConstant();
+
+		for (unsigned int var = 0; var < slave.values.size(); var++)
+			dual += slave.objective->getCoefficients()[var]*slave.values[var];
+	}
+
+	return dual;
+}
+
+double
+DualDecompositionSolver::getPrimalValue(const std::vector<double>& assignment) {
+
+	for (const Slave& slave : _slaves)
+		for (const LinearConstraint& constraint : *slave.problem->getLinearConstraints()) {
+
+			double value = 0;
+			for (const auto& pair : constraint.getCoefficients())
+				value += pair.second*assignment[slave.globalVariables[pair.first]];
+
+			double tolerance = 1e-6;
+
+			if ((constraint.getRelation() == LessEqual    && value > constraint.getValue() + tolerance) ||
+			    (constraint.getRelation() == GreaterEqual && value < constraint.getValue() - tolerance) ||
+			    (constraint.getRelation() == Equal        && std::abs(value - constraint.getValue()) > tolerance))
+				return std::numeric_limits<double>::infinity();
+		}
+
+	double value = _constant;
+	for (unsigned int var = 0; var < assignment.size(); var++)
+		value += _globalCosts[var]*assignment[var];
+
+	return value;
+}
@@ -0,0 +1,120 @@
+#ifndef SOPNET_INFERENCE_DUAL_DECOMPOSITION_SOLVER_H__
+#define SOPNET_INFERENCE_DUAL_DECOMPOSITION_SOLVER_H__
+
+#include <pipeline/all.h>
+#include <pipeline/Process.h>
+#include <solvers/LinearSolver.h>
+#include <solvers/Solution.h>
+#include "ProblemConfiguration.h"
+#include "Problems.h"
+
+/**
+ * Solves a problem that is decomposed into overlapping problems (the slaves)
+ * by dual decomposition with subgradient updates. Variables are identified
+ * across slaves by their segment ids. The costs of a variable are split evenly
+ * between all slaves that contain it, and Lagrange multipliers enforce that the
+ * slaves agree on shared variables.
+ *
+ * The slaves are minimized with a LinearSolver, and are assumed to have linear
+ * objectives. The output "solution" is indexed by the variables of the input
+ * "problem configuration", and is the best feasible assignment found (or the
+ * majority vote of the slaves after the last iteration, if none was
+ * feasible).
+ */
+class DualDecompositionSolver : public pipeline::SimpleProcessNode<> {
+
+public:
+
+	/**
+	 * The bounds after one iteration.
+	 */
+	struct Iteration {
+
+		// the dual (lower) bound of this iteration
+		double dual;
+
+		// the value of the primal assignment of this iteration, or infinity if
+		// it was not feasible
+		double primal;
+	};
+
+	DualDecompositionSolver();
+
+	/**
+	 * Set the maximal number of subgradient iterations.
+	 */
+	void setMaxIterations(unsigned int maxIterations) { _maxIterations = maxIterations; }
+
+	/**
+	 * Set the number of slaves to solve in parallel. 0 uses all hardware
+	 * threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * Get the bounds of each iteration of the last solve.
+	 */
+	const std::vector<Iteration>& getIterations() const { return _iterations; }
+
+private:
+
+	struct Slave {
+
+		boost::shared_ptr<Problem> problem;
+
+		// the global variable of each slave variable
+		std::vector<unsigned int> globalVariables;
+
+		// the share of the costs of each slave variable
+		std::vector<double> costs;
+
+		// the Lagrange multiplier of each slave variable
+		std::vector<double> multipliers;
+
+		// the solution of the last iteration
+		std::vector<double> values;
+
+		// the solver of this slave, kept over all iterations such that only
+		// the objective changes
+		pipeline::Process<LinearSolver> solver;
+
+		// the objective of the last iteration
+		boost::shared_ptr<LinearObjective> objective;
+	};
+
+	void updateOutputs();
+
+	// create the slaves and split the costs
+	void createSlaves();
+
+	// solve all slaves with the current multipliers, return the dual bound
+	double solveSlaves(unsigned int numThreads);
+
+	// get the value of a global assignment, or infinity if it violates a
+	// constraint of one of the slaves
+	double getPrimalValue(const std::vector<double>& assignment);
+
+	pipeline::Input<Problems>             _problems;
+	pipeline::Input<ProblemConfiguration> _configuration;
+	pipeline::Output<Solution>            _solution;
+
+	std::vector<Slave> _slaves;
+
+	// the number of slaves that contain a global variable
+	std::vector<unsigned int> _numCopies;
+
+	// the summed costs of each global variable
+	std::vector<double> _globalCosts;
+
+	// the summed constants of the slave objectives
+	double _constant;
+
+	std::vector<Iteration> _iterations;
+
+	unsigned int _maxIterations;
+	unsigned int _numThreads;
+	double       _stepSize;
+};
+
+#endif // SOPNET_INFERENCE_DUAL_DECOMPOSITION_SOLVER_H__
+
@@ -18,6 +18,16 @@ public:
 	 */
 	bool next();
 
+	/**
+	 * Get the current prior cost function parameters.
+	 */
+	const PriorCostFunctionParameters& getPriorCostFunctionParameters() { return *_priorCostFunctionParameters; }
+
+	/**
+	 * Get the current segmentation cost function parameters.
+	 */
+	const SegmentationCostFunctionParameters& getSegmentationCostFunctionParameters() { return *_segmentationCostFunctionParameters; }
+
 	/**
 	 * Get the current configuration as a string.
 	 *
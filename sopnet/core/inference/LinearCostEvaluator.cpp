@@ -0,0 +1,136 @@
+#include <exceptions.h>
+#include "LinearCostEvaluator.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOPNET_HAVE_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+
+void
+addCostsScalar(
+		const double* weights,
+		unsigned int  numWeights,
+		const double* features,
+		unsigned int  numRows,
+		unsigned int  stride,
+		double*       costs) {
+
+	for (unsigned int row = 0; row < numRows; row++) {
+
+		const double* f = features + static_cast<size_t>(row)*stride;
+
+		double cost = 0;
+		for (unsigned int i = 0; i < numWeights; i++)
+			cost += f[i]*weights[i];
+
+		costs[row] += cost;
+	}
+}
+
+#ifdef SOPNET_HAVE_AVX2_DISPATCH
+
+__attribute__((target("avx2,fma")))
+void
+addCostsAvx2(
+		const double* weights,
+		unsigned int  numWeights,
+		const double* features,
+		unsigned int  numRows,
+		unsigned int  stride,
+		double*       costs) {
+
+	// the part of the rows that can be processed in chunks of 8
+	const unsigned int numVectorized = numWeights - numWeights%8;
+
+	for (unsigned int row = 0; row < numRows; row++) {
+
+		const double* f = features + static_cast<size_t>(row)*stride;
+
+		// two accumulators to hide the latency of the FMA
+		__m256d sum0 = _mm256_setzero_pd();
+		__m256d sum1 = _mm256_setzero_pd();
+
+		unsigned int i = 0;
+		for (; i < numVectorized; i += 8) {
+
+			sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(f + i),     _mm256_loadu_pd(weights + i),     sum0);
+			sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(f + i + 4), _mm256_loadu_pd(weights + i + 4), sum1);
+		}
+
+		__m256d sum  = _mm256_add_pd(sum0, sum1);
+		__m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+		double cost  = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+		for (; i < numWeights; i++)
+			cost += f[i]*weights[i];
+
+		costs[row] += cost;
+	}
+}
+
+bool
+cpuSupportsAvx2() {
+
+	static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return supported;
+}
+
+#endif // SOPNET_HAVE_AVX2_DISPATCH
+
+} // anonymous namespace
+
+LinearCostEvaluator::LinearCostEvaluator(const std::vector<double>& weights) :
+	_weights(weights) {}
+
+void
+LinearCostEvaluator::addCosts(
+		const double* features,
+		unsigned int  numRows,
+		unsigned int  stride,
+		double*       costs) const {
+
+	if (stride < _weights.size())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"row stride " << stride << " is smaller than the number of weights " << _weights.size());
+
+#ifdef SOPNET_HAVE_AVX2_DISPATCH
+	if (cpuSupportsAvx2()) {
+
+		addCostsAvx2(_weights.data(), _weights.size(), features, numRows, stride, costs);
+		return;
+	}
+#endif
+
+	addCostsScalar(_weights.data(), _weights.size(), features, numRows, stride, costs);
+}
+
+std::vector<double>
+LinearCostEvaluator::getCosts(const Features& features) const {
+
+	std::vector<double> costs(features.size(), 0.0);
+
+	if (features.size() == 0)
+		return costs;
+
+	if (features[0].size() != _weights.size())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"number of features " << features[0].size() << " does not match number of weights " << _weights.size());
+
+	addCosts(features.data(), features.size(), features.stride(), costs.data());
+
+	return costs;
+}
+
+bool
+LinearCostEvaluator::isVectorized() {
+
+#ifdef SOPNET_HAVE_AVX2_DISPATCH
+	return cpuSupportsAvx2();
+#else
+	return false;
+#endif
+}
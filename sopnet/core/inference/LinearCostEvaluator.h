@@ -0,0 +1,61 @@
+#ifndef SOPNET_INFERENCE_LINEAR_COST_EVALUATOR_H__
+#define SOPNET_INFERENCE_LINEAR_COST_EVALUATOR_H__
+
+#include <vector>
+
+#include <features/Features.h>
+
+/**
+ * Evaluates the linear costs (dot product of features and weights) for a
+ * whole matrix of segment features at once. Uses AVX2/FMA if the CPU supports
+ * it, and a scalar implementation otherwise.
+ */
+class LinearCostEvaluator {
+
+public:
+
+	LinearCostEvaluator(const std::vector<double>& weights);
+
+	/**
+	 * Compute the costs of numRows consecutive feature vectors.
+	 *
+	 * @param features
+	 *              Pointer to the first feature of the first row. Each row
+	 *              has as many features as there are weights.
+	 * @param numRows
+	 *              The number of rows to evaluate.
+	 * @param stride
+	 *              The distance between the beginnings of two rows in
+	 *              features.
+	 * @param costs
+	 *              Pointer to numRows values, the costs are added to them.
+	 */
+	void addCosts(
+			const double* features,
+			unsigned int  numRows,
+			unsigned int  stride,
+			double*       costs) const;
+
+	/**
+	 * Compute the costs of all rows in the given feature matrix. The cost of
+	 * a segment is found at the row index of the segment in features.
+	 */
+	std::vector<double> getCosts(const Features& features) const;
+
+	/**
+	 * The number of weights, i.e., the number of features expected per row.
+	 */
+	unsigned int size() const { return _weights.size(); }
+
+	/**
+	 * Check whether the vectorized implementation is used.
+	 */
+	static bool isVectorized();
+
+private:
+
+	std::vector<double> _weights;
+};
+
+#endif // SOPNET_INFERENCE_LINEAR_COST_EVALUATOR_H__
+
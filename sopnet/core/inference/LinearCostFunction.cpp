@@ -5,6 +5,7 @@
 #include <segments/EndSegment.h>
 #include <segments/ContinuationSegment.h>
 #include <segments/BranchSegment.h>
+#include "LinearCostEvaluator.h"
 #include "LinearCostFunction.h"
 
 static logger::LogChannel linearcostfunctionlog("linearcostfunctionlog", "[LinearCostFunction] ");
@@ -55,13 +56,15 @@ LinearCostFunction::costs(
 
 	_cache.resize(ends.size() + continuations.size() + branches.size());
 
-	const std::vector<double> weights = _parameters->getWeights();
+	// evaluate all feature vectors at once, and look up the cost of each 
+	// segment by its row
+	std::vector<double> rowCosts = LinearCostEvaluator(_parameters->getWeights()).getCosts(*_features);
 
 	unsigned int i = 0;
 
 	for (boost::shared_ptr<EndSegment> end : ends) {
 
-		double c = costs(*end, weights);
+		double c = rowCosts[_features->rowIndex(end->getId())];
 
 		segmentCosts[i] += c;
 		_cache[i] = c;
@@ -71,7 +74,7 @@ LinearCostFunction::costs(
 
 	for (boost::shared_ptr<ContinuationSegment> continuation : continuations) {
 
-		double c = costs(*continuation, weights);
+		double c = rowCosts[_features->rowIndex(continuation->getId())];
 
 		segmentCosts[i] += c;
 		_cache[i] = c;
@@ -81,7 +84,7 @@ LinearCostFunction::costs(
 
 	for (boost::shared_ptr<BranchSegment> branch : branches) {
 
-		double c = costs(*branch, weights);
+		double c = rowCosts[_features->rowIndex(branch->getId())];
 
 		segmentCosts[i] += c;
 		_cache[i] = c;
@@ -89,15 +92,3 @@ LinearCostFunction::costs(
 		i++;
 	}
 }
-
-double
-LinearCostFunction::costs(const Segment& segment, const std::vector<double>& weights) {
-
-	const std::vector<double>& features = _features->get(segment.getId());
-
-	double costs = 0;
-	for (unsigned int i = 0; i < features.size(); i++)
-		costs += features[i]*weights[i];
-
-	return costs;
-}
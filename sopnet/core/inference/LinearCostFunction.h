@@ -36,8 +36,6 @@ private:
 			const std::vector<boost::shared_ptr<BranchSegment> >&       branches,
 			std::vector<double>& costs);
 
-	double costs(const Segment& segment, const std::vector<double>& weights);
-
 	pipeline::Input<Features> _features;
 
 	pipeline::Input<LinearCostFunctionParameters> _parameters;
@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <limits>
+
+#include <boost/make_shared.hpp>
+
+#include <pipeline/Value.h>
+#include <segments/BranchSegment.h>
+#include <segments/ContinuationSegment.h>
+#include <segments/EndSegment.h>
+#include <threads/ThreadPool.h>
+#include <util/exceptions.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
+#include "GridSearch.h"
+#include "ParallelGridSearch.h"
+
+logger::LogChannel parallelgridsearchlog("parallelgridsearchlog", "[ParallelGridSearch] ");
+
+util::ProgramOption optionGridSearchThreads(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "gridSearchThreads",
+		util::_description_text = "The number of grid search lines to evaluate in parallel. Set to 0 to use all hardware threads.",
+		util::_default_value    = 0);
+
+util::ProgramOption optionGridSearchPruneMargin(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "gridSearchPruneMargin",
+		util::_description_text = "Skip the rest of a grid search line once its value got worse and exceeds the best value of the line "
+		                          "and of all earlier lines by this margin. This is a heuristic that assumes the values along a "
+		                          "line to have a single minimum, the best point can be missed otherwise. Set to a negative value "
+		                          "to evaluate all points.",
+		util::_default_value    = -1.0);
+
+// segment types, in the order of the objective
+static const char FreeEnd      = 0;
+static const char End          = 1;
+static const char Continuation = 2;
+static const char Branch       = 3;
+
+ParallelGridSearch::ParallelGridSearch() :
+	_priorCostFunctionParameters(new PriorCostFunctionParameters()),
+	_segmentationCostFunctionParameters(new SegmentationCostFunctionParameters()),
+	_solution(new Solution()),
+	_numThreads(optionGridSearchThreads.as<unsigned int>()),
+	_pruneMargin(optionGridSearchPruneMargin.as<double>()) {
+
+	registerInput(_segments, "segments");
+	registerInput(_linearConstraints, "linear constraints");
+	registerInputs(_costFunctions, "cost functions");
+	registerInput(_membranes, "membranes");
+	registerInput(_cropOffset, "crop offset", pipeline::Optional);
+
+	registerOutput(_priorCostFunctionParameters, "prior cost parameters");
+	registerOutput(_segmentationCostFunctionParameters, "segmentation cost parameters");
+	registerOutput(_solution, "solution");
+}
+
+void
+ParallelGridSearch::updateOutputs() {
+
+	if (!_evaluator)
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"no evaluator set for the grid search");
+
+	createGrid();
+	computeBaseCosts();
+
+	unsigned int numThreads = std::min(
+			ThreadPool::resolveNumThreads(_numThreads),
+			(unsigned int)_lines.size());
+	numThreads = std::max(numThreads, 1u);
+
+	LOG_USER(parallelgridsearchlog)
+			<< "evaluating " << _results.size() << " grid points in "
+			<< _lines.size() << " lines with " << numThreads << " threads"
+			<< std::endl;
+
+	// one solver per thread, their backends are reused along the lines
+	_solvers = std::vector<pipeline::Process<LinearSolver> >(numThreads);
+	_idleSolvers.clear();
+
+	for (unsigned int i = 0; i < numThreads; i++) {
+
+		_solvers[i]->setInput("linear constraints", _linearConstraints);
+		_solvers[i]->setInput("parameters", boost::make_shared<LinearSolverParameters>(Binary));
+		_idleSolvers.push_back(i);
+	}
+
+	_bestPoint = -1;
+	_bestValue = std::numeric_limits<double>::infinity();
+
+	_lineBest.assign(_lines.size(), std::numeric_limits<double>::infinity());
+	_lineFinished.assign(_lines.size(), false);
+
+	ThreadPool threadPool(numThreads);
+
+	for (unsigned int i = 0; i < _lines.size(); i++)
+		threadPool.schedule([this, i]() {
+
+			unsigned int solver = acquireSolver();
+
+			try {
+
+				evaluateLine(i, solver);
+
+			} catch (...) {
+
+				finishLine(i);
+				releaseSolver(solver);
+				throw;
+			}
+
+			finishLine(i);
+			releaseSolver(solver);
+		});
+
+	threadPool.wait();
+
+	_solvers.clear();
+	_baseCosts.clear();
+
+	if (_bestPoint < 0)
+		UTIL_THROW_EXCEPTION(
+				Exception,
+				"no grid point was evaluated");
+
+	*_priorCostFunctionParameters        = _results[_bestPoint].priorParameters;
+	*_segmentationCostFunctionParameters = _results[_bestPoint].segmentationParameters;
+
+	unsigned int numPruned = 0;
+	for (const Result& result : _results)
+		if (result.pruned)
+			numPruned++;
+
+	LOG_USER(parallelgridsearchlog)
+			<< "best value " << _bestValue << " at point " << _bestPoint
+			<< ", pruned " << numPruned << " of " << _results.size()
+			<< " points" << std::endl;
+}
+
+void
+ParallelGridSearch::createGrid() {
+
+	_results.clear();
+	_lines.clear();
+
+	// the segmentation parameters of each set of base costs
+	std::vector<SegmentationCostFunctionParameters> segmentationSettings;
+
+	pipeline::Process<GridSearch> gridSearch;
+
+	do {
+
+		Result result;
+		result.priorParameters        = gridSearch->getPriorCostFunctionParameters();
+		result.segmentationParameters = gridSearch->getSegmentationCostFunctionParameters();
+		result.value                  = std::numeric_limits<double>::infinity();
+		result.pruned                 = false;
+
+		const PriorCostFunctionParameters&        priors       = result.priorParameters;
+		const SegmentationCostFunctionParameters& segmentation = result.segmentationParameters;
+
+		// GridSearch increases the end prior first, a line ends whenever any
+		// other parameter changes
+		bool newLine = _results.empty();
+
+		if (!newLine) {
+
+			const Result& previous = _results.back();
+
+			newLine =
+					priors.priorContinuation     != previous.priorParameters.priorContinuation ||
+					priors.priorBranch           != previous.priorParameters.priorBranch ||
+					segmentation.weightPotts     != previous.segmentationParameters.weightPotts ||
+					segmentation.priorForeground != previous.segmentationParameters.priorForeground;
+		}
+
+		if (newLine) {
+
+			Line line;
+			line.begin = _results.size();
+
+			// reuse the base costs of equal segmentation parameters
+			line.segmentationCosts = segmentationSettings.size();
+			for (unsigned int i = 0; i < segmentationSettings.size(); i++)
+				if (segmentationSettings[i].weight          == segmentation.weight &&
+				    segmentationSettings[i].weightPotts     == segmentation.weightPotts &&
+				    segmentationSettings[i].priorForeground == segmentation.priorForeground)
+					line.segmentationCosts = i;
+
+			if (line.segmentationCosts == segmentationSettings.size())
+				segmentationSettings.push_back(segmentation);
+
+			_lines.push_back(line);
+		}
+
+		_results.push_back(result);
+		_lines.back().end = _results.size();
+
+	} while (gridSearch->next());
+
+	_baseCosts.assign(segmentationSettings.size(), std::vector<double>());
+}
+
+void
+ParallelGridSearch::computeBaseCosts() {
+
+	std::vector<boost::shared_ptr<EndSegment> >          ends          = _segments->getEnds();
+	std::vector<boost::shared_ptr<ContinuationSegment> > continuations = _segments->getContinuations();
+	std::vector<boost::shared_ptr<BranchSegment> >       branches      = _segments->getBranches();
+
+	unsigned int numSegments              = _segments->size();
+	unsigned int numInterSectionIntervals = _segments->getNumInterSectionIntervals();
+
+	// end segments at the beginning and end of the stack come for free, as in
+	// ObjectiveGenerator
+	_segmentTypes.clear();
+	_segmentTypes.reserve(numSegments);
+
+	for (boost::shared_ptr<EndSegment> end : ends)
+		_segmentTypes.push_back(
+				end->getInterSectionInterval() == 0 ||
+				end->getInterSectionInterval() == numInterSectionIntervals - 1 ?
+				FreeEnd : End);
+	_segmentTypes.resize(ends.size() + continuations.size(), Continuation);
+	_segmentTypes.resize(numSegments, Branch);
+
+	// the costs of the grid-independent cost functions are shared by all
+	// settings
+	std::vector<double> costs(numSegments, 0);
+
+	for (unsigned int i = 0; i < _costFunctions.size(); i++) {
+
+		costs_function_type& costFunction = *_costFunctions[i];
+		costFunction(ends, continuations, branches, costs);
+	}
+
+	_segmentationCostFunction->setInput("membranes", _membranes);
+	if (_cropOffset.isSet())
+		_segmentationCostFunction->setInput("crop offset", _cropOffset);
+
+	std::vector<bool> computed(_baseCosts.size(), false);
+
+	for (const Line& line : _lines) {
+
+		// computed already for an earlier line
+		if (computed[line.segmentationCosts])
+			continue;
+
+		computed[line.segmentationCosts] = true;
+
+		std::vector<double>& baseCosts = _baseCosts[line.segmentationCosts];
+		baseCosts = costs;
+
+		_segmentationCostFunction->setInput(
+				"parameters",
+				boost::make_shared<SegmentationCostFunctionParameters>(_results[line.begin].segmentationParameters));
+
+		pipeline::Value<costs_function_type> segmentationCostFunction = _segmentationCostFunction->getOutput("cost function");
+		(*segmentationCostFunction)(ends, continuations, branches, baseCosts);
+
+		for (unsigned int i = 0; i < numSegments; i++)
+			if (_segmentTypes[i] == FreeEnd)
+				baseCosts[i] = 0;
+	}
+
+	LOG_DEBUG(parallelgridsearchlog)
+			<< "computed base costs of " << numSegments << " segments for "
+			<< _baseCosts.size() << " segmentation settings" << std::endl;
+}
+
+void
+ParallelGridSearch::evaluateLine(unsigned int lineIndex, unsigned int solver) {
+
+	const Line& line = _lines[lineIndex];
+
+	double previousValue = std::numeric_limits<double>::infinity();
+
+	for (unsigned int point = line.begin; point < line.end; point++) {
+
+		Result& result = _results[point];
+
+		// setting a new objective marks the solver dirty, the backend is kept
+		_solvers[solver]->setInput(
+				"objective",
+				createObjective(_baseCosts[line.segmentationCosts], result.priorParameters));
+
+		pipeline::Value<Solution> solution = _solvers[solver]->getOutput("solution");
+
+		double value = _evaluator(*solution);
+
+		LOG_DEBUG(parallelgridsearchlog)
+				<< "point " << point << " (end " << result.priorParameters.priorEnd
+				<< ", continuation " << result.priorParameters.priorContinuation
+				<< ", branch " << result.priorParameters.priorBranch
+				<< ", potts " << result.segmentationParameters.weightPotts
+				<< ", foreground " << result.segmentationParameters.priorForeground
+				<< ") has value " << value << std::endl;
+
+		bool prune = false;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			result.value = value;
+
+			if (value < _bestValue || (value == _bestValue && (int)point < _bestPoint)) {
+
+				_bestValue = value;
+				_bestPoint = point;
+				*_solution = *solution;
+			}
+
+			_lineBest[lineIndex] = std::min(_lineBest[lineIndex], value);
+
+			if (_pruneMargin >= 0 && value > previousValue)
+				prune = exceedsReference(lineIndex, value, lock);
+		}
+
+		if (prune) {
+
+			for (unsigned int pruned = point + 1; pruned < line.end; pruned++)
+				_results[pruned].pruned = true;
+
+			LOG_DEBUG(parallelgridsearchlog)
+					<< "pruned " << (line.end - point - 1) << " points after point "
+					<< point << std::endl;
+
+			return;
+		}
+
+		previousValue = value;
+	}
+}
+
+bool
+ParallelGridSearch::exceedsReference(
+		unsigned int                  lineIndex,
+		double                        value,
+		std::unique_lock<std::mutex>& lock) {
+
+	// The reference is the best value of this line so far and of all earlier
+	// lines once they are finished. The best value of the earlier lines can
+	// only decrease while they are evaluated, so exceeding it already now is
+	// final. Otherwise, wait for the earlier lines to finish. They were
+	// scheduled before this one and are running or done, such that this
+	// can't deadlock.
+	while (true) {
+
+		double reference       = _lineBest[lineIndex];
+		bool   earlierFinished = true;
+
+		for (unsigned int i = 0; i < lineIndex; i++) {
+
+			reference       = std::min(reference, _lineBest[i]);
+			earlierFinished = earlierFinished && _lineFinished[i];
+		}
+
+		if (value > reference + _pruneMargin)
+			return true;
+
+		if (earlierFinished)
+			return false;
+
+		_lineFinishedCondition.wait(lock);
+	}
+}
+
+void
+ParallelGridSearch::finishLine(unsigned int lineIndex) {
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_lineFinished[lineIndex] = true;
+	}
+
+	_lineFinishedCondition.notify_all();
+}
+
+boost::shared_ptr<LinearObjective>
+ParallelGridSearch::createObjective(
+		const std::vector<double>&         baseCosts,
+		const PriorCostFunctionParameters& priors) {
+
+	boost::shared_ptr<LinearObjective> objective = boost::make_shared<LinearObjective>(baseCosts.size());
+
+	for (unsigned int i = 0; i < baseCosts.size(); i++) {
+
+		double prior = 0;
+
+		switch (_segmentTypes[i]) {
+
+			case End:
+				prior = priors.priorEnd;
+				break;
+
+			case Continuation:
+				prior = priors.priorContinuation;
+				break;
+
+			case Branch:
+				prior = priors.priorBranch;
+				break;
+		}
+
+		objective->setCoefficient(i, baseCosts[i] + prior);
+	}
+
+	return objective;
+}
+
+unsigned int
+ParallelGridSearch::acquireSolver() {
+
+	// there are as many solvers as threads, one is always idle here
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	unsigned int solver = _idleSolvers.back();
+	_idleSolvers.pop_back();
+
+	return solver;
+}
+
+void
+ParallelGridSearch::releaseSolver(unsigned int solver) {
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_idleSolvers.push_back(solver);
+}
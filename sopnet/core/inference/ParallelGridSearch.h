@@ -0,0 +1,192 @@
+#ifndef SOPNET_INFERENCE_PARALLEL_GRID_SEARCH_H__
+#define SOPNET_INFERENCE_PARALLEL_GRID_SEARCH_H__
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <imageprocessing/ImageStack.h>
+#include <pipeline/all.h>
+#include <pipeline/Process.h>
+#include <segments/Segments.h>
+#include <solvers/LinearConstraints.h>
+#include <solvers/LinearSolver.h>
+#include <solvers/Solution.h>
+#include <util/point.hpp>
+#include "PriorCostFunctionParameters.h"
+#include "SegmentationCostFunction.h"
+#include "SegmentationCostFunctionParameters.h"
+
+/**
+ * Evaluates all points of the grid of GridSearch in parallel. For each point,
+ * the objective is assembled as ObjectiveGenerator would do from the input
+ * "cost functions" (which must not depend on the grid), a
+ * SegmentationCostFunction on the input "membranes", and the priors of the
+ * point. The problem is solved under the shared input "linear constraints",
+ * and the solution is scored with the evaluator (lower is better).
+ *
+ * The grid-independent costs and the segmentation costs of each setting of
+ * the segmentation parameters are computed once, such that the workers only
+ * add the priors and solve. The points that differ only in the end prior form
+ * a line, which is evaluated by one worker in increasing order of the prior.
+ *
+ * With a non-negative prune margin, the remaining points of a line are
+ * skipped as soon as the value got worse along the line and exceeds the best
+ * value of the line and of all earlier lines of the grid by more than the
+ * margin. Lines wait for the earlier lines where needed, such that the pruned
+ * points and the result do not depend on the number of threads or the order
+ * in which the lines finish. Pruning is a heuristic: it assumes that the
+ * values along a line have a single minimum and can miss the best point
+ * otherwise.
+ *
+ * The outputs are the parameters and the solution of the best point, ties are
+ * broken in favour of the earlier point of the grid.
+ */
+class ParallelGridSearch : public pipeline::SimpleProcessNode<> {
+
+	typedef boost::function<
+			void
+			(const std::vector<boost::shared_ptr<EndSegment> >&          ends,
+			 const std::vector<boost::shared_ptr<ContinuationSegment> >& continuations,
+			 const std::vector<boost::shared_ptr<BranchSegment> >&       branches,
+			 std::vector<double>& costs)>
+			costs_function_type;
+
+public:
+
+	/**
+	 * Scores the solution of a grid point, lower is better. Called
+	 * concurrently from several threads.
+	 */
+	typedef std::function<double(const Solution&)> Evaluator;
+
+	/**
+	 * The evaluation of one point of the grid.
+	 */
+	struct Result {
+
+		PriorCostFunctionParameters        priorParameters;
+		SegmentationCostFunctionParameters segmentationParameters;
+
+		// the value of the evaluator, infinity for pruned points
+		double value;
+
+		bool pruned;
+	};
+
+	ParallelGridSearch();
+
+	/**
+	 * Set the evaluator to score the solutions. Has to be set before the
+	 * outputs are requested.
+	 */
+	void setEvaluator(Evaluator evaluator) { _evaluator = evaluator; }
+
+	/**
+	 * Set the number of grid lines to evaluate in parallel. 0 uses all
+	 * hardware threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * Set the margin by which a point has to be worse than the best point of
+	 * its line and the earlier lines to prune the rest of its line. Negative
+	 * values disable pruning.
+	 */
+	void setPruneMargin(double pruneMargin) { _pruneMargin = pruneMargin; }
+
+	/**
+	 * Get the evaluation of each point of the last search, in grid order.
+	 */
+	const std::vector<Result>& getResults() const { return _results; }
+
+private:
+
+	// consecutive points of the grid that differ only in the end prior
+	struct Line {
+
+		unsigned int begin;
+		unsigned int end;
+
+		// the segmentation costs to use for this line
+		unsigned int segmentationCosts;
+	};
+
+	void updateOutputs();
+
+	// enumerate the grid points and group them into lines
+	void createGrid();
+
+	// compute the costs that don't depend on the priors for each setting of
+	// the segmentation parameters
+	void computeBaseCosts();
+
+	// evaluate the points of a line with the solver of the given slot
+	void evaluateLine(unsigned int lineIndex, unsigned int solver);
+
+	// check whether a value of a line exceeds the prune reference, waits for
+	// earlier lines if needed, the lock has to hold _mutex
+	bool exceedsReference(
+			unsigned int                  lineIndex,
+			double                        value,
+			std::unique_lock<std::mutex>& lock);
+
+	// mark a line as finished and wake up the lines waiting for it
+	void finishLine(unsigned int lineIndex);
+
+	// assemble the objective of a grid point
+	boost::shared_ptr<LinearObjective> createObjective(
+			const std::vector<double>&         baseCosts,
+			const PriorCostFunctionParameters& priors);
+
+	// get the index of an idle solver
+	unsigned int acquireSolver();
+
+	void releaseSolver(unsigned int solver);
+
+	pipeline::Input<Segments>                        _segments;
+	pipeline::Input<LinearConstraints>               _linearConstraints;
+	pipeline::Inputs<costs_function_type>            _costFunctions;
+	pipeline::Input<ImageStack<IntensityImage> >     _membranes;
+	pipeline::Input<util::point<unsigned int, 3> >   _cropOffset;
+
+	pipeline::Output<PriorCostFunctionParameters>        _priorCostFunctionParameters;
+	pipeline::Output<SegmentationCostFunctionParameters> _segmentationCostFunctionParameters;
+	pipeline::Output<Solution>                           _solution;
+
+	pipeline::Process<SegmentationCostFunction> _segmentationCostFunction;
+
+	std::vector<Result> _results;
+	std::vector<Line>   _lines;
+
+	// the costs without the priors, one vector per setting of the
+	// segmentation parameters
+	std::vector<std::vector<double> > _baseCosts;
+
+	// the type of each segment, in the order of the objective
+	std::vector<char> _segmentTypes;
+
+	std::vector<pipeline::Process<LinearSolver> > _solvers;
+	std::vector<unsigned int>                     _idleSolvers;
+
+	// the best point so far, guarded by _mutex
+	int    _bestPoint;
+	double _bestValue;
+
+	// the best value so far and whether it is finished for each line,
+	// guarded by _mutex
+	std::vector<double> _lineBest;
+	std::vector<bool>   _lineFinished;
+
+	std::mutex              _mutex;
+	std::condition_variable _lineFinishedCondition;
+
+	Evaluator _evaluator;
+
+	unsigned int _numThreads;
+	double       _pruneMargin;
+};
+
+#endif // SOPNET_INFERENCE_PARALLEL_GRID_SEARCH_H__
+
@@ -39,6 +39,12 @@ public:
 	 */
 	unsigned int getInterSectionInterval(unsigned int variable) { return _interSectionIntervals[variable]; }
 
+	/**
+	 * Check whether the inter-section interval of a variable is known, i.e., 
+	 * whether it was set with a segment.
+	 */
+	bool hasInterSectionInterval(unsigned int variable) const { return _interSectionIntervals.count(variable) > 0; }
+
 	unsigned int getMinInterSectionInterval() { return _minInterSectionInterval; }
 	unsigned int getMaxInterSectionInterval() { return _maxInterSectionInterval; }
 	unsigned int getMinX() { return _minX; }
@@ -253,7 +253,7 @@ ProblemGraphWriter::writeSegment(const Segment& segment, std::ofstream& out, int
 	out << " " << _randomForestCostMap[ segment.getId() ];
     out << " " << segment.getDirection() << " ";
 
-	const std::vector<double>&      features = _features->get(segment.getId());
+	Features::const_row_type        features = _features->get(segment.getId());
 	// const std::vector<std::string>& names    = _features->getNames();
 
 	for (unsigned int i = 0; i < features.size(); i++) {
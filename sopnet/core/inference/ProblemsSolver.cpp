@@ -1,17 +1,51 @@
+#include <algorithm>
+
 #include <pipeline/Value.h>
 #include <solvers/LinearSolver.h>
+#include <threads/ThreadPool.h>
+#include <util/Logger.h>
+#include <util/ProgramOptions.h>
 #include "ProblemsSolver.h"
 
+logger::LogChannel problemssolverlog("problemssolverlog", "[ProblemsSolver] ");
+
+util::ProgramOption optionProblemsSolverThreads(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "problemsSolverThreads",
+		util::_description_text = "The number of subproblems to solve in parallel. Set to 0 to use all hardware threads.",
+		util::_default_value    = 1);
+
 ProblemsSolver::ProblemsSolver() :
-	_solutions(new Solutions()) {
+	_solutions(new Solutions()),
+	_solution(new Solution()),
+	_numThreads(optionProblemsSolverThreads.as<unsigned int>()),
+	_numDisagreements(0) {
 
 	registerInput(_problems, "problems");
+	registerInput(_configuration, "problem configuration", pipeline::Optional);
 	registerOutput(_solutions, "solutions");
+	registerOutput(_solution, "solution");
 }
 
 void
 ProblemsSolver::updateOutputs() {
 
+	unsigned int numThreads = std::min(
+			ThreadPool::resolveNumThreads(_numThreads),
+			_problems->size());
+
+	if (numThreads > 1)
+		solveParallel(numThreads);
+	else
+		solveSequentially();
+
+	if (_configuration.isSet())
+		mergeSolutions();
+}
+
+void
+ProblemsSolver::solveSequentially() {
+
 	// create internal pipeline
 
 	_solutionAssembler->clearInputs("solutions");
@@ -34,6 +68,119 @@ ProblemsSolver::updateOutputs() {
 	*_solutions = *solutions;
 }
 
+void
+ProblemsSolver::solveParallel(unsigned int numThreads) {
+
+	LOG_DEBUG(problemssolverlog)
+			<< "solving " << _problems->size() << " problems with "
+			<< numThreads << " threads" << std::endl;
+
+	// set up the solvers here, the workers only pull their outputs
+	std::vector<pipeline::Process<LinearSolver> > solvers(_problems->size());
+
+	for (unsigned int i = 0; i < _problems->size(); i++) {
+
+		boost::shared_ptr<Problem> problem = _problems->getProblem(i);
+
+		solvers[i]->setInput("objective", problem->getObjective());
+		solvers[i]->setInput("linear constraints", problem->getLinearConstraints());
+		solvers[i]->setInput("parameters", boost::make_shared<LinearSolverParameters>(Binary));
+	}
+
+	// the solutions are kept in the order of the problems
+	std::vector<boost::shared_ptr<Solution> > solutions(_problems->size());
+
+	ThreadPool threadPool(numThreads);
+
+	// largest problems first, to not wait for a big one at the end
+	std::vector<unsigned int> order(_problems->size());
+	for (unsigned int i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+
+		return _problems->getProblem(a)->getObjective()->size() > _problems->getProblem(b)->getObjective()->size();
+	});
+
+	for (unsigned int i : order)
+		threadPool.schedule([i, &solvers, &solutions]() {
+
+			pipeline::Value<Solution> solution = solvers[i]->getOutput("solution");
+			solutions[i] = boost::make_shared<Solution>(*solution);
+		});
+
+	threadPool.wait();
+
+	_solutions->clear();
+
+	for (boost::shared_ptr<Solution> solution : solutions)
+		_solutions->addSolution(solution);
+}
+
+void
+ProblemsSolver::mergeSolutions() {
+
+	std::set<unsigned int> variables = _configuration->getVariables();
+
+	unsigned int numVariables = (variables.empty() ? 0 : *variables.rbegin() + 1);
+
+	*_solution = Solution(numVariables);
+
+	// the depth of the owning problem of each variable so far, -1 if none
+	std::vector<int>  ownerDepths(numVariables, -1);
+	std::vector<bool> disagreements(numVariables, false);
+
+	// the result does not depend on the order in which the problems were 
+	// solved
+	for (unsigned int i = 0; i < _problems->size(); i++) {
+
+		boost::shared_ptr<ProblemConfiguration> configuration = _problems->getProblem(i)->getConfiguration();
+		boost::shared_ptr<Solution>             solution      = _solutions->getSolution(i);
+
+		for (unsigned int var : configuration->getVariables()) {
+
+			unsigned int globalVar = _configuration->getVariable(configuration->getSegmentId(var));
+
+			double value = (*solution)[var];
+			int    depth = getDepth(*configuration, var);
+
+			if (ownerDepths[globalVar] >= 0 && (*_solution)[globalVar] != value)
+				disagreements[globalVar] = true;
+
+			// earlier problems win ties
+			if (depth > ownerDepths[globalVar]) {
+
+				(*_solution)[globalVar] = value;
+				ownerDepths[globalVar]  = depth;
+			}
+		}
+	}
+
+	_numDisagreements = std::count(disagreements.begin(), disagreements.end(), true);
+
+	if (_numDisagreements > 0)
+		LOG_USER(problemssolverlog)
+				<< "the problems disagree on " << _numDisagreements << " variables, "
+				<< "took them from the problems that own them" << std::endl;
+
+	LOG_DEBUG(problemssolverlog)
+			<< "merged " << _problems->size() << " solutions into a solution with "
+			<< numVariables << " variables" << std::endl;
+}
+
+unsigned int
+ProblemsSolver::getDepth(ProblemConfiguration& configuration, unsigned int var) {
+
+	if (!configuration.hasInterSectionInterval(var))
+		return 0;
+
+	unsigned int interSectionInterval = configuration.getInterSectionInterval(var);
+
+	return std::min(
+			interSectionInterval - configuration.getMinInterSectionInterval(),
+			configuration.getMaxInterSectionInterval() - interSectionInterval);
+}
+
 ProblemsSolver::SolutionsAssembler::SolutionsAssembler() {
 
 	registerInputs(_singleSolutions, "solutions");
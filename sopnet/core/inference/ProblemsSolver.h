@@ -4,15 +4,41 @@
 #include <pipeline/all.h>
 #include <pipeline/Process.h>
 #include <solvers/Solution.h>
+#include "ProblemConfiguration.h"
 #include "Problems.h"
 #include "Solutions.h"
 
+/**
+ * Solves each of a set of independent problems. If the optional input 
+ * "problem configuration" is set, the solutions of the problems are merged 
+ * into a single solution of the problem described by this configuration, 
+ * available as output "solution".
+ *
+ * A variable that is part of several (overlapping) problems is taken from the 
+ * problem that owns it: the one in which its inter-section interval is the 
+ * farthest from the boundary of the problem, i.e., the one in whose core and 
+ * not in whose overlap region it lies. Ties, and variables without a known 
+ * inter-section interval, go to the earlier problem. Variables on which the 
+ * problems disagree are counted and reported.
+ */
 class ProblemsSolver : public pipeline::SimpleProcessNode<> {
 
 public:
 
 	ProblemsSolver();
 
+	/**
+	 * Set the number of problems to solve in parallel. 0 uses all hardware 
+	 * threads. The solutions do not depend on the number of threads.
+	 */
+	void setNumThreads(unsigned int numThreads) { _numThreads = numThreads; }
+
+	/**
+	 * Get the number of variables of the last merged solution on which the 
+	 * problems that contain them disagree.
+	 */
+	unsigned int getNumDisagreements() const { return _numDisagreements; }
+
 private:
 
 	class SolutionsAssembler : public pipeline::SimpleProcessNode<> {
@@ -31,10 +57,30 @@ private:
 
 	void updateOutputs();
 
-	pipeline::Input<Problems>   _problems;
-	pipeline::Output<Solutions> _solutions;
+	// solve the problems one after the other through an internal pipeline
+	void solveSequentially();
+
+	// solve the problems on a thread pool
+	void solveParallel(unsigned int numThreads);
+
+	// merge the solutions of the problems into a solution of the problem 
+	// described by _configuration
+	void mergeSolutions();
+
+	// the distance of a variable's inter-section interval to the closest 
+	// boundary of its problem, 0 if unknown
+	static unsigned int getDepth(ProblemConfiguration& configuration, unsigned int var);
+
+	pipeline::Input<Problems>             _problems;
+	pipeline::Input<ProblemConfiguration> _configuration;
+	pipeline::Output<Solutions>           _solutions;
+	pipeline::Output<Solution>            _solution;
 
 	pipeline::Process<SolutionsAssembler> _solutionAssembler;
+
+	unsigned int _numThreads;
+
+	unsigned int _numDisagreements;
 };
 
 #endif // SOPNET_INFERENCE_PROBLEMS_SOLVER_H__
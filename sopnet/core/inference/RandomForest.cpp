@@ -2,6 +2,8 @@
 #include "RandomForest.h"
 
 RandomForest::RandomForest() :
+	_numFeatures(0),
+	_numClasses(0),
 	_outOfBagError(0),
 	_variableImportance(0) {
 
@@ -70,6 +72,8 @@ RandomForest::train(int numTrees, int numFeatures) {
 		_variableImportance[i] = variableVisitor.variable_importance_(i);
 
 	_numClasses = _rf.class_count();
+
+	_compiled.compile(_rf);
 }
 
 double
@@ -114,6 +118,17 @@ RandomForest::getProbabilities(const std::vector<FeatureType>& sample) {
 	return p;
 }
 
+void
+RandomForest::getProbabilities(
+		const FeatureType* samples,
+		unsigned int       numSamples,
+		unsigned int       stride,
+		double*            probabilities,
+		ThreadPool*        threadPool) const {
+
+	_compiled.getProbabilities(samples, numSamples, stride, probabilities, threadPool);
+}
+
 void
 RandomForest::write(std::string filename) {
 
@@ -143,5 +158,8 @@ RandomForest::read(std::string filename) {
 
 	_numFeatures = _rf.feature_count();
 	_numClasses  = _rf.class_count();
+
+	if (_rf.tree_count() > 0)
+		_compiled.compile(_rf);
 }
 
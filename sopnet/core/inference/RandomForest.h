@@ -7,6 +7,8 @@
 #include <vigra/random_forest.hxx>
 
 #include <pipeline/all.h>
+#include <threads/ThreadPool.h>
+#include "CompiledRandomForest.h"
 
 class RandomForest : public pipeline::Data {
 
@@ -64,6 +66,27 @@ public:
 	 */
 	std::vector<double> getProbabilities(const std::vector<FeatureType>& sample);
 
+	/**
+	 * Get the class probability distributions for a batch of samples, using a 
+	 * flattened copy of the trees. See CompiledRandomForest::getProbabilities().
+	 */
+	void getProbabilities(
+			const FeatureType* samples,
+			unsigned int       numSamples,
+			unsigned int       stride,
+			double*            probabilities,
+			ThreadPool*        threadPool = 0) const;
+
+	/**
+	 * The number of classes, i.e., the number of probabilities per sample.
+	 */
+	unsigned int getNumClasses() const { return _numClasses; }
+
+	/**
+	 * The number of features per sample.
+	 */
+	unsigned int getNumFeatures() const { return _numFeatures; }
+
 	/**
 	 * Write the classifier to a file.
 	 */
@@ -80,6 +103,9 @@ private:
 
 	RandomForestType _rf;
 
+	// flattened copy of _rf for batch prediction
+	CompiledRandomForest _compiled;
+
 	// training data
 
 	SamplesType _samples;
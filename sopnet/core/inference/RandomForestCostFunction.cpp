@@ -1,6 +1,9 @@
 #include <limits>
 
+#include <boost/make_shared.hpp>
+
 #include <util/Logger.h>
+#include <exceptions.h>
 #include <util/point.hpp>
 #include <imageprocessing/ConnectedComponent.h>
 #include <segments/EndSegment.h>
@@ -16,6 +19,12 @@ util::ProgramOption optionMinSegmentProbability(
 		util::_description_text = "The minimal probability a segments needs to have (according to the RF-classifier) to accept it.",
 		util::_default_value    = "0.05");
 
+util::ProgramOption optionRandomForestThreads(
+		util::_module           = "sopnet.inference",
+		util::_long_name        = "randomForestThreads",
+		util::_description_text = "The number of threads to use for the random forest prediction. Set to 0 to use all hardware threads.",
+		util::_default_value    = 1);
+
 util::ProgramOption optionUseOverlapOnly(
 		util::_module           = "sopnet.inference",
 		util::_long_name        = "useOverlapOnly",
@@ -27,6 +36,9 @@ RandomForestCostFunction::RandomForestCostFunction() :
 	_useOverlapOnly(optionUseOverlapOnly),
 	_overlapFeature(-1) {
 
+	if (ThreadPool::resolveNumThreads(optionRandomForestThreads.as<unsigned int>()) > 1)
+		_threadPool = boost::make_shared<ThreadPool>(optionRandomForestThreads.as<unsigned int>());
+
 	registerInput(_features, "features");
 	registerInput(_randomForest, "random forest");
 	registerOutput(_costFunction, "cost function");
@@ -72,54 +84,112 @@ RandomForestCostFunction::costs(
 
 	_cache.resize(ends.size() + continuations.size() + branches.size());
 
-	unsigned int i = 0;
+	// the rows of the requested segments, the feature matrix might hold more
+	std::vector<unsigned int> rows;
+	rows.reserve(_cache.size());
 
-	for (boost::shared_ptr<EndSegment> end : ends) {
+	for (boost::shared_ptr<EndSegment> end : ends)
+		rows.push_back(_features->rowIndex(end->getId()));
+	for (boost::shared_ptr<ContinuationSegment> continuation : continuations)
+		rows.push_back(_features->rowIndex(continuation->getId()));
+	for (boost::shared_ptr<BranchSegment> branch : branches)
+		rows.push_back(_features->rowIndex(branch->getId()));
 
-		double c = costs(*end);
+	// the costs of all requested rows, computed at once
+	std::vector<double> rowCosts = computeCosts(rows);
+
+	for (unsigned int i = 0; i < rowCosts.size(); i++) {
+
+		double c = rowCosts[i];
+
+		// ends are never discarded
+		if (i >= ends.size() && c >= _maxSegmentCosts)
+			c = std::numeric_limits<double>::infinity();
 
 		segmentCosts[i] += c;
 		_cache[i] = c;
-
-		i++;
 	}
+}
 
-	for (boost::shared_ptr<ContinuationSegment> continuation : continuations) {
+std::vector<double>
+RandomForestCostFunction::computeCosts(const std::vector<unsigned int>& rows) {
 
-		double c = costs(*continuation);
+	const unsigned int numRows = rows.size();
 
-		if (c >= _maxSegmentCosts)
-			c = std::numeric_limits<double>::infinity();
+	std::vector<double> rowCosts(numRows, 0.0);
 
-		segmentCosts[i] += c;
-		_cache[i] = c;
+	if (numRows == 0)
+		return rowCosts;
+
+	if (_useOverlapOnly) {
+
+		if (_overlapFeature >= 0)
+			for (unsigned int i = 0; i < numRows; i++)
+				rowCosts[i] = -(*_features)[rows[i]][_overlapFeature];
 
-		i++;
+		return rowCosts;
 	}
 
-	for (boost::shared_ptr<BranchSegment> branch : branches) {
+	const unsigned int numFeatures = (*_features)[rows[0]].size();
 
-		double c = costs(*branch);
+	if (numFeatures != _randomForest->getNumFeatures())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"number of features " << numFeatures << " does not match the "
+				<< _randomForest->getNumFeatures() << " features of the random forest");
 
-		if (c >= _maxSegmentCosts)
-			c = std::numeric_limits<double>::infinity();
+	// the random forest uses all features, none of them may have been skipped
+	for (unsigned int row : rows)
+		for (double feature : (*_features)[row])
+			if (feature == Features::SkippedFeatureValue)
+				UTIL_THROW_EXCEPTION(
+						UsageError,
+						"segment features were extracted with skipped feature groups, "
+						"they can not be used with a random forest");
 
-		segmentCosts[i] += c;
-		_cache[i] = c;
+	// predict in place if the rows are consecutive, copy them otherwise
+	bool consecutive = true;
+	for (unsigned int i = 1; i < numRows && consecutive; i++)
+		consecutive = (rows[i] == rows[0] + i);
+
+	const double*       samples;
+	unsigned int        stride;
+	std::vector<double> copy;
+
+	if (consecutive) {
+
+		samples = _features->data() + static_cast<size_t>(rows[0])*_features->stride();
+		stride  = _features->stride();
+
+	} else {
 
-		i++;
+		copy.reserve(static_cast<size_t>(numRows)*numFeatures);
+		for (unsigned int row : rows)
+			for (double feature : (*_features)[row])
+				copy.push_back(feature);
+
+		samples = copy.data();
+		stride  = numFeatures;
 	}
-}
 
-double
-RandomForestCostFunction::costs(const Segment& segment) {
+	const unsigned int numClasses = _randomForest->getNumClasses();
 
-	if (_useOverlapOnly)
-		return -_features->get(segment.getId())[_overlapFeature];
+	std::vector<double> probabilities(numRows*numClasses);
 
-	double prob = _randomForest->getProbabilities(_features->get(segment.getId()))[1];
+	_randomForest->getProbabilities(
+			samples,
+			numRows,
+			stride,
+			probabilities.data(),
+			_threadPool.get());
 
-	//[23.02, 0.0]
-	return -log(std::max(1e-10, prob));
-}
+	for (unsigned int i = 0; i < numRows; i++) {
+
+		double prob = probabilities[i*numClasses + 1];
 
+		//[23.02, 0.0]
+		rowCosts[i] = -log(std::max(1e-10, prob));
+	}
+
+	return rowCosts;
+}
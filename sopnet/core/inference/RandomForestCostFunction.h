@@ -5,6 +5,7 @@
 #include <inference/RandomForest.h>
 #include <features/Features.h>
 #include <segments/Segment.h>
+#include <threads/ThreadPool.h>
 
 class RandomForestCostFunction : public pipeline::SimpleProcessNode<> {
 
@@ -30,7 +31,8 @@ private:
 			const std::vector<boost::shared_ptr<BranchSegment> >&       branches,
 			std::vector<double>& costs);
 
-	double costs(const Segment& segment);
+	// get the costs for the given rows of the feature matrix
+	std::vector<double> computeCosts(const std::vector<unsigned int>& rows);
 
 	pipeline::Input<Features> _features;
 
@@ -46,6 +48,9 @@ private:
 	bool _useOverlapOnly;
 
 	int _overlapFeature;
+
+	// used for the prediction, if more than one thread was requested
+	boost::shared_ptr<ThreadPool> _threadPool;
 };
 
 #endif // SOPNET_SEGMENT_RANDOM_FOREST_EVALUATOR_H__
@@ -52,6 +52,16 @@ public:
 	 */
 	std::set<unsigned int>& getConstraintSubproblems(unsigned int constraint) { return _constraintsToSubproblems[constraint]; }
 
+	/**
+	 * Get the subproblems of all assigned variables.
+	 */
+	const std::map<unsigned int, std::set<unsigned int> >& getVariablesSubproblems() const { return _variablesToSubproblems; }
+
+	/**
+	 * Get the subproblems of all assigned constraints.
+	 */
+	const std::map<unsigned int, std::set<unsigned int> >& getConstraintsSubproblems() const { return _constraintsToSubproblems; }
+
 	/**
 	 * Reset the decomposition.
 	 */
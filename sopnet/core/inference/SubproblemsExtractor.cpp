@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
 #include <util/ProgramOptions.h>
 #include <util/Logger.h>
+#include "io/SubproblemsWriter.h"
 #include "SubproblemsExtractor.h"
 
 util::ProgramOption optionSubproblemsSize(
@@ -15,7 +20,10 @@ util::ProgramOption optionSubproblemsOverlap(
 logger::LogChannel subproblemsextractorlog("subproblemsextractorlog", "[SubproblemsExtractor] ");
 
 SubproblemsExtractor::SubproblemsExtractor() :
-	_subproblems(new Subproblems()) {
+	_subproblems(new Subproblems()),
+	_useProgramOptions(true),
+	_subproblemsSize(0),
+	_subproblemsOverlap(0) {
 
 	registerInput(_objective, "objective");
 	registerInput(_constraints, "linear constraints");
@@ -24,6 +32,14 @@ SubproblemsExtractor::SubproblemsExtractor() :
 	registerOutput(_subproblems, "subproblems");
 }
 
+void
+SubproblemsExtractor::setSubproblemsSize(unsigned int size, unsigned int overlap) {
+
+	_useProgramOptions  = false;
+	_subproblemsSize    = size;
+	_subproblemsOverlap = overlap;
+}
+
 void
 SubproblemsExtractor::updateOutputs() {
 
@@ -95,8 +111,10 @@ SubproblemsExtractor::updateOutputs() {
 
 	// compute the sizes of the subproblems
 
-	unsigned int subproblemsSize    = optionSubproblemsSize;
-	unsigned int subproblemsOverlap = optionSubproblemsOverlap;
+	unsigned int subproblemsSize;
+	unsigned int subproblemsOverlap;
+	getSubproblemsSize(subproblemsSize, subproblemsOverlap);
+
 	unsigned int minInterSectionInterval = _configuration->getMinInterSectionInterval();
 	unsigned int maxInterSectionInterval = _configuration->getMaxInterSectionInterval();
 
@@ -117,70 +135,255 @@ SubproblemsExtractor::updateOutputs() {
 			<< subproblemsOverlap << std::endl;
 
 	// 1D decomposition of the working problem
-	unsigned int subproblemId = 0;
-	for (unsigned int startSubproblem = minInterSectionInterval; startSubproblem < maxInterSectionInterval; startSubproblem += subproblemsSize - subproblemsOverlap) {
+	createSubproblemStarts(subproblemsSize, subproblemsOverlap);
+
+	// Subproblem i contains the inter-section intervals [start_i, start_i + 
+	// subproblemsSize). Since the starts are increasing, the subproblems that 
+	// contain a range of inter-section intervals are consecutive, and can be 
+	// found with two binary searches. Instead of collecting the variables and 
+	// constraints for each subproblem, we route each variable and constraint 
+	// directly to its subproblems.
+
+	// get the inter-section interval of each working problem variable
+	std::vector<unsigned int> workingVarIds = _configuration->getVariables(minInterSectionInterval, maxInterSectionInterval + 1);
 
-		// the first inter-section interval that is not part of the subproblem
-		unsigned int endSubproblem = startSubproblem + subproblemsSize;
+	const unsigned int NoInterval = std::numeric_limits<unsigned int>::max();
 
-		LOG_DEBUG(subproblemsextractorlog) << "creating subproblem " << subproblemId << " for inter-section intervals " << startSubproblem << "-" << (endSubproblem-1) << std::endl;
+	unsigned int numVariables = (workingVarIds.empty() ? 0 : *std::max_element(workingVarIds.begin(), workingVarIds.end()) + 1);
+	std::vector<unsigned int> interSectionIntervals(numVariables, NoInterval);
 
-		// get all working problem variable ids for this subproblem
-		std::vector<unsigned int> workingVarIds = _configuration->getVariables(startSubproblem, endSubproblem);
+	// remember mapping of working variable ids to subproblems (needed for unary 
+	// terms)
+	for (unsigned int workingVarId : workingVarIds) {
 
-		LOG_DEBUG(subproblemsextractorlog) << "this subproblem contains " << workingVarIds.size() << " variables" << std::endl;
+		unsigned int interSectionInterval = _configuration->getInterSectionInterval(workingVarId);
+		interSectionIntervals[workingVarId] = interSectionInterval;
 
-		// remember mapping of subproblem variable ids to this subproblem 
-		// (needed for unary terms)
-		for (unsigned int workingVarId : workingVarIds) {
+		std::pair<unsigned int, unsigned int> subproblems = getSubproblems(interSectionInterval, interSectionInterval, subproblemsSize);
+
+		for (unsigned int subproblemId = subproblems.first; subproblemId < subproblems.second; subproblemId++) {
 
 			LOG_ALL(subproblemsextractorlog) << "assigning variable " << workingVarId << " to subproblem " << subproblemId << std::endl;
 			_subproblems->assignVariable(workingVarId, subproblemId);
 		}
+	}
 
-		// find all working problem constraints that involve the subproblem 
-		// variable ids
-		std::vector<unsigned int> constraints = _constraints->getConstraints(workingVarIds);
-
-		// remember mapping of constraints to this subproblem
-		for (unsigned int i : constraints) {
+	// remember mapping of constraints to subproblems
+	for (unsigned int i = 0; i < _constraints->size(); i++) {
 
-			LinearConstraint& constraint = (*_constraints)[i];
+		LinearConstraint& constraint = (*_constraints)[i];
 
-			// There are two types of constraints: [expr]≤1 and [expr]=0.  The 
-			// first is defined within one inter-section interval and ensures 
-			// that at most one of conflicting segments is picked.  The second 
-			// is defined between two inter-section intervals and
-			// ensures continuation.
-			//
-			// Always accept the first type. Accept the second type only if 
-			// it is fully contained in our problems variables. To simplify 
-			// things (and be more general), accept constraints only if they
-			// are fully contained in our variables.
+		// There are two types of constraints: [expr]≤1 and [expr]=0.  The first 
+		// is defined within one inter-section interval and ensures that at most 
+		// one of conflicting segments is picked.  The second is defined between 
+		// two inter-section intervals and ensures continuation.
+		//
+		// Always accept the first type. Accept the second type only if it is 
+		// fully contained in a subproblem. To simplify things (and be more 
+		// general), accept constraints only if all their variables are 
+		// contained in the subproblem, i.e., if the subproblem contains the 
+		// range of inter-section intervals spanned by the constraint.
 
-			// Working variable ids have already been assigned to subproblem 
-			// ids. We can thus just ask for that.
-			bool addConstraint = true;
-			for (const auto& pair : constraint.getCoefficients()) {
+		unsigned int minConstraintInterval = NoInterval;
+		unsigned int maxConstraintInterval = 0;
 
-				// get all subproblems that are assigned to the working variable
-				std::set<unsigned int>& assignedSubproblems = _subproblems->getVariableSubproblems(pair.first);
+		bool known = true;
+		for (const auto& pair : constraint.getCoefficients()) {
 
-				// does it containt the current subproblem?
-				if (!assignedSubproblems.count(subproblemId)) {
+			// variables without inter-section interval are not part of any 
+			// subproblem
+			if (pair.first >= numVariables || interSectionIntervals[pair.first] == NoInterval) {
 
-					addConstraint = false;
-					break;
-				}
+				known = false;
+				break;
 			}
 
-			if (addConstraint) {
+			minConstraintInterval = std::min(minConstraintInterval, interSectionIntervals[pair.first]);
+			maxConstraintInterval = std::max(maxConstraintInterval, interSectionIntervals[pair.first]);
+		}
+
+		if (!known || minConstraintInterval == NoInterval)
+			continue;
+
+		std::pair<unsigned int, unsigned int> subproblems = getSubproblems(minConstraintInterval, maxConstraintInterval, subproblemsSize);
+
+		for (unsigned int subproblemId = subproblems.first; subproblemId < subproblems.second; subproblemId++) {
+
+			LOG_ALL(subproblemsextractorlog) << "assigning constraint " << i << " to subproblem " << subproblemId << std::endl;
+			_subproblems->assignConstraint(i, subproblemId);
+		}
+	}
+
+	LOG_DEBUG(subproblemsextractorlog)
+			<< "assigned " << workingVarIds.size() << " variables and "
+			<< _constraints->size() << " constraints to "
+			<< _subproblemStarts.size() << " subproblems" << std::endl;
+}
+
+void
+SubproblemsExtractor::writeSubproblems(SubproblemsWriter& writer) {
+
+	updateInputs();
+
+	unsigned int subproblemsSize;
+	unsigned int subproblemsOverlap;
+	getSubproblemsSize(subproblemsSize, subproblemsOverlap);
+
+	unsigned int minInterSectionInterval = _configuration->getMinInterSectionInterval();
+	unsigned int maxInterSectionInterval = _configuration->getMaxInterSectionInterval();
+
+	Problem problem;
+	problem.setObjective(_objective);
+	problem.setLinearConstraints(_constraints);
+	problem.setConfiguration(_configuration);
+
+	createSubproblemStarts(subproblemsSize, subproblemsOverlap);
+
+	// Instead of routing the variables and constraints to their subproblems, 
+	// sort them by inter-section interval: The variables of a subproblem and 
+	// the constraints that start in it are then consecutive, and only the 
+	// lists of the current subproblem have to be kept.
+
+	std::vector<unsigned int> workingVarIds = _configuration->getVariables(minInterSectionInterval, maxInterSectionInterval + 1);
+
+	const unsigned int NoInterval = std::numeric_limits<unsigned int>::max();
+
+	unsigned int numVariables = (workingVarIds.empty() ? 0 : *std::max_element(workingVarIds.begin(), workingVarIds.end()) + 1);
+	std::vector<unsigned int> interSectionIntervals(numVariables, NoInterval);
+
+	// (inter-section interval, variable)
+	std::vector<std::pair<unsigned int, unsigned int> > variables;
+	variables.reserve(workingVarIds.size());
+
+	for (unsigned int workingVarId : workingVarIds) {
+
+		interSectionIntervals[workingVarId] = _configuration->getInterSectionInterval(workingVarId);
+		variables.push_back(std::make_pair(interSectionIntervals[workingVarId], workingVarId));
+	}
+
+	std::sort(variables.begin(), variables.end());
+
+	// (first inter-section interval, last inter-section interval, constraint)
+	std::vector<std::tuple<unsigned int, unsigned int, unsigned int> > constraints;
 
-				LOG_ALL(subproblemsextractorlog) << "assigning constraint " << i << " to subproblem " << subproblemId << std::endl;
-				_subproblems->assignConstraint(i, subproblemId);
+	for (unsigned int i = 0; i < _constraints->size(); i++) {
+
+		unsigned int minConstraintInterval = NoInterval;
+		unsigned int maxConstraintInterval = 0;
+
+		bool known = true;
+		for (const auto& pair : (*_constraints)[i].getCoefficients()) {
+
+			if (pair.first >= numVariables || interSectionIntervals[pair.first] == NoInterval) {
+
+				known = false;
+				break;
 			}
+
+			minConstraintInterval = std::min(minConstraintInterval, interSectionIntervals[pair.first]);
+			maxConstraintInterval = std::max(maxConstraintInterval, interSectionIntervals[pair.first]);
 		}
 
-		subproblemId++;
+		if (!known || minConstraintInterval == NoInterval)
+			continue;
+
+		constraints.push_back(std::make_tuple(minConstraintInterval, maxConstraintInterval, i));
+	}
+
+	std::sort(constraints.begin(), constraints.end());
+
+	std::vector<unsigned int> subproblemVariables;
+	std::vector<unsigned int> subproblemConstraints;
+
+	writer.open();
+
+	for (unsigned int subproblem = 0; subproblem < _subproblemStarts.size(); subproblem++) {
+
+		// the subproblem contains the inter-section intervals [begin, end)
+		unsigned int begin = _subproblemStarts[subproblem];
+		unsigned int end   = begin + subproblemsSize;
+
+		subproblemVariables.clear();
+		subproblemConstraints.clear();
+
+		for (auto i = std::lower_bound(variables.begin(), variables.end(), std::make_pair(begin, 0u));
+		     i != variables.end() && i->first < end;
+		     ++i)
+			subproblemVariables.push_back(i->second);
+
+		// accept constraints only if all their variables are contained in the 
+		// subproblem
+		for (auto i = std::lower_bound(constraints.begin(), constraints.end(), std::make_tuple(begin, 0u, 0u));
+		     i != constraints.end() && std::get<0>(*i) < end;
+		     ++i)
+			if (std::get<1>(*i) < end)
+				subproblemConstraints.push_back(std::get<2>(*i));
+
+		std::sort(subproblemVariables.begin(), subproblemVariables.end());
+		std::sort(subproblemConstraints.begin(), subproblemConstraints.end());
+
+		writer.writeSubproblem(problem, subproblem, subproblemVariables, subproblemConstraints);
 	}
+
+	writer.close();
+
+	LOG_DEBUG(subproblemsextractorlog)
+			<< "wrote " << _subproblemStarts.size() << " subproblems of "
+			<< variables.size() << " variables and " << constraints.size()
+			<< " constraints" << std::endl;
+}
+
+void
+SubproblemsExtractor::getSubproblemsSize(unsigned int& size, unsigned int& overlap) {
+
+	size    = _subproblemsSize;
+	overlap = _subproblemsOverlap;
+
+	if (_useProgramOptions) {
+
+		size    = optionSubproblemsSize;
+		overlap = optionSubproblemsOverlap;
+	}
+}
+
+void
+SubproblemsExtractor::createSubproblemStarts(unsigned int size, unsigned int overlap) {
+
+	unsigned int minInterSectionInterval = _configuration->getMinInterSectionInterval();
+	unsigned int maxInterSectionInterval = _configuration->getMaxInterSectionInterval();
+
+	_subproblemStarts.clear();
+	for (unsigned int startSubproblem = minInterSectionInterval; startSubproblem < maxInterSectionInterval; startSubproblem += size - overlap) {
+
+		LOG_DEBUG(subproblemsextractorlog) << "creating subproblem " << _subproblemStarts.size() << " for inter-section intervals " << startSubproblem << "-" << (startSubproblem + size - 1) << std::endl;
+
+		_subproblemStarts.push_back(startSubproblem);
+	}
+}
+
+std::pair<unsigned int, unsigned int>
+SubproblemsExtractor::getSubproblems(
+		unsigned int minInterSectionInterval,
+		unsigned int maxInterSectionInterval,
+		unsigned int subproblemsSize) {
+
+	// the subproblems that start at or before minInterSectionInterval
+	unsigned int end =
+			std::upper_bound(
+					_subproblemStarts.begin(),
+					_subproblemStarts.end(),
+					minInterSectionInterval)
+			- _subproblemStarts.begin();
+
+	// the first subproblem that ends after maxInterSectionInterval
+	unsigned int begin = 0;
+	if (maxInterSectionInterval >= subproblemsSize)
+		begin =
+				std::upper_bound(
+						_subproblemStarts.begin(),
+						_subproblemStarts.end(),
+						maxInterSectionInterval - subproblemsSize)
+				- _subproblemStarts.begin();
+
+	return std::make_pair(begin, std::max(begin, end));
 }
@@ -7,21 +7,62 @@
 #include "ProblemConfiguration.h"
 #include "Subproblems.h"
 
+class SubproblemsWriter;
+
 class SubproblemsExtractor : public pipeline::SimpleProcessNode<> {
 
 public:
 
 	SubproblemsExtractor();
 
+	/**
+	 * Set the size of the subproblems and the overlap between neighboring 
+	 * subproblems in sections. If not set, the program options 
+	 * subproblemsSize and subproblemsOverlap are used.
+	 */
+	void setSubproblemsSize(unsigned int size, unsigned int overlap);
+
+	/**
+	 * Decompose the working problem and stream the subproblems to the given 
+	 * writer, one subproblem at a time, without creating the output 
+	 * "subproblems". The file contains the same subproblems as writing the 
+	 * output "subproblems".
+	 */
+	void writeSubproblems(SubproblemsWriter& writer);
+
 private:
 
 	void updateOutputs();
 
+	// get the subproblem size and overlap from the program options or the 
+	// values set with setSubproblemsSize()
+	void getSubproblemsSize(unsigned int& size, unsigned int& overlap);
+
+	// compute the first inter-section interval of each subproblem
+	void createSubproblemStarts(unsigned int size, unsigned int overlap);
+
+	/**
+	 * Get the range [first, second) of subproblems that contain all the 
+	 * inter-section intervals between (including) minInterSectionInterval and 
+	 * maxInterSectionInterval.
+	 */
+	std::pair<unsigned int, unsigned int> getSubproblems(
+			unsigned int minInterSectionInterval,
+			unsigned int maxInterSectionInterval,
+			unsigned int subproblemsSize);
+
 	pipeline::Input<LinearObjective>      _objective;
 	pipeline::Input<LinearConstraints>    _constraints;
 	pipeline::Input<ProblemConfiguration> _configuration;
 
 	pipeline::Output<Subproblems> _subproblems;
+
+	bool         _useProgramOptions;
+	unsigned int _subproblemsSize;
+	unsigned int _subproblemsOverlap;
+
+	// the first inter-section interval of each subproblem, in increasing order
+	std::vector<unsigned int> _subproblemStarts;
 };
 
 #endif // SOPNET_INFERENCE_SUBPROBLEMS_EXTRACTOR_H__
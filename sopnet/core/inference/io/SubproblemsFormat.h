@@ -0,0 +1,146 @@
+#ifndef SOPNET_INFERENCE_IO_SUBPROBLEMS_FORMAT_H__
+#define SOPNET_INFERENCE_IO_SUBPROBLEMS_FORMAT_H__
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include <util/exceptions.h>
+
+/**
+ * Helpers for the binary subproblems format, written by SubproblemsWriter and
+ * read by SubproblemsReader. All integers are LEB128 varints, all floating
+ * point numbers are little-endian IEEE 754 in the precision given in the
+ * header.
+ *
+ *   header:      "SOPSUBPR", version (byte), flags (byte)
+ *   chunk*:      ChunkSubproblem (byte), subproblem id,
+ *                number of variables, number of constraints,
+ *                variables:   variable id delta, segment id, cost
+ *                constraints: constraint id delta, relation (byte), value,
+ *                             number of coefficients,
+ *                             coefficients: variable id delta, coefficient
+ *   end:         ChunkEnd (byte)
+ *
+ * Variable and constraint ids are sorted within each chunk and stored as the
+ * difference to their predecessor.
+ */
+struct SubproblemsFormat {
+
+	static const char*   Magic() { return "SOPSUBPR"; }
+	static const uint8_t Version = 1;
+
+	// flags
+	static const uint8_t SinglePrecision = 0x01;
+
+	// chunk tags
+	static const uint8_t ChunkEnd        = 0x00;
+	static const uint8_t ChunkSubproblem = 0x01;
+
+	// relation tags
+	static const uint8_t RelationLessEqual    = 0;
+	static const uint8_t RelationGreaterEqual = 1;
+	static const uint8_t RelationEqual        = 2;
+
+	static void writeByte(std::ostream& out, uint8_t byte) {
+
+		out.put(static_cast<char>(byte));
+	}
+
+	static uint8_t readByte(std::istream& in) {
+
+		int byte = in.get();
+
+		if (byte == std::char_traits<char>::eof())
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					"unexpected end of subproblems stream");
+
+		return static_cast<uint8_t>(byte);
+	}
+
+	static void writeVarint(std::ostream& out, uint64_t value) {
+
+		while (value >= 0x80) {
+
+			writeByte(out, static_cast<uint8_t>(value) | 0x80);
+			value >>= 7;
+		}
+
+		writeByte(out, static_cast<uint8_t>(value));
+	}
+
+	static uint64_t readVarint(std::istream& in) {
+
+		uint64_t value = 0;
+
+		for (unsigned int shift = 0; shift < 64; shift += 7) {
+
+			uint8_t byte = readByte(in);
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+			if (!(byte & 0x80))
+				return value;
+		}
+
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"malformed varint in subproblems stream");
+	}
+
+	static void writeReal(std::ostream& out, double value, bool singlePrecision) {
+
+		if (singlePrecision) {
+
+			float    f = static_cast<float>(value);
+			uint32_t bits;
+			std::memcpy(&bits, &f, sizeof(bits));
+			writeLittleEndian(out, bits, 4);
+
+		} else {
+
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			writeLittleEndian(out, bits, 8);
+		}
+	}
+
+	static double readReal(std::istream& in, bool singlePrecision) {
+
+		if (singlePrecision) {
+
+			uint32_t bits = static_cast<uint32_t>(readLittleEndian(in, 4));
+			float    f;
+			std::memcpy(&f, &bits, sizeof(f));
+			return f;
+
+		} else {
+
+			uint64_t bits = readLittleEndian(in, 8);
+			double   d;
+			std::memcpy(&d, &bits, sizeof(d));
+			return d;
+		}
+	}
+
+private:
+
+	static void writeLittleEndian(std::ostream& out, uint64_t bits, unsigned int numBytes) {
+
+		for (unsigned int i = 0; i < numBytes; i++)
+			writeByte(out, static_cast<uint8_t>(bits >> (8*i)));
+	}
+
+	static uint64_t readLittleEndian(std::istream& in, unsigned int numBytes) {
+
+		uint64_t bits = 0;
+		for (unsigned int i = 0; i < numBytes; i++)
+			bits |= static_cast<uint64_t>(readByte(in)) << (8*i);
+
+		return bits;
+	}
+};
+
+#endif // SOPNET_INFERENCE_IO_SUBPROBLEMS_FORMAT_H__
+
@@ -0,0 +1,153 @@
+#include <util/Logger.h>
+#include "SubproblemsFormat.h"
+#include "SubproblemsReader.h"
+
+logger::LogChannel subproblemsreaderlog("subproblemsreaderlog", "[SubproblemsReader] ");
+
+SubproblemsReader::SubproblemsReader(const std::string& filename) :
+	_subproblems(new Subproblems()),
+	_filename(filename) {
+
+	registerOutput(_subproblems, "subproblems");
+}
+
+void
+SubproblemsReader::updateOutputs() {
+
+	LOG_DEBUG(subproblemsreaderlog) << "reading subproblems from " << _filename << std::endl;
+
+	std::ifstream in(_filename.c_str(), std::ios::binary);
+
+	if (!in)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << _filename << " for reading");
+
+	char magic[8];
+	in.read(magic, 8);
+
+	if (!in || std::string(magic, 8) != SubproblemsFormat::Magic())
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				_filename << " is not a subproblems file");
+
+	uint8_t version = SubproblemsFormat::readByte(in);
+
+	if (version != SubproblemsFormat::Version)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				_filename << " has unsupported version " << (int)version);
+
+	bool singlePrecision = (SubproblemsFormat::readByte(in) & SubproblemsFormat::SinglePrecision);
+
+	_subproblems->clear();
+
+	std::map<unsigned int, double>           costs;
+	std::map<unsigned int, LinearConstraint> constraints;
+
+	boost::shared_ptr<ProblemConfiguration> configuration = boost::make_shared<ProblemConfiguration>();
+
+	unsigned int numSubproblems = 0;
+	while (true) {
+
+		uint8_t chunk = SubproblemsFormat::readByte(in);
+
+		if (chunk == SubproblemsFormat::ChunkEnd)
+			break;
+
+		if (chunk != SubproblemsFormat::ChunkSubproblem)
+			UTIL_THROW_EXCEPTION(
+					IOError,
+					_filename << " contains unknown chunk " << (int)chunk);
+
+		readSubproblem(in, singlePrecision, costs, constraints, *configuration);
+		numSubproblems++;
+	}
+
+	// assemble the working problem
+
+	unsigned int numVariables   = (costs.empty() ? 0 : costs.rbegin()->first + 1);
+	unsigned int numConstraints = (constraints.empty() ? 0 : constraints.rbegin()->first + 1);
+
+	boost::shared_ptr<LinearObjective> objective = boost::make_shared<LinearObjective>(numVariables);
+	for (const auto& pair : costs)
+		objective->setCoefficient(pair.first, pair.second);
+
+	boost::shared_ptr<LinearConstraints> linearConstraints = boost::make_shared<LinearConstraints>();
+	for (unsigned int id = 0; id < numConstraints; id++) {
+
+		if (constraints.count(id))
+			linearConstraints->add(constraints[id]);
+		else
+			linearConstraints->add(LinearConstraint());
+	}
+
+	boost::shared_ptr<Problem> problem = boost::make_shared<Problem>();
+	problem->setObjective(objective);
+	problem->setLinearConstraints(linearConstraints);
+	problem->setConfiguration(configuration);
+
+	_subproblems->setProblem(problem);
+
+	LOG_DEBUG(subproblemsreaderlog)
+			<< "read " << numSubproblems << " subproblems with "
+			<< numVariables << " variables and " << numConstraints
+			<< " constraints" << std::endl;
+}
+
+void
+SubproblemsReader::readSubproblem(
+		std::ifstream& in,
+		bool singlePrecision,
+		std::map<unsigned int, double>& costs,
+		std::map<unsigned int, LinearConstraint>& constraints,
+		ProblemConfiguration& configuration) {
+
+	unsigned int subproblem     = SubproblemsFormat::readVarint(in);
+	unsigned int numVariables   = SubproblemsFormat::readVarint(in);
+	unsigned int numConstraints = SubproblemsFormat::readVarint(in);
+
+	unsigned int variable = 0;
+	for (unsigned int i = 0; i < numVariables; i++) {
+
+		variable += SubproblemsFormat::readVarint(in);
+		unsigned int segmentId = SubproblemsFormat::readVarint(in);
+		double       cost      = SubproblemsFormat::readReal(in, singlePrecision);
+
+		costs[variable] = cost;
+		configuration.setVariable(segmentId, variable);
+		_subproblems->assignVariable(variable, subproblem);
+	}
+
+	unsigned int id = 0;
+	for (unsigned int i = 0; i < numConstraints; i++) {
+
+		id += SubproblemsFormat::readVarint(in);
+
+		LinearConstraint constraint;
+
+		uint8_t relation = SubproblemsFormat::readByte(in);
+		if (relation == SubproblemsFormat::RelationLessEqual)
+			constraint.setRelation(LessEqual);
+		else if (relation == SubproblemsFormat::RelationGreaterEqual)
+			constraint.setRelation(GreaterEqual);
+		else
+			constraint.setRelation(Equal);
+
+		constraint.setValue(SubproblemsFormat::readReal(in, singlePrecision));
+
+		unsigned int numCoefficients = SubproblemsFormat::readVarint(in);
+		unsigned int coefficientVariable = 0;
+		for (unsigned int j = 0; j < numCoefficients; j++) {
+
+			coefficientVariable += SubproblemsFormat::readVarint(in);
+			constraint.setCoefficient(coefficientVariable, SubproblemsFormat::readReal(in, singlePrecision));
+		}
+
+		// constraints shared between subproblems are stored with each of them
+		if (!constraints.count(id))
+			constraints[id] = constraint;
+
+		_subproblems->assignConstraint(id, subproblem);
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef SOPNET_INFERENCE_IO_SUBPROBLEMS_READER_H__
+#define SOPNET_INFERENCE_IO_SUBPROBLEMS_READER_H__
+
+#include <fstream>
+#include <string>
+
+#include <pipeline/all.h>
+#include <inference/Subproblems.h>
+
+/**
+ * Reads subproblems written by SubproblemsWriter. The chunks are read one at a 
+ * time and merged into the working problem and the assignments of variables 
+ * and constraints to subproblems. Constraints that were not part of any 
+ * subproblem are not stored in the file, their slots in the working problem 
+ * are filled with empty constraints.
+ */
+class SubproblemsReader : public pipeline::SimpleProcessNode<> {
+
+public:
+
+	SubproblemsReader(const std::string& filename);
+
+private:
+
+	void updateOutputs();
+
+	// read one subproblem chunk
+	void readSubproblem(
+			std::ifstream& in,
+			bool singlePrecision,
+			std::map<unsigned int, double>& costs,
+			std::map<unsigned int, LinearConstraint>& constraints,
+			ProblemConfiguration& configuration);
+
+	pipeline::Output<Subproblems> _subproblems;
+
+	std::string _filename;
+};
+
+#endif // SOPNET_INFERENCE_IO_SUBPROBLEMS_READER_H__
+
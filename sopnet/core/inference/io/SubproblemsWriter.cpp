@@ -0,0 +1,159 @@
+#include <algorithm>
+
+#include <util/Logger.h>
+#include "SubproblemsFormat.h"
+#include "SubproblemsWriter.h"
+
+logger::LogChannel subproblemswriterlog("subproblemswriterlog", "[SubproblemsWriter] ");
+
+SubproblemsWriter::SubproblemsWriter(const std::string& filename, bool singlePrecision) :
+	_filename(filename),
+	_singlePrecision(singlePrecision),
+	_numSubproblems(0) {
+
+	registerInput(_subproblems, "subproblems");
+}
+
+void
+SubproblemsWriter::write() {
+
+	updateInputs();
+
+	open();
+
+	// Collect the ids of the variables and constraints of each subproblem. 
+	// Since the assignments are ordered by id, so are the lists. This needs 
+	// the whole decomposition in memory, use 
+	// SubproblemsExtractor::writeSubproblems() to stream it instead.
+
+	std::vector<std::vector<unsigned int> > variables;
+	std::vector<std::vector<unsigned int> > constraints;
+
+	for (const auto& pair : _subproblems->getVariablesSubproblems())
+		for (unsigned int subproblem : pair.second) {
+
+			if (subproblem >= variables.size())
+				variables.resize(subproblem + 1);
+			variables[subproblem].push_back(pair.first);
+		}
+
+	for (const auto& pair : _subproblems->getConstraintsSubproblems())
+		for (unsigned int subproblem : pair.second) {
+
+			if (subproblem >= constraints.size())
+				constraints.resize(subproblem + 1);
+			constraints[subproblem].push_back(pair.first);
+		}
+
+	unsigned int numSubproblems = std::max(variables.size(), constraints.size());
+	variables.resize(numSubproblems);
+	constraints.resize(numSubproblems);
+
+	for (unsigned int subproblem = 0; subproblem < numSubproblems; subproblem++) {
+
+		writeSubproblem(*_subproblems->getProblem(), subproblem, variables[subproblem], constraints[subproblem]);
+
+		// the chunk is written, we don't need the lists anymore
+		std::vector<unsigned int>().swap(variables[subproblem]);
+		std::vector<unsigned int>().swap(constraints[subproblem]);
+	}
+
+	close();
+}
+
+void
+SubproblemsWriter::open() {
+
+	LOG_DEBUG(subproblemswriterlog) << "writing subproblems to " << _filename << std::endl;
+
+	_out.open(_filename.c_str(), std::ios::binary | std::ios::trunc);
+
+	if (!_out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"can not open " << _filename << " for writing");
+
+	_out.write(SubproblemsFormat::Magic(), 8);
+	SubproblemsFormat::writeByte(_out, SubproblemsFormat::Version);
+	SubproblemsFormat::writeByte(_out, _singlePrecision ? SubproblemsFormat::SinglePrecision : 0);
+
+	_numSubproblems = 0;
+}
+
+void
+SubproblemsWriter::close() {
+
+	SubproblemsFormat::writeByte(_out, SubproblemsFormat::ChunkEnd);
+
+	if (!_out)
+		UTIL_THROW_EXCEPTION(
+				IOError,
+				"failed to write subproblems to " << _filename);
+
+	_out.close();
+
+	LOG_DEBUG(subproblemswriterlog) << "wrote " << _numSubproblems << " subproblems" << std::endl;
+}
+
+void
+SubproblemsWriter::writeSubproblem(
+		Problem&                         problem,
+		unsigned int                     subproblem,
+		const std::vector<unsigned int>& variables,
+		const std::vector<unsigned int>& constraints) {
+
+	if (!_out.is_open())
+		UTIL_THROW_EXCEPTION(
+				UsageError,
+				"open() has to be called before writing subproblems");
+
+	boost::shared_ptr<LinearObjective>      objective         = problem.getObjective();
+	boost::shared_ptr<LinearConstraints>    linearConstraints = problem.getLinearConstraints();
+	boost::shared_ptr<ProblemConfiguration> configuration     = problem.getConfiguration();
+
+	SubproblemsFormat::writeByte(_out, SubproblemsFormat::ChunkSubproblem);
+	SubproblemsFormat::writeVarint(_out, subproblem);
+	SubproblemsFormat::writeVarint(_out, variables.size());
+	SubproblemsFormat::writeVarint(_out, constraints.size());
+
+	unsigned int previous = 0;
+	for (unsigned int variable : variables) {
+
+		SubproblemsFormat::writeVarint(_out, variable - previous);
+		SubproblemsFormat::writeVarint(_out, configuration->getSegmentId(variable));
+		SubproblemsFormat::writeReal(_out, objective->getCoefficients()[variable], _singlePrecision);
+
+		previous = variable;
+	}
+
+	previous = 0;
+	for (unsigned int id : constraints) {
+
+		const LinearConstraint& constraint = (*linearConstraints)[id];
+
+		SubproblemsFormat::writeVarint(_out, id - previous);
+
+		if (constraint.getRelation() == LessEqual)
+			SubproblemsFormat::writeByte(_out, SubproblemsFormat::RelationLessEqual);
+		else if (constraint.getRelation() == GreaterEqual)
+			SubproblemsFormat::writeByte(_out, SubproblemsFormat::RelationGreaterEqual);
+		else
+			SubproblemsFormat::writeByte(_out, SubproblemsFormat::RelationEqual);
+
+		SubproblemsFormat::writeReal(_out, constraint.getValue(), _singlePrecision);
+		SubproblemsFormat::writeVarint(_out, constraint.getCoefficients().size());
+
+		unsigned int previousVariable = 0;
+		for (const auto& pair : constraint.getCoefficients()) {
+
+			SubproblemsFormat::writeVarint(_out, pair.first - previousVariable);
+			SubproblemsFormat::writeReal(_out, pair.second, _singlePrecision);
+
+			previousVariable = pair.first;
+		}
+
+		previous = id;
+	}
+
+	_numSubproblems++;
+}
@@ -0,0 +1,82 @@
+#ifndef SOPNET_INFERENCE_IO_SUBPROBLEMS_WRITER_H__
+#define SOPNET_INFERENCE_IO_SUBPROBLEMS_WRITER_H__
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <pipeline/all.h>
+#include <inference/Subproblems.h>
+
+/**
+ * A sink process node that writes subproblems in the binary format described
+ * in SubproblemsFormat.h. Each subproblem is written as a chunk with its
+ * variables (with segment ids and costs) and constraints, one subproblem at a
+ * time.
+ *
+ * The chunks can either be written from the input "subproblems" with write(),
+ * or streamed with open(), writeSubproblem(), and close(), such that the
+ * decomposition never has to be held in memory (see
+ * SubproblemsExtractor::writeSubproblems()).
+ */
+class SubproblemsWriter : public pipeline::SimpleProcessNode<> {
+
+public:
+
+	/**
+	 * Create a writer for the given file. If singlePrecision is set, costs and
+	 * coefficients are stored as 32 bit floats.
+	 */
+	SubproblemsWriter(const std::string& filename, bool singlePrecision = false);
+
+	/**
+	 * Write all subproblems of the input "subproblems".
+	 */
+	void write();
+
+	/**
+	 * Create the file and write the header.
+	 */
+	void open();
+
+	/**
+	 * Write the chunk of one subproblem.
+	 *
+	 * @param problem
+	 *              The working problem that is decomposed.
+	 * @param subproblem
+	 *              The id of the subproblem.
+	 * @param variables
+	 *              The working problem variables of the subproblem, sorted.
+	 * @param constraints
+	 *              The working problem constraints of the subproblem, sorted.
+	 */
+	void writeSubproblem(
+			Problem&                         problem,
+			unsigned int                     subproblem,
+			const std::vector<unsigned int>& variables,
+			const std::vector<unsigned int>& constraints);
+
+	/**
+	 * Terminate the file and close it.
+	 */
+	void close();
+
+private:
+
+	// we produce nothing
+	void updateOutputs() {}
+
+	pipeline::Input<Subproblems> _subproblems;
+
+	std::string _filename;
+
+	bool _singlePrecision;
+
+	std::ofstream _out;
+
+	unsigned int _numSubproblems;
+};
+
+#endif // SOPNET_INFERENCE_IO_SUBPROBLEMS_WRITER_H__
+
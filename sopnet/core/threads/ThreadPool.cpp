@@ -0,0 +1,121 @@
+#include <algorithm>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int numThreads) :
+	_pending(0),
+	_shutdown(false) {
+
+	numThreads = resolveNumThreads(numThreads);
+
+	_threads.reserve(numThreads);
+	for (unsigned int i = 0; i < numThreads; i++)
+		_threads.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool() {
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_allDone.wait(lock, [this]{ return _pending == 0; });
+		_shutdown = true;
+	}
+
+	_taskAvailable.notify_all();
+
+	for (std::thread& thread : _threads)
+		thread.join();
+}
+
+void
+ThreadPool::schedule(const task_type& task) {
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.push_back(task);
+		_pending++;
+	}
+
+	_taskAvailable.notify_one();
+}
+
+void
+ThreadPool::scheduleRange(unsigned int size, const std::function<void(unsigned int, unsigned int)>& f) {
+
+	if (size == 0)
+		return;
+
+	unsigned int numChunks = std::min(size, 4*std::max(1u, this->size()));
+	unsigned int chunkSize = (size + numChunks - 1)/numChunks;
+
+	for (unsigned int begin = 0; begin < size; begin += chunkSize) {
+
+		unsigned int end = std::min(size, begin + chunkSize);
+		schedule([f, begin, end]{ f(begin, end); });
+	}
+}
+
+void
+ThreadPool::wait() {
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_allDone.wait(lock, [this]{ return _pending == 0; });
+
+	if (_exception) {
+
+		std::exception_ptr exception = _exception;
+		_exception = std::exception_ptr();
+		std::rethrow_exception(exception);
+	}
+}
+
+unsigned int
+ThreadPool::resolveNumThreads(unsigned int numThreads) {
+
+	if (numThreads > 0)
+		return numThreads;
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void
+ThreadPool::work() {
+
+	while (true) {
+
+		task_type task;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskAvailable.wait(lock, [this]{ return _shutdown || !_tasks.empty(); });
+
+			if (_tasks.empty())
+				return;
+
+			task = _tasks.front();
+			_tasks.pop_front();
+		}
+
+		std::exception_ptr exception;
+
+		try {
+
+			task();
+
+		} catch (...) {
+
+			exception = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (exception && !_exception)
+				_exception = exception;
+
+			_pending--;
+
+			if (_pending == 0)
+				_allDone.notify_all();
+		}
+	}
+}
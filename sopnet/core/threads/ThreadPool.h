@@ -0,0 +1,88 @@
+#ifndef SOPNET_THREADS_THREAD_POOL_H__
+#define SOPNET_THREADS_THREAD_POOL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed-size pool of worker threads executing scheduled tasks in FIFO
+ * order. Tasks are not expected to synchronize with each other; use wait() to
+ * block until all tasks scheduled so far have been processed.
+ */
+class ThreadPool {
+
+public:
+
+	typedef std::function<void()> task_type;
+
+	/**
+	 * Create a new thread pool.
+	 *
+	 * @param numThreads
+	 *              The number of worker threads. If 0, the number of hardware
+	 *              threads is used.
+	 */
+	explicit ThreadPool(unsigned int numThreads = 0);
+
+	/**
+	 * Waits for all pending tasks and joins the worker threads. Exceptions of
+	 * tasks that were not collected by wait() are dropped.
+	 */
+	~ThreadPool();
+
+	/**
+	 * Add a task to the queue.
+	 */
+	void schedule(const task_type& task);
+
+	/**
+	 * Split the range [0, size) into chunks and schedule f(begin, end) for
+	 * each of them. The number of chunks is a small multiple of the number of
+	 * threads, to balance uneven work between the chunks.
+	 */
+	void scheduleRange(unsigned int size, const std::function<void(unsigned int, unsigned int)>& f);
+
+	/**
+	 * Block until all scheduled tasks are finished. If any of the tasks threw
+	 * an exception, the first of them is rethrown here.
+	 */
+	void wait();
+
+	/**
+	 * The number of worker threads in this pool.
+	 */
+	unsigned int size() const { return _threads.size(); }
+
+	/**
+	 * Resolve a requested number of threads, where 0 stands for the number of
+	 * hardware threads.
+	 */
+	static unsigned int resolveNumThreads(unsigned int numThreads);
+
+private:
+
+	void work();
+
+	std::vector<std::thread> _threads;
+
+	std::deque<task_type> _tasks;
+
+	// number of tasks that are scheduled or running
+	unsigned int _pending;
+
+	bool _shutdown;
+
+	std::exception_ptr _exception;
+
+	std::mutex              _mutex;
+	std::condition_variable _taskAvailable;
+	std::condition_variable _allDone;
+};
+
+#endif // SOPNET_THREADS_THREAD_POOL_H__
+